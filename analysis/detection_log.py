@@ -0,0 +1,73 @@
+"""Reader and CSV converter for the Listener's binary detection logs (detectionLogFormat "binary" or "both").
+
+The layout is described in listener_program/src/io/detection_log.h. Records are fixed-width and little-endian,
+so a log maps straight into a NumPy structured array without parsing:
+
+    from detection_log import read_detection_log
+    columns, detections = read_detection_log("logs/231105_090101_000000.bin")
+    detections["tdoa"][:, 0]  # TDOA12 of every detection
+
+Run as a script to convert a log to the equivalent CSV detection file:
+
+    python detection_log.py logs/231105_090101_000000.bin > 231105_090101_000000.csv
+"""
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b"FWDLOG01"
+VERSION = 1
+HEADER_FORMAT = "<8sIIIIII"  # magic, version, headerSize, recordSize, numChannels, numChannelPairs, namesLength
+
+
+def record_dtype(num_channel_pairs, record_size):
+    """Structured dtype of one detection record."""
+    pair_bytes = 4 * num_channel_pairs
+    return np.dtype({
+        "names": ["peak_time_us", "amplitude", "doa", "tdoa", "xcorr", "latency_us"],
+        "formats": ["<i8", "<f4", ("<f4", 3), ("<f4", num_channel_pairs), ("<f4", num_channel_pairs), "<i4"],
+        "offsets": [0, 8, 12, 24, 24 + pair_bytes, 24 + 2 * pair_bytes],
+        "itemsize": record_size,
+    })
+
+
+def read_detection_log(path):
+    """Memory-maps a binary detection log.
+
+    Returns the CSV column names and a read-only structured array with one element per detection. A partly
+    written last record is ignored.
+    """
+    with open(path, "rb") as file:
+        header = file.read(struct.calcsize(HEADER_FORMAT))
+        magic, version, header_size, record_size, _, num_pairs, names_length = struct.unpack(HEADER_FORMAT, header)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError(f"{path} is not a supported detection log")
+        columns = file.read(names_length).decode("ascii").split(",")
+        file.seek(0, 2)
+        num_records = (file.tell() - header_size) // record_size
+
+    if num_records == 0:
+        return columns, np.zeros(0, dtype=record_dtype(num_pairs, record_size))
+    detections = np.memmap(path, dtype=record_dtype(num_pairs, record_size), mode="r", offset=header_size,
+                           shape=(num_records,))
+    return columns, detections
+
+
+def write_csv(path, output):
+    """Writes a binary detection log as the equivalent CSV detection file."""
+    columns, detections = read_detection_log(path)
+    output.write(",".join(columns) + "\n")
+    for detection in detections:
+        fields = [str(detection["peak_time_us"]), f"{detection['amplitude']:f}"]
+        fields += [f"{value:f}" for value in detection["doa"]]
+        fields += [f"{value:f}" for value in detection["tdoa"]]
+        fields += [f"{value:f}" for value in detection["xcorr"]]
+        fields.append(str(detection["latency_us"]))
+        output.write(",".join(fields) + "\n")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit("Usage: python detection_log.py <detection log>")
+    write_csv(sys.argv[1], sys.stdout)
@@ -49,4 +49,16 @@ endif ()
 if (FFTWF_INCLUDE_DIRS)
     list(APPEND THIRD_PARTY_INCLUDE_DIRS ${FFTWF_INCLUDE_DIRS})
     message(STATUS "FFTWf include dirs (cross-compiling): ${FFTWF_INCLUDE_DIRS}")
-endif()
\ No newline at end of file
+endif()
+
+# Find liburing (optional, enables the io_uring socket backend)
+find_library(LIBURING_LIBRARIES NAMES uring PATHS ${CMAKE_SYSROOT}/usr/lib/aarch64-linux-gnu/ NO_DEFAULT_PATH)
+find_path(LIBURING_INCLUDE_DIRS NAMES liburing.h PATHS ${CMAKE_SYSROOT}/usr/include NO_DEFAULT_PATH)
+if (LIBURING_LIBRARIES AND LIBURING_INCLUDE_DIRS)
+    list(APPEND THIRD_PARTY_LIBRARIES ${LIBURING_LIBRARIES})
+    list(APPEND THIRD_PARTY_INCLUDE_DIRS ${LIBURING_INCLUDE_DIRS})
+    add_compile_definitions(HAVE_LIBURING)
+    message(STATUS "liburing libraries (cross-compiling): ${LIBURING_LIBRARIES}")
+else()
+    message(STATUS "liburing not found (cross-compiling): io_uring socket backend disabled")
+endif()
@@ -56,3 +56,14 @@ if (FFTWF_INCLUDE_DIRS)
     message(STATUS "FFTWf include dirs (cross-compiling): ${FFTWF_INCLUDE_DIRS}")
 endif()
 
+# Find liburing (optional, enables the io_uring socket backend)
+find_library(LIBURING_LIBRARIES NAMES uring PATHS ${CMAKE_SYSROOT}/usr/lib/aarch64-linux-gnu/ NO_DEFAULT_PATH)
+find_path(LIBURING_INCLUDE_DIRS NAMES liburing.h PATHS ${CMAKE_SYSROOT}/usr/include NO_DEFAULT_PATH)
+if (LIBURING_LIBRARIES AND LIBURING_INCLUDE_DIRS)
+    list(APPEND THIRD_PARTY_LIBRARIES ${LIBURING_LIBRARIES})
+    list(APPEND THIRD_PARTY_INCLUDE_DIRS ${LIBURING_INCLUDE_DIRS})
+    add_compile_definitions(HAVE_LIBURING)
+    message(STATUS "liburing libraries (static cross-compiling): ${LIBURING_LIBRARIES}")
+else()
+    message(STATUS "liburing not found (static cross-compiling): io_uring socket backend disabled")
+endif()
@@ -76,4 +76,21 @@ message(STATUS "ONNX Runtime Library: ${ONNXRUNTIME_LIBRARIES}")
 message(STATUS "ONNX Runtime Include Directory: ${ONNXRUNTIME_INCLUDE_DIRS}")
 
 list(APPEND THIRD_PARTY_LIBRARIES ${ONNXRUNTIME_LIBRARIES})
-list(APPEND THIRD_PARTY_INCLUDE_DIRS ${ONNXRUNTIME_INCLUDE_DIRS})
\ No newline at end of file
+list(APPEND THIRD_PARTY_INCLUDE_DIRS ${ONNXRUNTIME_INCLUDE_DIRS})
+
+# ===========================
+# Find liburing (optional, enables the io_uring socket backend)
+# ===========================
+find_library(LIBURING_LIBRARIES NAMES uring)
+find_path(LIBURING_INCLUDE_DIRS NAMES liburing.h)
+
+if(LIBURING_LIBRARIES AND LIBURING_INCLUDE_DIRS)
+    message(STATUS "liburing Library: ${LIBURING_LIBRARIES}")
+    message(STATUS "liburing Include Directory: ${LIBURING_INCLUDE_DIRS}")
+
+    list(APPEND THIRD_PARTY_LIBRARIES ${LIBURING_LIBRARIES})
+    list(APPEND THIRD_PARTY_INCLUDE_DIRS ${LIBURING_INCLUDE_DIRS})
+    add_compile_definitions(HAVE_LIBURING)
+else()
+    message(STATUS "liburing not found: io_uring socket backend disabled")
+endif()
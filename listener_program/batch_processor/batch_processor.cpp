@@ -0,0 +1,196 @@
+#include <functional>
+
+#include "../src/batch_processor.h"
+#include "../src/logger.h"
+#include "../src/utils.h"
+
+// Reprocesses archived recordings (.npy sample matrices, as streamed by datalogger_simulator.py) offline with the
+// pipeline settings of a listener config. Recordings are fed straight into the pipeline without sockets or real-time
+// pacing, and independent recordings run in parallel, one per thread.
+
+namespace
+{
+struct BatchOptions
+{
+    std::string configPath;
+    std::vector<std::string> inputs;  ///< Recordings, or directories whose .npy files are all processed.
+    std::string outputDirectory;  ///< Empty to use the config's logDirectory.
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string startTime = "2023-11-05 01:01:01";  ///< The timestamp datalogger_simulator.py starts from.
+};
+
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " <config_files/config.json> <recording.npy|directory>... [options]\n"
+              << "  --threads <count>          Recordings processed at once (default: number of cores)\n"
+              << "  --output <directory>       Output directory (default: the config's logDirectory)\n"
+              << "  --start \"<date> <time>\"    UTC timestamp of each recording's first sample\n"
+              << "                             (default \"2023-11-05 01:01:01\", as the simulator)\n";
+}
+
+/**
+ * @brief Parses the command line into options.
+ * @throws std::invalid_argument On unknown options, missing values or a missing config or recording.
+ */
+BatchOptions parseOptions(int argc, char* argv[])
+{
+    BatchOptions options;
+    const std::map<std::string, std::function<void(const std::string&)>> setters = {
+        {"--threads", [&](const std::string& value) { options.threads = std::stoi(value); }},
+        {"--output", [&](const std::string& value) { options.outputDirectory = value; }},
+        {"--start", [&](const std::string& value) { options.startTime = value; }},
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if (argument.rfind("--", 0) != 0)
+        {
+            (options.configPath.empty() ? options.configPath : options.inputs.emplace_back()) = argument;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument("Missing value for " + argument);
+        }
+        const auto setter = setters.find(argument);
+        if (setter == setters.end())
+        {
+            throw std::invalid_argument("Unknown option " + argument);
+        }
+        setter->second(argv[++i]);
+    }
+
+    if (options.configPath.empty() || options.inputs.empty())
+    {
+        throw std::invalid_argument("A config file and at least one recording or directory are required");
+    }
+    return options;
+}
+
+/**
+ * @brief Parses "YYYY-MM-DD HH:MM:SS" as a UTC time.
+ * @throws std::invalid_argument If the text does not have that form.
+ */
+TimePoint parseStartTime(const std::string& text)
+{
+    std::tm utcTime{};
+    std::istringstream stream(text);
+    stream >> std::get_time(&utcTime, "%Y-%m-%d %H:%M:%S");
+    if (stream.fail())
+    {
+        throw std::invalid_argument("Start time must look like \"2023-11-05 01:01:01\", not \"" + text + "\"");
+    }
+    return std::chrono::system_clock::from_time_t(timegm(&utcTime));
+}
+
+/**
+ * @brief Expands directories into their .npy files, in name order, and keeps files as they are.
+ */
+std::vector<std::string> collectRecordings(const std::vector<std::string>& inputs)
+{
+    std::vector<std::string> recordings;
+    for (const std::string& input : inputs)
+    {
+        if (!std::filesystem::is_directory(input))
+        {
+            recordings.push_back(input);
+            continue;
+        }
+        std::vector<std::string> directoryRecordings;
+        for (const auto& entry : std::filesystem::directory_iterator(input))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".npy")
+            {
+                directoryRecordings.push_back(entry.path().string());
+            }
+        }
+        std::sort(directoryRecordings.begin(), directoryRecordings.end());
+        recordings.insert(recordings.end(), directoryRecordings.begin(), directoryRecordings.end());
+    }
+    return recordings;
+}
+
+/**
+ * @brief Prints each recording's outcome and the overall speed relative to real time.
+ * @return True if every recording was processed to its end.
+ */
+bool printResults(const std::vector<BatchResult>& results, std::chrono::duration<double> elapsed, int microIncrement)
+{
+    uint64_t totalPackets = 0;
+    int totalDetections = 0;
+    bool allSucceeded = true;
+    for (const BatchResult& result : results)
+    {
+        totalPackets += result.packets;
+        totalDetections += result.detections;
+        std::cout << result.recordingPath << ": ";
+        if (!result.error.empty())
+        {
+            allSucceeded = false;
+            std::cout << "FAILED: " << result.error << std::endl;
+            continue;
+        }
+        std::cout << result.detections << " detections in " << result.packets << " packets, " << std::fixed
+                  << std::setprecision(2) << result.elapsed.count() << " s -> " << result.outputDirectory << std::endl;
+    }
+
+    const double recordedSeconds = totalPackets * microIncrement / 1e6;
+    std::cout << results.size() << " recordings, " << totalDetections << " detections, " << std::fixed
+              << std::setprecision(1) << recordedSeconds << " s of data in " << elapsed.count() << " s ("
+              << recordedSeconds / std::max(elapsed.count(), 1e-9) << "x real time)" << std::endl;
+    return allSucceeded;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h"))
+    {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    BatchOptions options;
+    TimePoint startTime;
+    try
+    {
+        options = parseOptions(argc, argv);
+        startTime = parseStartTime(options.startTime);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        // Recordings are processed with the first stream's pipeline settings; socket settings do not apply
+        const PipelineVariables pipelineVariables = std::get<1>(parseStreamConfigs(options.configPath).front());
+        Logger::instance().configure(
+            Logger::parseLevel(pipelineVariables.logLevel),
+            static_cast<uint32_t>(std::max(0, pipelineVariables.logRateLimit)));
+
+        const std::vector<std::string> recordings = collectRecordings(options.inputs);
+        const std::string outputDirectory =
+            options.outputDirectory.empty() ? pipelineVariables.loggingDirectory : options.outputDirectory;
+        std::cout << "Processing " << recordings.size() << " recording(s) on " << options.threads
+                  << " thread(s) into " << outputDirectory << std::endl;
+
+        BatchProcessor batchProcessor(pipelineVariables, outputDirectory, options.threads, startTime);
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<BatchResult> results = batchProcessor.run(recordings);
+        Logger::instance().shutdown();  // the recordings' threads have finished logging
+        const bool allSucceeded =
+            printResults(results, std::chrono::steady_clock::now() - start, Firmware1240().microIncre());
+        return allSucceeded ? 0 : EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        Logger::instance().shutdown();
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
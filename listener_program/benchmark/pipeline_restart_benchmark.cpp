@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include "../src/pipeline.h"
+#include "../src/pipeline_variables.h"
+
+// Measures what a listener restart costs the processing side. The cold restart rebuilds the packet ring, the output
+// manager and the pipeline (filters, FFT plans, hydrophone decomposition, tracker) as main() used to; the warm restart
+// only resets the stream state of objects built once. Run from listener_program/ so the filter and receiver position
+// files resolve.
+
+namespace
+{
+PipelineVariables restartBenchmarkVariables()
+{
+    PipelineVariables pipelineVariables;
+    pipelineVariables.firmware = "1240";
+    pipelineVariables.speedOfSound = 1482.965459f;
+    pipelineVariables.timeDomainDetector = "PeakAmplitude";
+    pipelineVariables.timeDomainThreshold = 1;
+    pipelineVariables.frequencyDomainStrategy = "Filter";
+    pipelineVariables.frequencyDomainDetector = "AverageEnergy";
+    pipelineVariables.energyDetectionThreshold = 100;
+    pipelineVariables.filterWeightsPath = "filters/highpass_taps@101_cutoff@20k_window@hamming_fs@100k.txt";
+    pipelineVariables.receiverPositionsPath = "receiver_pos/SOCAL_H_72_HS_harp4chPar_recPos.txt";
+    pipelineVariables.enableTracking = true;
+    pipelineVariables.clusterFrequencyInSeconds = std::chrono::seconds(60);
+    pipelineVariables.clusterWindowInSeconds = std::chrono::seconds(30);
+    pipelineVariables.loggingDirectory = "deployment_files/";
+    return pipelineVariables;
+}
+
+/**
+ * @brief Skips the benchmark with a hint, instead of failing in the Pipeline constructor, when run from elsewhere.
+ */
+bool inputFilesFound(benchmark::State& state, const PipelineVariables& pipelineVariables)
+{
+    for (const std::string& path : {pipelineVariables.filterWeightsPath, pipelineVariables.receiverPositionsPath})
+    {
+        if (!std::filesystem::exists(path))
+        {
+            state.SkipWithError(("Cannot find " + path + "; run the benchmark from listener_program/").c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+void BM_ColdRestart(benchmark::State& state)
+{
+    const PipelineVariables pipelineVariables = restartBenchmarkVariables();
+    if (!inputFilesFound(state, pipelineVariables))
+    {
+        return;
+    }
+    for (auto _ : state)
+    {
+        SharedPipelineResources sharedResources;
+        SharedDataManager sharedDataManager;
+        OutputManager outputManager(std::chrono::seconds(60), false, pipelineVariables.loggingDirectory);
+        Pipeline pipeline(outputManager, sharedDataManager, pipelineVariables, sharedResources);
+        benchmark::DoNotOptimize(&pipeline);
+    }
+}
+
+void BM_WarmRestart(benchmark::State& state)
+{
+    const PipelineVariables pipelineVariables = restartBenchmarkVariables();
+    if (!inputFilesFound(state, pipelineVariables))
+    {
+        return;
+    }
+    SharedPipelineResources sharedResources;
+    SharedDataManager sharedDataManager;
+    OutputManager outputManager(std::chrono::seconds(60), false, pipelineVariables.loggingDirectory);
+    Pipeline pipeline(outputManager, sharedDataManager, pipelineVariables, sharedResources);
+    for (auto _ : state)
+    {
+        sharedDataManager.reset();
+        pipeline.resetStream();
+        benchmark::DoNotOptimize(&pipeline);
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_ColdRestart)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WarmRestart)->Unit(benchmark::kMicrosecond);
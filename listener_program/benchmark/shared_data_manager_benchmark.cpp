@@ -0,0 +1,159 @@
+#include <benchmark/benchmark.h>
+
+#include "../src/shared_data_manager.h"
+
+// Compares the lock-free SharedDataManager ring against the mutex-guarded ring it replaced. A producer thread
+// receives into batches of slots (as the recvmmsg listener does) while the benchmark thread consumes detection
+// windows, so the measured rate includes all contention between the two threads.
+
+namespace
+{
+constexpr int packetSize = 1252;
+constexpr int windowSize = 8;  // numPacketsToDetect for firmware 1240
+constexpr int packetsPerIteration = 1 << 16;
+
+/**
+ * @brief Reproduction of the previous SharedDataManager: the same slot ring, guarded by one mutex. Commits stamp
+ * each slot with its arrival and enqueue times as SharedDataManager does, so only the synchronisation differs.
+ */
+class MutexPacketRing
+{
+   private:
+    std::mutex dataBufferLock;
+    const int mSlotSize;
+    const int mNumSlots;
+    std::vector<uint8_t> mSlotStorage;
+    std::vector<size_t> mSlotLengths;
+    std::vector<TimePoint> mSlotArrivalTimes;
+    std::vector<std::chrono::steady_clock::time_point> mSlotEnqueueTimes;
+    uint64_t mWriteIndex = 0;
+    uint64_t mReadIndex = 0;
+
+    uint8_t* slotData(uint64_t packetIndex) { return mSlotStorage.data() + (packetIndex % mNumSlots) * mSlotSize; }
+
+   public:
+    explicit MutexPacketRing(int slotSize = 2048, int numSlots = 1024)
+        : mSlotSize(slotSize),
+          mNumSlots(numSlots),
+          mSlotStorage(static_cast<size_t>(slotSize) * numSlots),
+          mSlotLengths(numSlots, 0),
+          mSlotArrivalTimes(numSlots),
+          mSlotEnqueueTimes(numSlots)
+    {
+    }
+
+    int acquireWriteSlots(std::span<std::span<uint8_t>> slots)
+    {
+        std::lock_guard<std::mutex> lock(dataBufferLock);
+        const uint64_t freeSlots = mNumSlots - (mWriteIndex - mReadIndex);
+        const int numSlots = static_cast<int>(std::min<uint64_t>(freeSlots, slots.size()));
+        for (int i = 0; i < numSlots; i++)
+        {
+            slots[i] = std::span<uint8_t>(slotData(mWriteIndex + i), mSlotSize);
+        }
+        return numSlots;
+    }
+
+    int commitWriteSlots(std::span<const size_t> lengths)
+    {
+        const auto enqueueTime = std::chrono::steady_clock::now();
+        const TimePoint commitTime = std::chrono::system_clock::now();
+        std::lock_guard<std::mutex> lock(dataBufferLock);
+        for (size_t i = 0; i < lengths.size(); i++)
+        {
+            mSlotLengths[(mWriteIndex + i) % mNumSlots] = lengths[i];
+            mSlotArrivalTimes[(mWriteIndex + i) % mNumSlots] = commitTime;
+            mSlotEnqueueTimes[(mWriteIndex + i) % mNumSlots] = enqueueTime;
+        }
+        mWriteIndex += lengths.size();
+        return static_cast<int>(mWriteIndex - mReadIndex);
+    }
+
+    bool peekData(std::vector<PacketView>& data, int numPacksToGet)
+    {
+        std::lock_guard<std::mutex> lock(dataBufferLock);
+        if (mWriteIndex - mReadIndex < static_cast<uint64_t>(numPacksToGet))
+        {
+            return false;
+        }
+        for (int i = 0; i < numPacksToGet; i++)
+        {
+            data[i] = PacketView(slotData(mReadIndex + i), mSlotLengths[(mReadIndex + i) % mNumSlots]);
+        }
+        return true;
+    }
+
+    void releaseData(int numPackets)
+    {
+        std::lock_guard<std::mutex> lock(dataBufferLock);
+        mReadIndex += std::min<uint64_t>(numPackets, mWriteIndex - mReadIndex);
+    }
+};
+
+/**
+ * @brief Streams packetsPerIteration packets from a producer thread to the calling thread through ring.
+ * @param batchSize Number of slots the producer tries to fill per receive call.
+ */
+template <typename Ring>
+void streamPackets(Ring& ring, int batchSize)
+{
+    std::thread producer(
+        [&ring, batchSize]()
+        {
+            std::vector<std::span<uint8_t>> slots(batchSize);
+            std::vector<size_t> lengths(batchSize, packetSize);
+            int packetsSent = 0;
+            while (packetsSent < packetsPerIteration)
+            {
+                int numSlots = std::min(ring.acquireWriteSlots(slots), packetsPerIteration - packetsSent);
+                if (numSlots == 0)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (int i = 0; i < numSlots; i++)
+                {
+                    slots[i][0] = static_cast<uint8_t>(packetsSent + i);  // touch the slot like a receive would
+                }
+                ring.commitWriteSlots(std::span(lengths).first(numSlots));
+                packetsSent += numSlots;
+            }
+        });
+
+    std::vector<PacketView> window(windowSize);
+    int packetsReceived = 0;
+    uint64_t checksum = 0;
+    while (packetsReceived < packetsPerIteration)
+    {
+        if (!ring.peekData(window, windowSize))
+        {
+            std::this_thread::yield();  // poll without sleeping so the consumer contends as hard as possible
+            continue;
+        }
+        for (const PacketView& packet : window)
+        {
+            checksum += packet[0];
+        }
+        ring.releaseData(windowSize);
+        packetsReceived += windowSize;
+    }
+    producer.join();
+    benchmark::DoNotOptimize(checksum);
+}
+
+template <typename Ring>
+void BM_PacketHandoff(benchmark::State& state)
+{
+    const int batchSize = static_cast<int>(state.range(0));
+    Ring ring;
+    for (auto _ : state)
+    {
+        streamPackets(ring, batchSize);
+    }
+    state.SetItemsProcessed(state.iterations() * packetsPerIteration);
+    state.SetBytesProcessed(state.iterations() * packetsPerIteration * packetSize);
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_PacketHandoff, SharedDataManager)->Arg(1)->Arg(32)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PacketHandoff, MutexPacketRing)->Arg(1)->Arg(32)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,298 @@
+#include <csignal>
+#include <functional>
+
+#include "../src/firmware/packet_generator_1240.h"
+
+// Sends synthetic firmware 1240 datagrams to one or more listeners at a multiple of the field packet rate. Each stream
+// runs on its own thread and socket and targets port + stream index. Packets are paced against a steady clock and
+// handed to the kernel in batches with sendmmsg (Linux only), so one core can drive many loggers' worth of traffic on
+// loopback.
+
+namespace
+{
+std::atomic<bool> stopRequested{false};
+
+struct LoadGeneratorOptions
+{
+    std::string ipAddress = "127.0.0.1";
+    int port = 1045;
+    int streams = 1;
+    double rateMultiplier = 1.0;  ///< Packet rate as a multiple of the firmware's real packet rate.
+    int batchSize = 32;  ///< Most datagrams handed to one sendmmsg call.
+    int durationSeconds = 0;  ///< 0 runs until interrupted.
+    PacketGeneratorConfig generator;
+};
+
+struct StreamStatistics
+{
+    uint64_t packetsSent = 0;
+    uint64_t packetsDropped = 0;  ///< Deliberately dropped by the --drop-every glitch.
+    uint64_t sendErrors = 0;
+    std::chrono::duration<double> elapsed{0};
+};
+
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --ip <address>             Destination address (default 127.0.0.1)\n"
+              << "  --port <port>              Port of the first stream; stream i sends to port + i (default 1045)\n"
+              << "  --streams <count>          Number of simulated loggers (default 1)\n"
+              << "  --firmware <1240|1240_imu> Packet format (default 1240)\n"
+              << "  --rate <multiple>          Packet rate as a multiple of the field rate (default 1)\n"
+              << "  --batch <packets>          Datagrams per sendmmsg call (default 32)\n"
+              << "  --duration <seconds>       Run time; 0 runs until interrupted (default 0)\n"
+              << "  --clicks-per-second <rate> Mean click rate per stream (default 10)\n"
+              << "  --click-amplitude <counts> Peak click amplitude (default 4000)\n"
+              << "  --noise-amplitude <counts> Noise standard deviation (default 100)\n"
+              << "  --tdoa <d0,d1,d2,d3>       Per-channel click delays in samples (default 0,0,0,0)\n"
+              << "  --time-glitch-every <n>    Advance the clock an extra 103 us every n packets\n"
+              << "  --size-glitch-every <n>    Append 30 duplicated bytes every n packets\n"
+              << "  --drop-every <n>           Do not send every n-th packet\n"
+              << "  --duplicate-every <n>      Send every n-th packet twice\n"
+              << "  --seed <seed>              Seed of stream 0; stream i uses seed + i (default 0)\n";
+}
+
+std::vector<int> parseDelays(const std::string& text)
+{
+    std::vector<int> delays;
+    std::stringstream stream(text);
+    std::string value;
+    while (std::getline(stream, value, ','))
+    {
+        delays.push_back(std::stoi(value));
+    }
+    return delays;
+}
+
+/**
+ * @brief Parses the command line into options.
+ * @throws std::invalid_argument On unknown options, missing values or values out of range.
+ */
+LoadGeneratorOptions parseOptions(int argc, char* argv[])
+{
+    LoadGeneratorOptions options;
+    PacketGeneratorConfig& generator = options.generator;
+    const std::map<std::string, std::function<void(const std::string&)>> setters = {
+        {"--ip", [&](const std::string& value) { options.ipAddress = value; }},
+        {"--port", [&](const std::string& value) { options.port = std::stoi(value); }},
+        {"--streams", [&](const std::string& value) { options.streams = std::stoi(value); }},
+        {"--firmware", [&](const std::string& value) { generator.firmware = value; }},
+        {"--rate", [&](const std::string& value) { options.rateMultiplier = std::stod(value); }},
+        {"--batch", [&](const std::string& value) { options.batchSize = std::stoi(value); }},
+        {"--duration", [&](const std::string& value) { options.durationSeconds = std::stoi(value); }},
+        {"--clicks-per-second", [&](const std::string& value) { generator.clicksPerSecond = std::stod(value); }},
+        {"--click-amplitude", [&](const std::string& value) { generator.clickAmplitude = std::stof(value); }},
+        {"--noise-amplitude", [&](const std::string& value) { generator.noiseAmplitude = std::stof(value); }},
+        {"--tdoa", [&](const std::string& value) { generator.tdoaSamples = parseDelays(value); }},
+        {"--time-glitch-every", [&](const std::string& value) { generator.timeGlitchEvery = std::stoi(value); }},
+        {"--size-glitch-every", [&](const std::string& value) { generator.sizeGlitchEvery = std::stoi(value); }},
+        {"--drop-every", [&](const std::string& value) { generator.dropEvery = std::stoi(value); }},
+        {"--duplicate-every", [&](const std::string& value) { generator.duplicateEvery = std::stoi(value); }},
+        {"--seed", [&](const std::string& value) { generator.seed = static_cast<uint32_t>(std::stoul(value)); }},
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument("Missing value for " + option);
+        }
+        const std::string value = argv[++i];
+
+        const auto setter = setters.find(option);
+        if (setter == setters.end())
+        {
+            throw std::invalid_argument("Unknown option " + option);
+        }
+        setter->second(value);
+    }
+
+    if (options.streams < 1 || options.batchSize < 1 || options.rateMultiplier <= 0 || options.durationSeconds < 0)
+    {
+        throw std::invalid_argument("streams and batch must be at least 1, rate positive and duration not negative");
+    }
+    return options;
+}
+
+/**
+ * @brief Sends every message with sendmmsg, retrying the remainder of partial sends.
+ * @return Number of datagrams the kernel rejected.
+ */
+uint64_t sendAll(int socketDescriptor, std::span<mmsghdr> messages)
+{
+    uint64_t errors = 0;
+    size_t sent = 0;
+    while (sent < messages.size())
+    {
+        const int result = sendmmsg(socketDescriptor, messages.data() + sent, messages.size() - sent, 0);
+        if (result == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            errors++;  // e.g. ENOBUFS when the loopback queue is full; skip the datagram rather than stall the pacing
+            sent++;
+            continue;
+        }
+        sent += result;
+    }
+    return errors;
+}
+
+/**
+ * @brief Paces one stream's packets until the run time elapses or the program is interrupted.
+ */
+void runStream(const LoadGeneratorOptions& options, int streamIndex, StreamStatistics& statistics)
+{
+    PacketGeneratorConfig generatorConfig = options.generator;
+    generatorConfig.seed += streamIndex;
+    PacketGenerator1240 generator(generatorConfig);
+
+    const int socketDescriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socketDescriptor == -1)
+    {
+        throw std::runtime_error("Unable to create socket: " + std::string(strerror(errno)) + "\n");
+    }
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(static_cast<uint16_t>(options.port + streamIndex));
+    if (inet_pton(AF_INET, options.ipAddress.c_str(), &destination.sin_addr) != 1)
+    {
+        close(socketDescriptor);
+        throw std::invalid_argument("Invalid IP address " + options.ipAddress);
+    }
+
+    // A duplicated packet takes two messages, so a batch of generated packets needs up to twice as many slots
+    const size_t maxMessages = 2 * static_cast<size_t>(options.batchSize);
+    std::vector<std::vector<uint8_t>> packets(options.batchSize, std::vector<uint8_t>(generator.maxPacketSize()));
+    std::vector<iovec> ioVectors(maxMessages);
+    std::vector<mmsghdr> messages(maxMessages);
+
+    const std::chrono::duration<double> packetInterval =
+        std::chrono::microseconds(generator.microIncrement()) / options.rateMultiplier;
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::seconds(options.durationSeconds);
+
+    while (!stopRequested.load(std::memory_order_relaxed))
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (options.durationSeconds > 0 && now >= end)
+        {
+            break;
+        }
+
+        const uint64_t packetsDue = static_cast<uint64_t>((now - start) / packetInterval) + 1;
+        if (packetsDue <= generator.packetsGenerated())
+        {
+            std::this_thread::sleep_until(
+                start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            packetInterval * static_cast<double>(generator.packetsGenerated())));
+            continue;
+        }
+
+        const uint64_t packetsToGenerate =
+            std::min<uint64_t>(packetsDue - generator.packetsGenerated(), options.batchSize);
+        size_t messageCount = 0;
+        for (uint64_t i = 0; i < packetsToGenerate; i++)
+        {
+            std::vector<uint8_t>& packet = packets[i];
+            const auto fate = generator.next(packet);
+            if (fate == PacketGenerator1240::PacketFate::Drop)
+            {
+                statistics.packetsDropped++;
+                continue;
+            }
+
+            const int copies = fate == PacketGenerator1240::PacketFate::Duplicate ? 2 : 1;
+            for (int copy = 0; copy < copies; copy++)
+            {
+                ioVectors[messageCount] = {packet.data(), packet.size()};
+                messages[messageCount] = {};
+                messages[messageCount].msg_hdr.msg_name = &destination;
+                messages[messageCount].msg_hdr.msg_namelen = sizeof(destination);
+                messages[messageCount].msg_hdr.msg_iov = &ioVectors[messageCount];
+                messages[messageCount].msg_hdr.msg_iovlen = 1;
+                messageCount++;
+            }
+        }
+
+        const uint64_t errors = sendAll(socketDescriptor, std::span<mmsghdr>(messages.data(), messageCount));
+        statistics.sendErrors += errors;
+        statistics.packetsSent += messageCount - errors;
+    }
+
+    statistics.elapsed = std::chrono::steady_clock::now() - start;
+    close(socketDescriptor);
+}
+
+void printStatistics(const LoadGeneratorOptions& options, const std::vector<StreamStatistics>& statistics)
+{
+    const double fieldPacketRate = 1e6 / PacketGenerator1240(options.generator).microIncrement();
+    for (size_t stream = 0; stream < statistics.size(); stream++)
+    {
+        const StreamStatistics& streamStatistics = statistics[stream];
+        const double elapsed = streamStatistics.elapsed.count();
+        const double packetRate = elapsed > 0 ? streamStatistics.packetsSent / elapsed : 0;
+        std::cout << "Stream " << stream << " (port " << options.port + stream << "): " << streamStatistics.packetsSent
+                  << " packets sent in " << elapsed << " s (" << packetRate << " packets/s, "
+                  << packetRate / fieldPacketRate << "x field rate), " << streamStatistics.packetsDropped
+                  << " dropped, " << streamStatistics.sendErrors << " send errors" << std::endl;
+    }
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h"))
+    {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    LoadGeneratorOptions options;
+    try
+    {
+        options = parseOptions(argc, argv);
+        PacketGenerator1240 validateConfig(options.generator);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::signal(SIGINT, [](int) { stopRequested = true; });
+    std::signal(SIGTERM, [](int) { stopRequested = true; });
+
+    std::cout << "Sending " << options.streams << " stream(s) of firmware " << options.generator.firmware
+              << " packets to " << options.ipAddress << ":" << options.port << " at " << options.rateMultiplier
+              << "x field rate" << std::endl;
+
+    std::vector<StreamStatistics> statistics(options.streams);
+    std::vector<std::thread> streamThreads;
+    for (int stream = 0; stream < options.streams; stream++)
+    {
+        streamThreads.emplace_back(
+            [&options, &statistics, stream]()
+            {
+                try
+                {
+                    runStream(options, stream, statistics[stream]);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Stream " << stream << " stopped: " << e.what() << std::endl;
+                }
+            });
+    }
+    for (auto& streamThread : streamThreads)
+    {
+        streamThread.join();
+    }
+
+    printStatistics(options, statistics);
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include <pybind11/chrono.h>
+#include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "../src/ML/onnx_model.h"
+#include "../src/algorithms/doa_utils.h"
+#include "../src/algorithms/fir_filter.h"
+#include "../src/algorithms/frequency_domain_detectors_factory.h"
+#include "../src/algorithms/gcc_phat.h"
+#include "../src/algorithms/hydrophone_position_processing.h"
+#include "../src/algorithms/time_domain_detectors_factory.h"
+#include "../src/tracker/tracker.h"
+
+// Python bindings for the listener's processing chain, so archives can be analysed with the production algorithms.
+// Arrays are read in place: samples through an Eigen::Map over the NumPy buffer, spectra and channels through
+// Eigen::Ref. Arguments that would need a copy or a dtype conversion are rejected instead (arguments marked
+// noconvert), and the GIL is released while the C++ code runs.
+
+namespace py = pybind11;
+
+namespace
+{
+/// Window samples as the logger records them: one row per sample, one float32 column per channel, C order.
+using SampleArray = py::array_t<float, py::array::c_style>;
+
+/// A row-major TDOA matrix, one detection per row, as a C-order NumPy array.
+using TdoaRows = Eigen::Ref<const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>;
+
+/**
+ * @brief Views a (samples, channels) array as the listener's channels x samples column-major matrix, which is the
+ * same memory: channel samples interleaved, as the firmware decodes them.
+ * @throws std::invalid_argument If the array is not two-dimensional with numChannels columns.
+ */
+Eigen::Map<const Eigen::MatrixXf> mapChannelMatrix(const SampleArray& samples, int numChannels)
+{
+    if (samples.ndim() != 2 || samples.shape(1) != numChannels)
+    {
+        throw std::invalid_argument(
+            "Samples must be a (samples, " + std::to_string(numChannels) + ") float32 array in C order");
+    }
+    return Eigen::Map<const Eigen::MatrixXf>(samples.data(), numChannels, samples.shape(0));
+}
+
+/**
+ * @class PythonFrequencyDomainFilter
+ * @brief FrequencyDomainFilterStrategy together with the zero-padded FFT input its plan is bound to, which the
+ * pipeline keeps in WindowAnalyzer.
+ */
+class PythonFrequencyDomainFilter
+{
+   public:
+    PythonFrequencyDomainFilter(const std::string& filterPath, int channelSize, int numChannels)
+        : mChannelSize(channelSize),
+          mChannelData(Eigen::MatrixXf::Zero(numChannels, channelSize)),
+          mFilter(filterPath, mChannelData, numChannels)
+    {
+    }
+
+    PythonFrequencyDomainFilter(const PythonFrequencyDomainFilter&) = delete;
+    PythonFrequencyDomainFilter& operator=(const PythonFrequencyDomainFilter&) = delete;
+
+    /**
+     * @brief Filters one window, as WindowAnalyzer::filter does, and returns the filtered spectra.
+     * @throws std::invalid_argument If the window is not channelSize samples long.
+     */
+    Eigen::MatrixXcf& apply(const Eigen::Map<const Eigen::MatrixXf>& window)
+    {
+        if (window.cols() != mChannelSize)
+        {
+            throw std::invalid_argument("Windows must hold " + std::to_string(mChannelSize) + " samples");
+        }
+        mChannelData.leftCols(mChannelSize) = window;  // the padding past the window stays zero
+        mFilter.apply();
+        return mFilter.getFrequencyDomainData();
+    }
+
+    Eigen::MatrixXcf& unfilteredSpectra() { return mFilter.mBeforeFilter; }
+    int paddedLength() const { return mFilter.getPaddedLength(); }
+    int channelSize() const { return mChannelSize; }
+    int numChannels() const { return static_cast<int>(mChannelData.rows()); }
+
+   private:
+    const int mChannelSize;
+    Eigen::MatrixXf mChannelData;  ///< FFT input, widened to the padded length by the strategy.
+    FrequencyDomainFilterStrategy mFilter;
+};
+
+/**
+ * @brief The least squares matrix and hydrophone rank that turn TDOAs into a direction of arrival, computed as the
+ * Pipeline computes them from receiverPositionsPath and speedOfSound.
+ */
+auto leastSquaresMatrix(const std::string& receiverPositionsPath, float speedOfSound) -> std::tuple<Eigen::MatrixXf, int>
+{
+    const Eigen::MatrixXf hydrophonePositions = getHydrophoneRelativePositions(receiverPositionsPath);
+    auto [precomputedP, basisMatrixU, rankOfHydrophoneMatrix] = hydrophoneMatrixDecomposition(hydrophonePositions);
+    return {precomputedP * basisMatrixU.transpose() * speedOfSound, rankOfHydrophoneMatrix};
+}
+
+/**
+ * @brief computeDoaFromTdoa for each row of tdoas.
+ * @return One direction of arrival per row, in a (detections, 3) array.
+ */
+Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> computeDoasFromTdoas(
+    const Eigen::MatrixXf& cachedLeastSquaresResult, const TdoaRows& tdoas, int rank)
+{
+    if (tdoas.cols() != cachedLeastSquaresResult.cols())
+    {
+        throw std::invalid_argument(
+            "TDOA rows must hold " + std::to_string(cachedLeastSquaresResult.cols()) + " channel pairs");
+    }
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> doas(
+        tdoas.rows(), cachedLeastSquaresResult.rows());
+    Eigen::VectorXf tdoa(tdoas.cols());
+    for (Eigen::Index i = 0; i < tdoas.rows(); i++)
+    {
+        tdoa = tdoas.row(i).transpose();
+        doas.row(i) = computeDoaFromTdoa(cachedLeastSquaresResult, tdoa, rank).transpose();
+    }
+    return doas;
+}
+}  // namespace
+
+PYBIND11_MODULE(freewilli, m)
+{
+    m.doc() = "FreeWILLI listener processing chain: filtering, detection, GCC-PHAT, DOA, tracking and classification";
+
+    py::class_<PythonFrequencyDomainFilter>(m, "FrequencyDomainFilterStrategy")
+        .def(
+            py::init<const std::string&, int, int>(), py::arg("filter_path"), py::arg("channel_size"),
+            py::arg("num_channels"))
+        .def(
+            "apply",
+            [](PythonFrequencyDomainFilter& filter, const SampleArray& window) -> Eigen::MatrixXcf&
+            {
+                const Eigen::Map<const Eigen::MatrixXf> channels = mapChannelMatrix(window, filter.numChannels());
+                py::gil_scoped_release release;
+                return filter.apply(channels);
+            },
+            py::arg("window").noconvert(), py::return_value_policy::reference_internal,
+            "Filters a (channel_size, num_channels) float32 window. Returns the (bins, num_channels) spectra as a view "
+            "of the filter's buffer, overwritten by the next call.")
+        .def_property_readonly(
+            "unfiltered_spectra", &PythonFrequencyDomainFilter::unfilteredSpectra,
+            py::return_value_policy::reference_internal)
+        .def_property_readonly("padded_length", &PythonFrequencyDomainFilter::paddedLength)
+        .def_property_readonly("channel_size", &PythonFrequencyDomainFilter::channelSize)
+        .def_property_readonly("num_channels", &PythonFrequencyDomainFilter::numChannels);
+
+    py::class_<ITimeDomainDetector>(m, "TimeDomainDetector")
+        .def(
+            "detect", &ITimeDomainDetector::detect, py::arg("samples").noconvert(),
+            py::call_guard<py::gil_scoped_release>(),
+            "Runs the detector on one channel's float32 samples, e.g. window[:, 0].")
+        .def_property_readonly("last_detection", &ITimeDomainDetector::getLastDetection)
+        .def_property_readonly("last_detection_index", &ITimeDomainDetector::getLastDetectionIndex);
+    py::class_<PeakAmplitudeDetector, ITimeDomainDetector>(m, "PeakAmplitudeDetector")
+        .def(py::init<float>(), py::arg("threshold"));
+    py::class_<NoTimeDomainDetector, ITimeDomainDetector>(m, "NoTimeDomainDetector").def(py::init<>());
+    m.def(
+        "create_time_domain_detector", &ITimeDomainDetectorFactory::create, py::arg("time_domain_detector"),
+        py::arg("threshold"), "Creates the detector a config's timeDomainDetector and timeDomainThreshold select.");
+
+    py::class_<IFrequencyDomainDetector>(m, "FrequencyDomainDetector")
+        .def(
+            "detect", &IFrequencyDomainDetector::detect, py::arg("spectrum").noconvert(),
+            py::call_guard<py::gil_scoped_release>(),
+            "Runs the detector on one channel's complex64 spectrum, e.g. spectra[:, 0].");
+    py::class_<AverageMagnitudeDetector, IFrequencyDomainDetector>(m, "AverageMagnitudeDetector")
+        .def(py::init<float>(), py::arg("threshold"));
+    py::class_<NoFrequencyDomainDetector, IFrequencyDomainDetector>(m, "NoFrequencyDomainDetector")
+        .def(py::init<>());
+    m.def(
+        "create_frequency_domain_detector", &IFrequencyDomainDetectorFactory::create,
+        py::arg("frequency_domain_detector"), py::arg("threshold"),
+        "Creates the detector a config's frequencyDomainDetector and energyDetectionThreshold select.");
+
+    py::class_<GCC_PHAT>(m, "GCC_PHAT")
+        .def(
+            py::init<int, int, int, int>(), py::arg("padded_length"), py::arg("spectra_length"),
+            py::arg("num_channels"), py::arg("sample_rate"))
+        .def(
+            "process", &GCC_PHAT::process, py::arg("spectra").noconvert(), py::call_guard<py::gil_scoped_release>(),
+            "Returns (tdoas, cross-correlation peaks) for each channel pair from (bins, channels) complex64 spectra "
+            "in Fortran order, such as FrequencyDomainFilterStrategy.apply returns.");
+
+    m.def(
+        "least_squares_matrix", &leastSquaresMatrix, py::arg("receiver_positions_path"), py::arg("speed_of_sound"),
+        "Returns (least squares matrix, rank) for compute_doa_from_tdoa, as the pipeline derives them.");
+    m.def(
+        "compute_doa_from_tdoa", &computeDoaFromTdoa, py::arg("least_squares_matrix"), py::arg("tdoa"),
+        py::arg("rank"), py::call_guard<py::gil_scoped_release>());
+    m.def(
+        "compute_doas_from_tdoas", &computeDoasFromTdoas, py::arg("least_squares_matrix"),
+        py::arg("tdoas").noconvert(), py::arg("rank"), py::call_guard<py::gil_scoped_release>(),
+        "compute_doa_from_tdoa for every row of a (detections, pairs) float32 array in C order.");
+    m.def("convert_doa_to_el_az", &convertDoaToElAz, py::arg("doa"));
+
+    // Clustering is paced by the wall clock, as in the listener, so feeding an archive faster than real time
+    // clusters less often relative to the data
+    py::class_<Tracker>(m, "Tracker")
+        .def(
+            py::init(
+                [](double eps, int minSamples, int missedUpdateThreshold, const std::string& outputFile,
+                   const std::string& outputDirectory, int clusterFrequencyInSeconds, int clusterWindowInSeconds)
+                {
+                    return std::make_unique<Tracker>(
+                        eps, minSamples, missedUpdateThreshold, outputFile, outputDirectory,
+                        std::chrono::seconds(clusterFrequencyInSeconds), std::chrono::seconds(clusterWindowInSeconds));
+                }),
+            py::arg("eps") = 0.04, py::arg("min_samples") = 15, py::arg("missed_update_threshold") = 4,
+            py::arg("output_file") = "", py::arg("output_directory") = std::filesystem::current_path().string(),
+            py::arg("cluster_frequency_in_seconds") = 60, py::arg("cluster_window_in_seconds") = 30)
+        .def("initialize_output_file", &Tracker::initializeOutputFile, py::arg("timestamp"))
+        .def(
+            "update_tracker_buffer", &Tracker::updateTrackerBuffer, py::arg("doa"),
+            py::call_guard<py::gil_scoped_release>())
+        .def("schedule_cluster", &Tracker::scheduleCluster, py::call_guard<py::gil_scoped_release>())
+        .def(
+            "update_kalman_filters_continuous", &Tracker::updateKalmanFiltersContinuous, py::arg("observation"),
+            py::arg("timestamp"), py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("num_filters", &Tracker::numFilters)
+        .def_readwrite("is_initialized", &Tracker::mIsTrackerInitialized);
+
+    py::class_<ONNXModel>(m, "ONNXModel")
+        .def(py::init<const std::string&, const std::string&>(), py::arg("model_path"), py::arg("scaler_params_path"))
+        .def(
+            "run_inference",
+            [](ONNXModel& model, std::vector<float> features) { return model.runInference(features); },
+            py::arg("features"), py::call_guard<py::gil_scoped_release>(),
+            "Classifies a feature vector. It is copied, since the model normalises its input in place.")
+        .def_static("is_noise", &ONNXModel::isNoise, py::arg("output"));
+}
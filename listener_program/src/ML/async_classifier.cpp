@@ -0,0 +1,129 @@
+#include "async_classifier.h"
+
+#include "../stage_tracer.h"
+#include "../utils.h"
+
+/**
+ * @param inference Runs the classifier on one feature vector; called on the classifier thread only.
+ * @param queueCapacity Requests that may wait for the classifier thread before submissions are refused.
+ * @param deadline How long after submission a verdict is waited for.
+ * @param core CPU core for the classifier thread, -1 to leave it unpinned.
+ */
+AsyncClassifier::AsyncClassifier(
+    Inference inference, size_t queueCapacity, std::chrono::milliseconds deadline, int core)
+    : mInference(std::move(inference)),
+      mQueueCapacity(queueCapacity),
+      mDeadline(deadline),
+      mThread(&AsyncClassifier::run, this)
+{
+    pinThreadToCore(mThread, core);
+}
+
+/**
+ * @brief Stops the classifier thread once the request it is running finishes. Queued requests are abandoned.
+ */
+AsyncClassifier::~AsyncClassifier()
+{
+    {
+        std::lock_guard<std::mutex> lock(mRequestLock);
+        mStopping = true;
+    }
+    mRequestReady.notify_one();
+    mThread.join();
+}
+
+/**
+ * @brief Queues a feature vector for classification.
+ * @return The pending verdict, due within the configured deadline; invalid, and counted, if the queue was full.
+ */
+AsyncClassifier::Pending AsyncClassifier::submit(std::vector<float> features)
+{
+    Pending pending;
+    pending.deadline = std::chrono::steady_clock::now() + mDeadline;
+    size_t queueDepth = 0;
+    {
+        std::lock_guard<std::mutex> lock(mRequestLock);
+        if (mRequests.size() >= mQueueCapacity)
+        {
+            mQueueOverflows.fetch_add(1, std::memory_order_relaxed);
+            return pending;
+        }
+        mRequests.push_back(Request{std::move(features), {}});
+        pending.output = mRequests.back().output.get_future();
+        queueDepth = mRequests.size();
+    }
+    mRequestReady.notify_one();
+
+    size_t maxQueueDepth = mMaxQueueDepth.load(std::memory_order_relaxed);
+    while (queueDepth > maxQueueDepth && !mMaxQueueDepth.compare_exchange_weak(maxQueueDepth, queueDepth))
+    {
+    }
+    return pending;
+}
+
+/**
+ * @brief Waits until the verdict is ready or its deadline passes, whichever is first.
+ * @return The classifier output, or nothing if the window was never queued or the deadline was missed.
+ * @throws Whatever the inference threw for this window.
+ */
+std::optional<std::vector<float>> AsyncClassifier::await(Pending& pending)
+{
+    if (!pending.output.valid())
+    {
+        return std::nullopt;
+    }
+    if (pending.output.wait_until(pending.deadline) != std::future_status::ready)
+    {
+        mDeadlineMisses.fetch_add(1, std::memory_order_relaxed);
+        pending.output = {};  // the late verdict is discarded by the classifier thread
+        return std::nullopt;
+    }
+    return pending.output.get();
+}
+
+size_t AsyncClassifier::queueDepth() const
+{
+    std::lock_guard<std::mutex> lock(mRequestLock);
+    return mRequests.size();
+}
+
+/**
+ * @brief One-line summary of the request queue and the verdicts missed so far.
+ */
+std::string AsyncClassifier::summary() const
+{
+    std::stringstream summary;
+    summary << "queue depth: " << queueDepth() << " (max " << maxQueueDepth() << ")"
+            << " deadline misses: " << deadlineMisses() << " queue overflows: " << queueOverflows();
+    return summary.str();
+}
+
+/**
+ * @brief Classifier thread body: runs the queued requests in order until destruction.
+ */
+void AsyncClassifier::run()
+{
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mRequestLock);
+            mRequestReady.wait(lock, [this]() { return mStopping || !mRequests.empty(); });
+            if (mStopping)
+            {
+                return;
+            }
+            request = std::move(mRequests.front());
+            mRequests.pop_front();
+        }
+        try
+        {
+            TRACE_STAGE(Classifier);
+            request.output.set_value(mInference(request.features));
+        }
+        catch (...)
+        {
+            request.output.set_exception(std::current_exception());
+        }
+    }
+}
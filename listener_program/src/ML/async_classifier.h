@@ -0,0 +1,68 @@
+#pragma once
+#include "../pch.h"
+
+/**
+ * @class AsyncClassifier
+ * @brief Runs classifier inference on a dedicated thread so that localisation does not wait for it.
+ *
+ * Windows are submitted as feature vectors and get back a Pending verdict with a deadline. The submitter carries on
+ * (with GCC-PHAT and DOA) and only awaits the verdict when the result is about to be output. A verdict that is not
+ * ready by its deadline is abandoned and counted as a miss, as is a submission that finds the request queue full;
+ * the caller then keeps the detection unclassified, as when the classifier is shed under load. submit and await may
+ * be called from any number of threads.
+ */
+class AsyncClassifier
+{
+   public:
+    using Inference = std::function<std::vector<float>(std::vector<float>&)>;
+
+    /**
+     * @brief A submitted window's classifier output, to be awaited by its deadline. Invalid if never queued.
+     */
+    struct Pending
+    {
+        std::future<std::vector<float>> output;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    AsyncClassifier(Inference inference, size_t queueCapacity, std::chrono::milliseconds deadline, int core = -1);
+    ~AsyncClassifier();
+
+    AsyncClassifier(const AsyncClassifier&) = delete;
+    AsyncClassifier& operator=(const AsyncClassifier&) = delete;
+
+    Pending submit(std::vector<float> features);
+
+    std::optional<std::vector<float>> await(Pending& pending);
+
+    size_t queueDepth() const;
+    size_t maxQueueDepth() const { return mMaxQueueDepth.load(std::memory_order_relaxed); }
+    uint64_t deadlineMisses() const { return mDeadlineMisses.load(std::memory_order_relaxed); }
+    uint64_t queueOverflows() const { return mQueueOverflows.load(std::memory_order_relaxed); }
+
+    std::string summary() const;
+
+   private:
+    struct Request
+    {
+        std::vector<float> features;
+        std::promise<std::vector<float>> output;
+    };
+
+    void run();
+
+    const Inference mInference;
+    const size_t mQueueCapacity;
+    const std::chrono::milliseconds mDeadline;
+
+    mutable std::mutex mRequestLock;
+    std::condition_variable mRequestReady;
+    std::deque<Request> mRequests;
+    bool mStopping = false;
+
+    std::atomic<size_t> mMaxQueueDepth = 0;  ///< Deepest the request queue has been.
+    std::atomic<uint64_t> mDeadlineMisses = 0;  ///< Verdicts abandoned because they were not ready in time.
+    std::atomic<uint64_t> mQueueOverflows = 0;  ///< Submissions refused because the request queue was full.
+
+    std::thread mThread;  ///< Declared last so that everything it uses exists before it starts.
+};
@@ -1,5 +1,7 @@
 #include "onnx_model.h"
 
+#include "../logger.h"
+
 /**
  * @brief Constructs the ONNXModel object, initializes the ONNX session, and loads the scaler parameters.
  * @param modelPath Path to the ONNX model file.
@@ -7,7 +9,7 @@
  */
 ONNXModel::ONNXModel(const std::string& modelPath, const std::string& scalerParamsPath)
 {
-    std::cout << "Initializing ONNX model" << std::endl;
+    LOG_INFO("onnx", "Initializing ONNX model " << modelPath);
 
     Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "ONNXRuntime");
     mSessionOptions.SetIntraOpNumThreads(1);
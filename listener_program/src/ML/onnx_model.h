@@ -11,6 +11,9 @@ class ONNXModel
     std::vector<float> runInference(std::vector<float>& inputTensorValues);
     void normalizeData(std::vector<float>& data) const;
 
+    /** @brief True if runInference's output scores noise above a click. */
+    static bool isNoise(const std::vector<float>& output) { return output[1] < output[0]; }
+
    private:
     Ort::SessionOptions mSessionOptions;
     Ort::Session mSession{nullptr};
@@ -1,20 +1,78 @@
 #include "fir_filter.h"
 
+namespace
+{
+std::vector<float> readFirFilterFile(const std::string& filePath)
+{
+    std::ifstream inputFile(filePath);
+    if (!inputFile.is_open())
+    {
+        throw std::runtime_error("Unable to open filter file: " + filePath);
+    }
+
+    std::vector<float> filterCoefficients;
+    std::string line;
+    while (std::getline(inputFile, line))
+    {
+        std::stringstream lineStream(line);
+        std::string token;
+        while (std::getline(lineStream, token, ','))
+        {
+            filterCoefficients.push_back(std::stof(token));
+        }
+    }
+    return filterCoefficients;
+}
+}  // namespace
+
+/**
+ * @brief Reads the FIR taps from filterPath and computes their spectrum for channels of channelSize samples.
+ * @throws std::runtime_error If the filter file cannot be opened.
+ */
+std::shared_ptr<const FilterSpectrum> FilterSpectrum::load(const std::string& filterPath, int channelSize)
+{
+    auto filterWeights = readFirFilterFile(filterPath);
+
+    auto spectrum = std::make_shared<FilterSpectrum>();
+    spectrum->paddedLength = static_cast<int>(filterWeights.size() + channelSize - 1);
+    spectrum->frequencyResponse.resize((spectrum->paddedLength / 2) + 1);
+
+    std::vector<float> paddedFilter(spectrum->paddedLength, 0.0f);
+    std::copy(filterWeights.begin(), filterWeights.end(), paddedFilter.begin());
+
+    fftwf_plan fftFilter = fftwf_plan_dft_r2c_1d(
+        spectrum->paddedLength, paddedFilter.data(),
+        reinterpret_cast<fftwf_complex*>(spectrum->frequencyResponse.data()), FFTW_ESTIMATE);
+    fftwf_execute(fftFilter);
+    fftwf_destroy_plan(fftFilter);
+    return spectrum;
+}
+
 FrequencyDomainFilterStrategy::FrequencyDomainFilterStrategy(
     const std::string& filterPath, Eigen::MatrixXf& channelData, int numChannels)
-    : mNumChannels(numChannels)
+    : FrequencyDomainFilterStrategy(
+          FilterSpectrum::load(filterPath, static_cast<int>(channelData.cols())), channelData, numChannels)
 {
-    auto filterWeights = readFirFilterFile(filterPath);
-    mPaddedLength = static_cast<int>(filterWeights.size() + channelData.cols() - 1);
-    mFftOutputSize = (mPaddedLength / 2) + 1;
+}
 
+/**
+ * @param filterSpectrum Precomputed filter response, possibly shared with other pipelines; its padded length must
+ * match channelData's channel length.
+ * @param channelData Channel matrix that is widened to the padded length and used as the FFT input.
+ * @param numChannels Number of channels in channelData.
+ */
+FrequencyDomainFilterStrategy::FrequencyDomainFilterStrategy(
+    std::shared_ptr<const FilterSpectrum> filterSpectrum, Eigen::MatrixXf& channelData, int numChannels)
+    : mNumChannels(numChannels),
+      mPaddedLength(filterSpectrum->paddedLength),
+      mFftOutputSize((mPaddedLength / 2) + 1),
+      mFilterSpectrum(std::move(filterSpectrum))
+{
     channelData.conservativeResize(channelData.rows(), mPaddedLength);
     channelData.setZero();
 
     mSavedFFTs = Eigen::MatrixXcf::Zero(mFftOutputSize, mNumChannels);
 
-    initializeFilterWeights(filterWeights);
-
     createFftPlan(channelData);
 }
 
@@ -33,9 +91,10 @@ void FrequencyDomainFilterStrategy::apply()
 
     fftwf_execute(mForwardFftPlan);
     mBeforeFilter = mSavedFFTs;
+    const Eigen::VectorXcf& filterFreq = mFilterSpectrum->frequencyResponse;
     for (int channelIndex = 0; channelIndex < mNumChannels; ++channelIndex)
     {
-        mSavedFFTs.col(channelIndex) = mSavedFFTs.col(channelIndex).array() * mFilterFreq.array();
+        mSavedFFTs.col(channelIndex) = mSavedFFTs.col(channelIndex).array() * filterFreq.array();
     }
 }
 
@@ -50,37 +109,3 @@ void FrequencyDomainFilterStrategy::createFftPlan(Eigen::MatrixXf& channelData)
         1, &mPaddedLength, mNumChannels, channelData.data(), nullptr, mNumChannels, 1,
         reinterpret_cast<fftwf_complex*>(mSavedFFTs.data()), nullptr, 1, mFftOutputSize, FFTW_ESTIMATE);
 }
-
-void FrequencyDomainFilterStrategy::initializeFilterWeights(const std::vector<float>& filterWeights)
-{
-    mFilterFreq.resize(mFftOutputSize);
-    std::vector<float> paddedFilter(mPaddedLength, 0.0f);
-    std::copy(filterWeights.begin(), filterWeights.end(), paddedFilter.begin());
-
-    fftwf_plan fftFilter = fftwf_plan_dft_r2c_1d(
-        mPaddedLength, paddedFilter.data(), reinterpret_cast<fftwf_complex*>(mFilterFreq.data()), FFTW_ESTIMATE);
-    fftwf_execute(fftFilter);
-    fftwf_destroy_plan(fftFilter);
-}
-
-std::vector<float> FrequencyDomainFilterStrategy::readFirFilterFile(const std::string& filePath)
-{
-    std::ifstream inputFile(filePath);
-    if (!inputFile.is_open())
-    {
-        throw std::runtime_error("Unable to open filter file: " + filePath);
-    }
-
-    std::vector<float> filterCoefficients;
-    std::string line;
-    while (std::getline(inputFile, line))
-    {
-        std::stringstream lineStream(line);
-        std::string token;
-        while (std::getline(lineStream, token, ','))
-        {
-            filterCoefficients.push_back(std::stof(token));
-        }
-    }
-    return filterCoefficients;
-}
\ No newline at end of file
@@ -1,6 +1,19 @@
 #pragma once
 #include "../pch.h"
 
+/**
+ * @brief Frequency response of an FIR filter, zero-padded to the FFT length used for one channel length.
+ *
+ * Read-only once computed, so every pipeline using the same filter and channel length can share one instance.
+ */
+struct FilterSpectrum
+{
+    int paddedLength = 0;  ///< Filter taps + channel samples - 1, the linear convolution length.
+    Eigen::VectorXcf frequencyResponse;  ///< paddedLength / 2 + 1 bins.
+
+    static std::shared_ptr<const FilterSpectrum> load(const std::string& filterPath, int channelSize);
+};
+
 class IFrequencyDomainStrategy
 {
    public:
@@ -18,6 +31,8 @@ class FrequencyDomainFilterStrategy : public IFrequencyDomainStrategy
 {
    public:
     FrequencyDomainFilterStrategy(const std::string& filterPath, Eigen::MatrixXf& channelData, int numChannels);
+    FrequencyDomainFilterStrategy(
+        std::shared_ptr<const FilterSpectrum> filterSpectrum, Eigen::MatrixXf& channelData, int numChannels);
     ~FrequencyDomainFilterStrategy();
 
     void apply() override;
@@ -25,15 +40,13 @@ class FrequencyDomainFilterStrategy : public IFrequencyDomainStrategy
     Eigen::MatrixXcf& getFrequencyDomainData() override;
 
    private:
-    void initializeFilterWeights(const std::vector<float>& filterWeights);
     void createFftPlan(Eigen::MatrixXf& channelData);
-    std::vector<float> readFirFilterFile(const std::string& filePath);
 
    private:
     int mNumChannels;
     int mPaddedLength;
     int mFftOutputSize;
-    Eigen::VectorXcf mFilterFreq;
+    std::shared_ptr<const FilterSpectrum> mFilterSpectrum;
 
     fftwf_plan mForwardFftPlan = nullptr;
 
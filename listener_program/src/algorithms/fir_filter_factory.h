@@ -8,7 +8,7 @@ class IFrequencyDomainStrategyFactory
     static std::unique_ptr<IFrequencyDomainStrategy> create(
         const std::string& frequencyDomainStrategy, const std::string& filterWeightsPath,
         Eigen::MatrixXf& channelData,  // pass by ref, so it can be resized if needed
-        int numChannels)
+        int numChannels, std::shared_ptr<const FilterSpectrum> sharedFilterSpectrum = nullptr)
     {
         if (frequencyDomainStrategy == "None")
         {
@@ -16,6 +16,10 @@ class IFrequencyDomainStrategyFactory
         }
         else if (frequencyDomainStrategy == "Filter")
         {
+            if (sharedFilterSpectrum)
+            {
+                return std::make_unique<FrequencyDomainFilterStrategy>(sharedFilterSpectrum, channelData, numChannels);
+            }
             return std::make_unique<FrequencyDomainFilterStrategy>(filterWeightsPath, channelData, numChannels);
         }
         else
@@ -4,7 +4,7 @@
 
 AverageMagnitudeDetector::AverageMagnitudeDetector(float threshold) : detectionThreshold(threshold) {}
 
-bool AverageMagnitudeDetector::detect(const Eigen::VectorXcf& frequencyDomainData) const
+bool AverageMagnitudeDetector::detect(ChannelSpectrum frequencyDomainData) const
 {
     // Compute the average amplitude of the frequency-domain data
     float averageAmplitude = frequencyDomainData.array().abs().sum() / frequencyDomainData.size();
@@ -14,4 +14,4 @@ bool AverageMagnitudeDetector::detect(const Eigen::VectorXcf& frequencyDomainDat
 
 NoFrequencyDomainDetector::NoFrequencyDomainDetector() {}
 
-bool NoFrequencyDomainDetector::detect(const Eigen::VectorXcf& /*frequencyDomainData*/) const { return true; }
\ No newline at end of file
+bool NoFrequencyDomainDetector::detect(ChannelSpectrum /*frequencyDomainData*/) const { return true; }
\ No newline at end of file
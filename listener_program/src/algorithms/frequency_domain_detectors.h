@@ -1,12 +1,15 @@
 #pragma once
 #include "../pch.h"
 
+/// One channel's spectrum; a column of the filter's spectra matrix is passed without a copy.
+using ChannelSpectrum = Eigen::Ref<const Eigen::VectorXcf>;
+
 class IFrequencyDomainDetector
 {
    public:
     virtual ~IFrequencyDomainDetector() = default;
 
-    virtual bool detect(const Eigen::VectorXcf& frequencyDomainData) const = 0;
+    virtual bool detect(ChannelSpectrum frequencyDomainData) const = 0;
 };
 
 class AverageMagnitudeDetector : public IFrequencyDomainDetector
@@ -17,7 +20,7 @@ class AverageMagnitudeDetector : public IFrequencyDomainDetector
    public:
     explicit AverageMagnitudeDetector(float threshold);
 
-    bool detect(const Eigen::VectorXcf& frequencyDomainData) const override;
+    bool detect(ChannelSpectrum frequencyDomainData) const override;
 };
 
 class NoFrequencyDomainDetector : public IFrequencyDomainDetector
@@ -28,5 +31,5 @@ class NoFrequencyDomainDetector : public IFrequencyDomainDetector
    public:
     explicit NoFrequencyDomainDetector();
 
-    bool detect(const Eigen::VectorXcf& frequencyDomainData) const override;
+    bool detect(ChannelSpectrum frequencyDomainData) const override;
 };
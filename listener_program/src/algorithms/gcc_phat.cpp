@@ -23,12 +23,14 @@ GCC_PHAT::~GCC_PHAT() { fftwf_destroy_plan(mInverseFftPlan); }
  * cross-correlation peak magnitudes.
  *
  * @param savedFfts A matrix of saved FFTs, where each column represents the FFT of a different microphone channel.
+ *        Any column-major matrix, such as a NumPy array in Fortran order, is read in place.
  *
  * @return A tuple containing:
  *         - Eigen::VectorXf: A vector of estimated TDOA values for each microphone pair.
  *         - Eigen::VectorXf: A vector of cross-correlation peak magnitudes corresponding to each TDOA.
  */
-auto GCC_PHAT::process(const Eigen::MatrixXcf& savedFfts) -> std::tuple<Eigen::VectorXf, Eigen::VectorXf>
+auto GCC_PHAT::process(const Eigen::Ref<const Eigen::MatrixXcf>& savedFfts)
+    -> std::tuple<Eigen::VectorXf, Eigen::VectorXf>
 {
     Eigen::VectorXf tdoaEstimates(mNumTdoas);
     Eigen::VectorXf crossCorrPeaks(mNumTdoas);
@@ -63,7 +65,8 @@ auto GCC_PHAT::process(const Eigen::MatrixXcf& savedFfts) -> std::tuple<Eigen::V
  *
  * @throws std::runtime_error If the computed cross-spectrum contains NaN or infinite values.
  */
-void GCC_PHAT::calculateNormalizedCrossSpectra(const Eigen::VectorXcf& s1, const Eigen::VectorXcf& s2)
+void GCC_PHAT::calculateNormalizedCrossSpectra(
+    const Eigen::Ref<const Eigen::VectorXcf>& s1, const Eigen::Ref<const Eigen::VectorXcf>& s2)
 {
     Eigen::VectorXcf crossSpectrum = s1.array() * s2.conjugate().array();
     Eigen::VectorXf magnitudes = crossSpectrum.cwiseAbs().unaryExpr([](float x) { return (x == 0.0f) ? 1.0f : x; });
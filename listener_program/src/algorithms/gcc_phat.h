@@ -15,10 +15,11 @@ class GCC_PHAT
     GCC_PHAT(int paddedLength, int spectraLength, int numChannels, int sampleRate);
     ~GCC_PHAT();
 
-    std::tuple<Eigen::VectorXf, Eigen::VectorXf> process(const Eigen::MatrixXcf& savedFfts);
+    std::tuple<Eigen::VectorXf, Eigen::VectorXf> process(const Eigen::Ref<const Eigen::MatrixXcf>& savedFfts);
 
    private:
-    void calculateNormalizedCrossSpectra(const Eigen::VectorXcf& s1, const Eigen::VectorXcf& s2);
+    void calculateNormalizedCrossSpectra(
+        const Eigen::Ref<const Eigen::VectorXcf>& s1, const Eigen::Ref<const Eigen::VectorXcf>& s2);
     std::tuple<float, float> estimateTdoaAndPeak();
 
     int mPaddedLength;
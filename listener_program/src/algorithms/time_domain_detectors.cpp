@@ -4,10 +4,8 @@
 
 PeakAmplitudeDetector::PeakAmplitudeDetector(float threshold) : detectionThreshold(threshold), peakAmplitude(0) {}
 
-bool PeakAmplitudeDetector::detect(const Eigen::VectorXf& timeDomainData)
+bool PeakAmplitudeDetector::detect(ChannelSamples timeDomainData)
 {
-    int peakIndex = 0;
-
     peakAmplitude = timeDomainData.maxCoeff(&peakIndex);
 
     return peakAmplitude >= detectionThreshold;
@@ -1,12 +1,16 @@
 #pragma once
 #include "../pch.h"
 
+/// One channel of samples; the inner stride lets a channel row of an interleaved matrix be passed without a copy.
+using ChannelSamples = Eigen::Ref<const Eigen::VectorXf, 0, Eigen::InnerStride<>>;
+
 class ITimeDomainDetector
 {
    public:
     virtual ~ITimeDomainDetector() = default;
-    virtual bool detect(const Eigen::VectorXf& timeDomainData) = 0;
+    virtual bool detect(ChannelSamples timeDomainData) = 0;
     virtual float getLastDetection() const = 0;
+    virtual int getLastDetectionIndex() const = 0;  ///< Sample index of the last detection's peak.
 };
 
 class PeakAmplitudeDetector : public ITimeDomainDetector
@@ -14,30 +18,32 @@ class PeakAmplitudeDetector : public ITimeDomainDetector
    private:
     float detectionThreshold;
     float peakAmplitude;
+    int peakIndex = 0;
 
    public:
     explicit PeakAmplitudeDetector(float threshold);
 
-    bool detect(const Eigen::VectorXf& timeDomainData) override;
+    bool detect(ChannelSamples timeDomainData) override;
     float getLastDetection() const override;
+    int getLastDetectionIndex() const override { return peakIndex; }
 };
 
 class NoTimeDomainDetector : public ITimeDomainDetector
 {
    private:
     float peakAmplitude;
+    int peakIndex = 0;
 
    public:
     NoTimeDomainDetector() = default;
 
-    bool detect(const Eigen::VectorXf& timeDomainData) override
+    bool detect(ChannelSamples timeDomainData) override
     {
-        int peakIndex = 0;
-
         peakAmplitude = timeDomainData.maxCoeff(&peakIndex);
 
         return true;
     }
 
     float getLastDetection() const override { return peakAmplitude; }
+    int getLastDetectionIndex() const override { return peakIndex; }
 };
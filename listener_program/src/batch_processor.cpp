@@ -0,0 +1,164 @@
+#include "batch_processor.h"
+
+#include "io/npy_recording.h"
+#include "io/output_manager.h"
+#include "pipeline.h"
+
+namespace
+{
+// OutputManager stops the program once its runtime is reached; a century never is, yet fits its nanosecond clock
+constexpr std::chrono::hours noRuntimeLimit(24 * 365 * 100);
+
+/**
+ * @brief The configured settings with the ones that depend on a live clock or a live stream overridden.
+ * @throws std::invalid_argument If the firmware is not 1240, the only one recordings can be packetised for.
+ */
+PipelineVariables offlineVariables(PipelineVariables pipelineVariables)
+{
+    if (pipelineVariables.firmware != "1240")
+    {
+        throw std::invalid_argument(
+            "Recordings hold no IMU data, so they can only be processed as firmware 1240, not " +
+            pipelineVariables.firmware);
+    }
+    pipelineVariables.enableStagedPipeline = false;
+    pipelineVariables.windowWorkers = 0;
+    pipelineVariables.enableLoadShedding = false;
+    pipelineVariables.enableAsyncClassifier = false;
+    pipelineVariables.liveOutputAddress = "";
+    pipelineVariables.processingCore = -1;
+    return pipelineVariables;
+}
+}  // namespace
+
+/**
+ * @param pipelineVariables Settings of the pipelines, as for a live stream.
+ * @param outputDirectory Directory under which each recording's output directory is created.
+ * @param numThreads Most recordings processed at once.
+ * @param startTime Timestamp of the first packet of every recording.
+ * @throws std::invalid_argument If the firmware is not 1240 or numThreads is not positive.
+ */
+BatchProcessor::BatchProcessor(
+    const PipelineVariables& pipelineVariables, const std::string& outputDirectory, int numThreads,
+    TimePoint startTime)
+    : mPipelineVariables(offlineVariables(pipelineVariables)),
+      mOutputDirectory(outputDirectory),
+      mNumThreads(numThreads),
+      mStartTime(startTime)
+{
+    if (numThreads < 1)
+    {
+        throw std::invalid_argument("Batch processing needs at least one thread");
+    }
+}
+
+/**
+ * @brief Processes every recording, numThreads at a time, and returns their results in the order given.
+ *
+ * A recording that fails is reported in its result and does not stop the others.
+ */
+std::vector<BatchResult> BatchProcessor::run(const std::vector<std::string>& recordingPaths)
+{
+    std::vector<BatchResult> results(recordingPaths.size());
+    std::atomic<size_t> nextRecording = 0;
+    auto worker = [&]()
+    {
+        for (size_t i = nextRecording++; i < recordingPaths.size(); i = nextRecording++)
+        {
+            results[i] = processRecording(recordingPaths[i]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    const size_t numWorkers = std::min<size_t>(mNumThreads, recordingPaths.size());
+    for (size_t i = 0; i < numWorkers; i++)
+    {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& thread : workers)
+    {
+        thread.join();
+    }
+    return results;
+}
+
+/**
+ * @brief Runs one recording through its own pipeline: this thread feeds the packets while the pipeline thread
+ * processes them, and the output files are complete once this returns.
+ */
+BatchResult BatchProcessor::processRecording(const std::string& recordingPath)
+{
+    BatchResult result;
+    result.recordingPath = recordingPath;
+    const auto start = std::chrono::steady_clock::now();
+    try
+    {
+        NpyRecording recording(recordingPath);
+        RecordingPacketizer1240 packetizer(recording, mStartTime);
+
+        PipelineVariables pipelineVariables = mPipelineVariables;
+        result.outputDirectory =
+            (std::filesystem::path(mOutputDirectory) / std::filesystem::path(recordingPath).stem()).string() + "/";
+        std::filesystem::create_directories(result.outputDirectory);
+        pipelineVariables.loggingDirectory = result.outputDirectory;
+
+        // Declared in the order StreamRunner declares them, so the pipeline is destroyed before what it refers to
+        SharedDataManager sharedDataManager(packetizer.packetSize(), mRingSlots);
+        OutputManager outputManager(
+            noRuntimeLimit, pipelineVariables.integrationTesting, pipelineVariables.loggingDirectory,
+            pipelineVariables.detectionLogFormat, "", &sharedDataManager.metrics);
+        std::unique_ptr<Pipeline> pipeline;
+        {
+            std::lock_guard<std::mutex> lock(mConstructionLock);
+            pipeline = std::make_unique<Pipeline>(outputManager, sharedDataManager, pipelineVariables, mSharedResources);
+        }
+
+        std::thread pipelineThread(&Pipeline::process, pipeline.get());
+        result.packets = feed(packetizer, sharedDataManager);
+        sharedDataManager.finishStream();
+        pipelineThread.join();
+
+        result.detections = sharedDataManager.detectionCounter;
+        if (sharedDataManager.errorOccurred)
+        {
+            result.error = "processing stopped on an error after " + std::to_string(result.packets) + " packets";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        result.error = e.what();
+    }
+    result.elapsed = std::chrono::steady_clock::now() - start;
+    return result;
+}
+
+/**
+ * @brief Encodes the recording's packets straight into the ring, waiting whenever it is full.
+ * @return Packets fed; fewer than the recording holds if the pipeline stopped on an error.
+ */
+uint64_t BatchProcessor::feed(RecordingPacketizer1240& packetizer, SharedDataManager& sharedDataManager)
+{
+    std::vector<std::span<uint8_t>> slots(mFeedBatchSize);
+    const std::vector<size_t> lengths(mFeedBatchSize, packetizer.packetSize());
+    while (!sharedDataManager.errorOccurred)
+    {
+        // Sleep rather than spin on a full ring: other recordings need the cores
+        if (!sharedDataManager.waitForFreeSlot())
+        {
+            break;
+        }
+        const int numSlots = sharedDataManager.acquireWriteSlots(slots);
+        int numFilled = 0;
+        while (numFilled < numSlots && packetizer.next(slots[numFilled]))
+        {
+            numFilled++;
+        }
+        sharedDataManager.commitWriteSlots(std::span(lengths).first(numFilled));
+        sharedDataManager.packetsReceived += numFilled;
+        if (numFilled < numSlots)
+        {
+            break;  // the recording is exhausted
+        }
+    }
+    return packetizer.packetsWritten();
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "firmware/recording_packetizer_1240.h"
+#include "pch.h"
+#include "pipeline_variables.h"
+#include "shared_data_manager.h"
+#include "shared_pipeline_resources.h"
+
+/**
+ * @brief Outcome of processing one recording.
+ */
+struct BatchResult
+{
+    std::string recordingPath;
+    std::string outputDirectory;  ///< Where the recording's detection and tracker files were written.
+    uint64_t packets = 0;  ///< Packets fed to the pipeline, each microIncre() of recorded time.
+    int detections = 0;
+    std::chrono::duration<double> elapsed{0};
+    std::string error;  ///< Empty if the recording was processed to its end.
+};
+
+/**
+ * @class BatchProcessor
+ * @brief Runs archived recordings through the pipeline offline, several recordings at a time.
+ *
+ * Each recording is cut into the firmware packets a datalogger would have sent (see RecordingPacketizer1240) and fed
+ * straight into a fresh SharedDataManager as fast as its pipeline takes them: there is no socket and no wall-clock
+ * pacing. Every recording gets its own pipeline, output manager and tracker, writing into a subdirectory of the output
+ * directory named after the recording, so results are the files a live run over the same data would have written.
+ * Recordings are independent, so up to numThreads of them run at once; read-only resources such as the ONNX model and
+ * the filter spectra are shared between them.
+ *
+ * The pipeline always runs serially, since parallelism comes from processing several recordings at once. Settings
+ * that only make sense against a live clock are overridden: load shedding (the queue is always full when nothing
+ * paces the input), the asynchronous classifier's deadline and live output.
+ */
+class BatchProcessor
+{
+   public:
+    BatchProcessor(
+        const PipelineVariables& pipelineVariables, const std::string& outputDirectory, int numThreads,
+        TimePoint startTime);
+
+    std::vector<BatchResult> run(const std::vector<std::string>& recordingPaths);
+
+   private:
+    BatchResult processRecording(const std::string& recordingPath);
+    static uint64_t feed(RecordingPacketizer1240& packetizer, SharedDataManager& sharedDataManager);
+
+    static constexpr int mFeedBatchSize = 32;  ///< Packets encoded into the ring per commit.
+    static constexpr int mRingSlots = 1024;
+
+    const PipelineVariables mPipelineVariables;  ///< The configured settings, adjusted for offline processing.
+    const std::string mOutputDirectory;
+    const int mNumThreads;
+    const TimePoint mStartTime;  ///< Timestamp given to the first packet of every recording.
+    SharedPipelineResources mSharedResources;
+    std::mutex mConstructionLock;  ///< Serialises pipeline construction, since FFTW planning is not thread-safe.
+};
@@ -0,0 +1,59 @@
+#include "channel_ring_buffer.h"
+
+/**
+ * @param firmware Decoder of the stream's packets; must outlive the ring.
+ * @param windowPackets Packets per analysis window.
+ */
+ChannelRingBuffer::ChannelRingBuffer(const IFirmware& firmware, int windowPackets)
+    : mFirmware(firmware),
+      mNumChannels(firmware.numChannels()),
+      mWindowPackets(windowPackets),
+      mBlockSize(firmware.channelSize() / firmware.numPacketsToDetect() * firmware.numChannels()),
+      mStorage(2 * static_cast<size_t>(windowPackets) * mBlockSize, 0.0f),
+      mPacketTimes(windowPackets)
+{
+}
+
+/**
+ * @brief Decodes packets into the ring, evicting the oldest ones once it is full.
+ * @param packets Views of the raw packets, in stream order; empty views are zero-filled.
+ * @param packetTimes Timestamp of each packet.
+ */
+void ChannelRingBuffer::push(std::span<const PacketView> packets, std::span<const TimePoint> packetTimes)
+{
+    size_t packetIndex = 0;
+    while (packetIndex < packets.size())
+    {
+        // Decode the run of packets up to the end of the ring in one call, then mirror it
+        const size_t runLength =
+            std::min(packets.size() - packetIndex, static_cast<size_t>(mWindowPackets - mNextBlock));
+        const size_t runSamples = runLength * mBlockSize;
+        mFirmware.insertDataIntoChannelBuffer(
+            std::span<float>(block(mNextBlock), runSamples), packets.subspan(packetIndex, runLength));
+        std::copy_n(block(mNextBlock), runSamples, block(mNextBlock + mWindowPackets));
+        std::copy_n(packetTimes.begin() + packetIndex, runLength, mPacketTimes.begin() + mNextBlock);
+
+        packetIndex += runLength;
+        mNextBlock = (mNextBlock + static_cast<int>(runLength)) % mWindowPackets;
+    }
+    mPacketsWritten += packets.size();
+}
+
+/**
+ * @brief View of the window, oldest packet first, as a channels x samples matrix. Valid until the next push.
+ */
+ChannelRingBuffer::Window ChannelRingBuffer::window() const
+{
+    const float* windowStart = mStorage.data() + static_cast<size_t>(mNextBlock) * mBlockSize;
+    return Window(windowStart, mNumChannels, static_cast<Eigen::Index>(mWindowPackets) * mBlockSize / mNumChannels);
+}
+
+/**
+ * @brief Empties the ring so the next window is built from new packets only.
+ */
+void ChannelRingBuffer::reset()
+{
+    std::fill(mStorage.begin(), mStorage.end(), 0.0f);
+    mNextBlock = 0;
+    mPacketsWritten = 0;
+}
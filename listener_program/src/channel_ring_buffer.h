@@ -0,0 +1,45 @@
+#pragma once
+#include "firmware/firmware_interface.h"
+#include "pch.h"
+
+/**
+ * @class ChannelRingBuffer
+ * @brief Decoded samples of the most recent windowPackets packets, laid out so that the window is always contiguous.
+ *
+ * Packets are decoded once, straight into a ring of packet-sized blocks of interleaved samples (the layout of a
+ * column-major channels x samples matrix). The ring is mirrored: block b is also written at block b + windowPackets,
+ * so the window starting at the oldest block is a contiguous run of memory whatever the write position, and can be
+ * handed to the detectors as a matrix view. Advancing the window by a hop therefore decodes and mirrors only the hop's
+ * new packets; the overlapping samples are neither decoded nor copied again.
+ */
+class ChannelRingBuffer
+{
+   public:
+    using Window = Eigen::Map<const Eigen::MatrixXf>;
+
+    ChannelRingBuffer(const IFirmware& firmware, int windowPackets);
+
+    void push(std::span<const PacketView> packets, std::span<const TimePoint> packetTimes);
+
+    bool isFull() const { return mPacketsWritten >= static_cast<uint64_t>(mWindowPackets); }
+
+    Window window() const;
+
+    TimePoint windowStartTime() const { return mPacketTimes[mNextBlock]; }
+
+    int windowPackets() const { return mWindowPackets; }
+
+    void reset();
+
+   private:
+    float* block(int blockIndex) { return mStorage.data() + static_cast<size_t>(blockIndex) * mBlockSize; }
+
+    const IFirmware& mFirmware;
+    const int mNumChannels;
+    const int mWindowPackets;
+    const int mBlockSize;  ///< Samples (all channels) decoded from one packet.
+    std::vector<float> mStorage;  ///< 2 * mWindowPackets blocks; the second half mirrors the first.
+    std::vector<TimePoint> mPacketTimes;  ///< Timestamp of the packet in each block of the first half.
+    int mNextBlock = 0;  ///< Block the next packet is decoded into; once full, also the oldest block of the window.
+    uint64_t mPacketsWritten = 0;
+};
@@ -8,18 +8,39 @@
  * if an IMU manager is available, it updates the IMU rotation matrix using the input data.
  *
  * @param channelMatrix Reference to an Eigen::MatrixXf where the extracted samples will be stored.
- * @param dataBytes A vector of byte arrays, each containing raw data including a header.
+ * @param dataBytes Views of the raw packets, each containing raw data including a header. An empty view marks a
+ * packet lost in transit; its samples are zero-filled.
  *
  */
 void Firmware1240::insertDataIntoChannelMatrix(
-    Eigen::MatrixXf& channelMatrix, const std::vector<std::vector<uint8_t>>& dataBytes) const
+    Eigen::MatrixXf& channelMatrix, std::span<const PacketView> dataBytes) const
+{
+    insertDataIntoChannelBuffer(std::span<float>(channelMatrix.data(), channelMatrix.size()), dataBytes);
+}
+
+/**
+ * @brief Decodes packets into interleaved channel samples, the layout of a column-major channels x samples matrix.
+ *
+ * @param channelBuffer Destination; packet i is written at offset i * samples per packet, so it must hold at least
+ * dataBytes.size() packets' worth of samples.
+ * @param dataBytes Views of the raw packets. An empty view marks a packet lost in transit; its samples are zero-filled.
+ */
+void Firmware1240::insertDataIntoChannelBuffer(
+    std::span<float> channelBuffer, std::span<const PacketView> dataBytes) const
 {
     for (int i = 0; i < dataBytes.size(); i++)
     {
-        float* __restrict__ matrixPtr = channelMatrix.data();
-        const uint8_t* __restrict__ inPtr = dataBytes[i].data() + HEAD_SIZE;
+        float* __restrict__ matrixPtr = channelBuffer.data();
         const size_t startOffset = i * SAMPS_PER_CHANNEL * NUM_CHAN;
 
+        if (dataBytes[i].empty())
+        {
+            std::fill_n(matrixPtr + startOffset, SAMPS_PER_PACKET, 0.0f);
+            continue;
+        }
+
+        const uint8_t* __restrict__ inPtr = dataBytes[i].data() + HEAD_SIZE;
+
         for (size_t j = 0; j < SAMPS_PER_PACKET; ++j)
         {
             uint16_t sample = (static_cast<uint16_t>(inPtr[BYTES_PER_SAMP * j]) << 8) | inPtr[BYTES_PER_SAMP * j + 1];
@@ -38,16 +59,14 @@ void Firmware1240::insertDataIntoChannelMatrix(
  *
  * This function parses timestamp information from the given raw data packets. It interprets the date and
  * time components (year, month, day, hour, minute, second) and constructs `std::chrono::system_clock::time_point`
- * values, including microsecond-level precision. The parsed timestamps are returned as a vector.
- *
- * @param dataBytes A vector of byte arrays, each containing timestamp information in the first 10 bytes.
+ * values, including microsecond-level precision. The parsed timestamps are written into outputTimes.
  *
- * @return A vector of `TimePoint` objects representing the extracted timestamps.
+ * @param dataBytes Views of the raw packets, each containing timestamp information in the first 10 bytes.
+ * @param outputTimes Destination for one `TimePoint` per packet; must be at least as long as dataBytes.
  */
-std::vector<TimePoint> Firmware1240::generateTimestamp(std::vector<std::vector<uint8_t>>& dataBytes) const
+void Firmware1240::generateTimestamp(std::span<const PacketView> dataBytes, std::span<TimePoint> outputTimes) const
 {
     const size_t dataSize = dataBytes.size();
-    std::vector<std::chrono::system_clock::time_point> outputTimes(dataSize);
 
     for (size_t i = 0; i < dataSize; ++i)
     {
@@ -75,8 +94,6 @@ std::vector<TimePoint> Firmware1240::generateTimestamp(std::vector<std::vector<u
 
         outputTimes[i] = currentTime;
     }
-
-    return outputTimes;
 }
 
 /**
@@ -88,16 +105,16 @@ std::vector<TimePoint> Firmware1240::generateTimestamp(std::vector<std::vector<u
  *
  * If an inconsistency is found, the function throws a `std::runtime_error`.
  *
- * @param dataBytes A vector of byte arrays, each representing a received data packet.
+ * @param dataBytes Views of the received data packets.
  * @param isPreviousTimeSet A flag indicating whether `previousTime` has been set. It is updated within the function.
  * @param previousTime The last valid timestamp. It is updated to the latest processed timestamp.
- * @param dataVector A vector of `TimePoint` timestamps associated with each data packet.
+ * @param dataVector The `TimePoint` timestamps associated with each data packet.
  *
  * @throws std::runtime_error If timestamps are not incrementing as expected or if a packet has an incorrect size.
  */
 void Firmware1240::throwIfDataErrors(
-    const std::vector<std::vector<uint8_t>>& dataBytes, bool& isPreviousTimeSet, TimePoint& previousTime,
-    const std::vector<TimePoint>& dataVector) const
+    std::span<const PacketView> dataBytes, bool& isPreviousTimeSet, TimePoint& previousTime,
+    std::span<const TimePoint> dataVector) const
 {
     for (int i = 0; i < dataVector.size(); i++)
     {
@@ -113,7 +130,7 @@ void Firmware1240::throwIfDataErrors(
         {
             std::stringstream errorMsg;
             errorMsg << "Error: Incorrect number of bytes in packet. Expected: " << packetSize()
-                     << ", Received: " << dataBytes.size() << std::endl;
+                     << ", Received: " << dataBytes[i].size() << std::endl;
             throw std::runtime_error(errorMsg.str());
         }
         previousTime = dataVector[i];
@@ -39,13 +39,16 @@ class Firmware1240 : public IFirmware
     int packetSize() const override { return DATA_SIZE + HEAD_SIZE + imuByteSize(); }
 
     void insertDataIntoChannelMatrix(
-        Eigen::MatrixXf& channelMatrix, const std::vector<std::vector<uint8_t>>& dataBytes) const override;
+        Eigen::MatrixXf& channelMatrix, std::span<const PacketView> dataBytes) const override;
 
-    std::vector<TimePoint> generateTimestamp(std::vector<std::vector<uint8_t>>& dataBytes) const override;
+    void insertDataIntoChannelBuffer(
+        std::span<float> channelBuffer, std::span<const PacketView> dataBytes) const override;
+
+    void generateTimestamp(std::span<const PacketView> dataBytes, std::span<TimePoint> outputTimes) const override;
 
     void throwIfDataErrors(
-        const std::vector<std::vector<uint8_t>>& dataBytes, bool& isPreviousTimeSet, TimePoint& previousTime,
-        const std::vector<TimePoint>& currentTime) const override;
+        std::span<const PacketView> dataBytes, bool& isPreviousTimeSet, TimePoint& previousTime,
+        std::span<const TimePoint> currentTime) const override;
 
     IImuProcessor* getImuManager() const override { return nullptr; }
 };
@@ -26,13 +26,16 @@ class IFirmware
     virtual int packetSize() const = 0;
 
     virtual void insertDataIntoChannelMatrix(
-        Eigen::MatrixXf& channelMatrix, const std::vector<std::vector<uint8_t>>& dataBytes) const = 0;
+        Eigen::MatrixXf& channelMatrix, std::span<const PacketView> dataBytes) const = 0;
 
-    virtual std::vector<TimePoint> generateTimestamp(std::vector<std::vector<uint8_t>>& dataBytes) const = 0;
+    virtual void insertDataIntoChannelBuffer(
+        std::span<float> channelBuffer, std::span<const PacketView> dataBytes) const = 0;
+
+    virtual void generateTimestamp(std::span<const PacketView> dataBytes, std::span<TimePoint> outputTimes) const = 0;
 
     virtual void throwIfDataErrors(
-        const std::vector<std::vector<uint8_t>>& dataBytes, bool& isPreviousTimeSet, TimePoint& previousTime,
-        const std::vector<TimePoint>& currentTime) const = 0;
+        std::span<const PacketView> dataBytes, bool& isPreviousTimeSet, TimePoint& previousTime,
+        std::span<const TimePoint> currentTime) const = 0;
 
     virtual IImuProcessor* getImuManager() const = 0;
 };
@@ -16,7 +16,7 @@ const Eigen::Matrix3f& ImuProcessor1240::getRotationMatrix() { return mRotationM
  * @param dataBytes     A vector of bytes containing the raw IMU data.
  * @param imuByteSize   The size in bytes of each IMU data packet.
  */
-void ImuProcessor1240::setRotationMatrix(Eigen::VectorXf& imuData)
+void ImuProcessor1240::setRotationMatrix(ImuVector& imuData)
 {
     calibrateImuData(imuData);
 
@@ -34,7 +34,7 @@ void ImuProcessor1240::setRotationMatrix(Eigen::VectorXf& imuData)
  *
  * @param imuData A vector containing raw IMU data.
  */
-void ImuProcessor1240::calibrateImuData(Eigen::VectorXf& imuData)
+void ImuProcessor1240::calibrateImuData(ImuVector& imuData)
 {
     // Apply element-wise calibration to each sensors data
     imuData.segment<mDataWidth>(mMagnetometerDataIndex) =
@@ -51,16 +51,16 @@ void ImuProcessor1240::calibrateImuData(Eigen::VectorXf& imuData)
  * frame synchronization, timestamp, magnetometer, gyroscope, and accelerometer readings.
  * If the header is invalid, it returns an empty optional.
  *
- * @param byteBlock A vector of bytes containing IMU data.
+ * @param byteBlock View of the packet whose trailing bytes contain the IMU data.
  * @param imuByteSize The expected size of the IMU data block in bytes.
  * @return std::optional<Eigen::VectorXf> Parsed IMU data in a 20-element vector, or std::nullopt if the header is
  * invalid.
  */
 
-void ImuProcessor1240::processIMUData(const std::vector<uint8_t>& byteBlock)
+void ImuProcessor1240::processIMUData(PacketView byteBlock)
 {
-    Eigen::VectorXf imuData(20);  // Reserve space for 20 elements
-    std::vector<uint8_t> block(byteBlock.end() - mImuByteSize, byteBlock.end());
+    ImuVector imuData;
+    PacketView block = byteBlock.last(mImuByteSize);
 
     // Check for valid header ('I' and 'M')
     if (block[0] == 'I' && block[1] == 'M')
@@ -17,7 +17,7 @@ class ImuProcessor1240 : public IImuProcessor
 
     const Eigen::Matrix3f& getRotationMatrix() override;
 
-    void processIMUData(const std::vector<uint8_t>& byteBlock) override;
+    void processIMUData(PacketView byteBlock) override;
 
    private:
     // Calibration constants
@@ -26,6 +26,8 @@ class ImuProcessor1240 : public IImuProcessor
     Eigen::Matrix3f mRotationMatrix;
 
     static constexpr int mDataWidth = 3;
+    static constexpr int mNumImuFields = 20;
+    using ImuVector = Eigen::Matrix<float, mNumImuFields, 1>;  // fixed size so parsing never allocates
     static constexpr int mMagnetometerDataIndex = 11;
     static constexpr int mGyroscopeDataIndex = 14;
     static constexpr int mAccelerometerDataIndex = 17;
@@ -34,8 +36,8 @@ class ImuProcessor1240 : public IImuProcessor
     const float mGyroscopeCalibration = 2000.0f / 32768.0f;
     const Eigen::Vector3f mMagnetometerCalibration{1150.0f / 32768.0f, 1150.0f / 32768.0f, 2250.0f / 32768.0f};
 
-    void calibrateImuData(Eigen::VectorXf& imuData);
-    void setRotationMatrix(Eigen::VectorXf& imuData);
+    void calibrateImuData(ImuVector& imuData);
+    void setRotationMatrix(ImuVector& imuData);
 
     ECompass calculateRotationMatrix;
 };
@@ -5,6 +5,6 @@ class IImuProcessor
 {
    public:
     virtual ~IImuProcessor() {}
-    virtual void processIMUData(const std::vector<uint8_t>& byteBlock) = 0;
+    virtual void processIMUData(PacketView byteBlock) = 0;
     virtual const Eigen::Matrix3f& getRotationMatrix() = 0;
 };
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "packet_generator_1240.h"
+
+#include "firmware_factory.h"
+
+namespace
+{
+constexpr float sampleOffset = 32768.0f;  // firmware 1240 sends samples as unsigned 16 bit
+constexpr float clickFrequencyHz = 30000.0f;  // above the 20 kHz highpass of the shipped filters
+constexpr float clickEnvelopeWidth = 5.0f;  // standard deviation of the click's Gaussian envelope, in samples
+constexpr uint16_t imuFrameSync = 0xAA55;
+constexpr std::array<int16_t, 3> imuMagnetometer = {700, 0, -1200};
+constexpr std::array<int16_t, 3> imuGyroscope = {0, 0, 0};
+constexpr std::array<int16_t, 3> imuAccelerometer = {0, 0, 16384};  // 1 g pointing down: the logger is level
+
+/**
+ * @brief Validates the firmware name before FirmwareFactory, which exits on unknown names, sees it.
+ * @throws std::invalid_argument If the firmware is not a 1240 variant.
+ */
+const std::string& requireFirmware1240(const std::string& firmware)
+{
+    if (firmware != "1240" && firmware != "1240_imu")
+    {
+        throw std::invalid_argument("Packet generator supports firmware 1240 and 1240_imu, not " + firmware);
+    }
+    return firmware;
+}
+}  // namespace
+
+/**
+ * @brief Precomputes the noise table and click waveform of the stream.
+ * @throws std::invalid_argument If the firmware is not a 1240 variant, tdoaSamples does not hold one delay per
+ * channel, or a rate or interval is negative.
+ */
+PacketGenerator1240::PacketGenerator1240(const PacketGeneratorConfig& config)
+    : mFirmware(FirmwareFactory::create(requireFirmware1240(config.firmware))),
+      mNumChannels(mFirmware->numChannels()),
+      mSampleRate(mFirmware->sampleRate()),
+      mMicroIncrement(mFirmware->microIncre()),
+      mSamplesPerChannel(mFirmware->channelSize() / mFirmware->numPacketsToDetect()),
+      mWithImu(mFirmware->imuByteSize() > 0),
+      mPacketSize(mFirmware->packetSize()),
+      mConfig(config),
+      mRandomEngine(config.seed)
+{
+    if (static_cast<int>(config.tdoaSamples.size()) != mNumChannels)
+    {
+        throw std::invalid_argument("tdoaSamples needs one delay per channel");
+    }
+    if (config.clicksPerSecond < 0 || config.noiseAmplitude < 0 || config.timeGlitchEvery < 0 ||
+        config.sizeGlitchEvery < 0 || config.dropEvery < 0 || config.duplicateEvery < 0)
+    {
+        throw std::invalid_argument("Click rate, noise amplitude and glitch intervals must not be negative");
+    }
+
+    const int minDelay = *std::min_element(config.tdoaSamples.begin(), config.tdoaSamples.end());
+    for (int delay : config.tdoaSamples)
+    {
+        mChannelDelays.push_back(delay - minDelay);
+    }
+    mMaxChannelDelay = *std::max_element(mChannelDelays.begin(), mChannelDelays.end());
+
+    std::normal_distribution<float> noise(0.0f, config.noiseAmplitude);
+    mNoiseTable.resize(mNoiseTableSize);
+    for (float& value : mNoiseTable)
+    {
+        value = config.noiseAmplitude > 0 ? noise(mRandomEngine) : 0.0f;
+    }
+
+    const float center = (mClickLength - 1) / 2.0f;
+    for (int n = 0; n < mClickLength; n++)
+    {
+        const float envelope = std::exp(-0.5f * std::pow((n - center) / clickEnvelopeWidth, 2.0f));
+        mClickWaveform[n] = config.clickAmplitude * envelope *
+                            std::sin(2.0f * static_cast<float>(M_PI) * clickFrequencyHz * n / mSampleRate);
+    }
+
+    mSamples.resize(mSamplesPerChannel * mNumChannels);
+    if (config.clicksPerSecond > 0)
+    {
+        mClickInterval = std::exponential_distribution<double>(config.clicksPerSecond / mSampleRate);
+        mNextClickStart = mClickInterval(mRandomEngine);
+    }
+    else
+    {
+        mNextClickStart = std::numeric_limits<double>::infinity();
+    }
+}
+
+/**
+ * @brief True if packetNumber (counted from 1) is a multiple of a non-zero interval.
+ */
+bool PacketGenerator1240::isEvery(int interval, uint64_t packetNumber)
+{
+    return interval > 0 && packetNumber % interval == 0;
+}
+
+/**
+ * @brief Synthesises the next packet of the stream.
+ * @param packet Receives the datagram; resized to packetSize(), or maxPacketSize() for a size glitch.
+ * @return Whether the packet should be sent, dropped or sent twice. A dropped packet still advances the stream.
+ */
+PacketGenerator1240::PacketFate PacketGenerator1240::next(std::vector<uint8_t>& packet)
+{
+    const uint64_t packetNumber = ++mPacketIndex;
+    if (isEvery(mConfig.timeGlitchEvery, packetNumber))
+    {
+        mClockOffset += std::chrono::microseconds(timeGlitchMicroseconds);
+    }
+    const TimePoint packetTime =
+        mConfig.startTime + std::chrono::microseconds(mMicroIncrement) * (packetNumber - 1) + mClockOffset;
+
+    packet.resize(mPacketSize);
+    writeHeader(packet.data(), packetTime);
+    writeSamples(packet.data() + headerSize);
+    if (mWithImu)
+    {
+        writeImu(packet.data() + mPacketSize - mImuByteSize, packet.data());
+    }
+    if (isEvery(mConfig.sizeGlitchEvery, packetNumber))
+    {
+        packet.resize(mPacketSize + sizeGlitchBytes);
+        std::memcpy(packet.data() + mPacketSize, packet.data(), sizeGlitchBytes);
+    }
+
+    if (isEvery(mConfig.dropEvery, packetNumber))
+    {
+        return PacketFate::Drop;
+    }
+    if (isEvery(mConfig.duplicateEvery, packetNumber))
+    {
+        return PacketFate::Duplicate;
+    }
+    return PacketFate::Send;
+}
+
+/**
+ * @brief Writes the 12 byte firmware 1240 header: local date and time, then big-endian microseconds.
+ *
+ * Local time is used because Firmware1240::generateTimestamp decodes the header with mktime.
+ */
+void PacketGenerator1240::writeHeader(uint8_t* header, TimePoint packetTime)
+{
+    const auto wholeSeconds = std::chrono::floor<std::chrono::seconds>(packetTime);
+    const uint32_t microseconds =
+        static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(packetTime - wholeSeconds).count());
+    const std::time_t seconds = std::chrono::system_clock::to_time_t(wholeSeconds);
+    std::tm timeStruct{};
+    localtime_r(&seconds, &timeStruct);
+
+    header[0] = static_cast<uint8_t>(timeStruct.tm_year + 1900 - 2000);
+    header[1] = static_cast<uint8_t>(timeStruct.tm_mon + 1);
+    header[2] = static_cast<uint8_t>(timeStruct.tm_mday);
+    header[3] = static_cast<uint8_t>(timeStruct.tm_hour);
+    header[4] = static_cast<uint8_t>(timeStruct.tm_min);
+    header[5] = static_cast<uint8_t>(timeStruct.tm_sec);
+    header[6] = static_cast<uint8_t>(microseconds >> 24);
+    header[7] = static_cast<uint8_t>(microseconds >> 16);
+    header[8] = static_cast<uint8_t>(microseconds >> 8);
+    header[9] = static_cast<uint8_t>(microseconds);
+    header[10] = 0;
+    header[11] = 0;
+}
+
+/**
+ * @brief Queues every click that starts before packetEndSample.
+ *
+ * Clicks are spaced at least one click plus the largest channel delay apart so their arrivals never overlap.
+ */
+void PacketGenerator1240::scheduleClicks(uint64_t packetEndSample)
+{
+    const double minSpacing = mClickLength + mMaxChannelDelay;
+    while (mNextClickStart < static_cast<double>(packetEndSample))
+    {
+        mClickStarts.push_back(static_cast<uint64_t>(mNextClickStart));
+        mNextClickStart += std::max(minSpacing, mClickInterval(mRandomEngine));
+    }
+}
+
+/**
+ * @brief Writes the packet's interleaved samples: noise plus every click arrival overlapping the packet.
+ */
+void PacketGenerator1240::writeSamples(uint8_t* payload)
+{
+    const uint64_t packetStartSample = (mPacketIndex - 1) * mSamplesPerChannel;
+    const uint64_t packetEndSample = packetStartSample + mSamplesPerChannel;
+
+    for (int channel = 0; channel < mNumChannels; channel++)
+    {
+        // Channels read the table at distant offsets so their noise is not visibly correlated
+        const size_t noiseStart = packetStartSample + static_cast<size_t>(channel) * (mNoiseTableSize / mNumChannels);
+        for (int sample = 0; sample < mSamplesPerChannel; sample++)
+        {
+            mSamples[sample * mNumChannels + channel] = mNoiseTable[(noiseStart + sample) & (mNoiseTableSize - 1)];
+        }
+    }
+
+    scheduleClicks(packetEndSample);
+    for (uint64_t clickStart : mClickStarts)
+    {
+        for (int channel = 0; channel < mNumChannels; channel++)
+        {
+            const uint64_t onset = clickStart + mChannelDelays[channel];
+            const uint64_t first = std::max(onset, packetStartSample);
+            const uint64_t last = std::min(onset + mClickLength, packetEndSample);
+            for (uint64_t sample = first; sample < last; sample++)
+            {
+                mSamples[(sample - packetStartSample) * mNumChannels + channel] += mClickWaveform[sample - onset];
+            }
+        }
+    }
+    while (!mClickStarts.empty() && mClickStarts.front() + mMaxChannelDelay + mClickLength <= packetEndSample)
+    {
+        mClickStarts.pop_front();
+    }
+
+    for (size_t i = 0; i < mSamples.size(); i++)
+    {
+        const float value = std::clamp(std::round(mSamples[i] + sampleOffset), 0.0f, 65535.0f);
+        const uint16_t encoded = static_cast<uint16_t>(value);
+        payload[2 * i] = static_cast<uint8_t>(encoded >> 8);
+        payload[2 * i + 1] = static_cast<uint8_t>(encoded);
+    }
+}
+
+/**
+ * @brief Writes a stationary, level IMU record in the layout ImuProcessor1240 parses (host byte order).
+ */
+void PacketGenerator1240::writeImu(uint8_t* imu, const uint8_t* header) const
+{
+    const uint32_t microseconds = (static_cast<uint32_t>(header[6]) << 24) | (static_cast<uint32_t>(header[7]) << 16) |
+                                  (static_cast<uint32_t>(header[8]) << 8) | header[9];
+    const uint16_t milliseconds = static_cast<uint16_t>(microseconds / 1000);
+    const uint16_t counter = static_cast<uint16_t>(mPacketIndex);
+
+    std::memset(imu, 0, mImuByteSize);
+    imu[0] = 'I';
+    imu[1] = 'M';
+    std::memcpy(imu + 2, &imuFrameSync, sizeof(imuFrameSync));
+    std::memcpy(imu + 4, header, 6);
+    std::memcpy(imu + 10, &milliseconds, sizeof(milliseconds));
+    std::memcpy(imu + 12, &counter, sizeof(counter));
+    std::memcpy(imu + 14, imuMagnetometer.data(), sizeof(imuMagnetometer));
+    std::memcpy(imu + 20, imuGyroscope.data(), sizeof(imuGyroscope));
+    std::memcpy(imu + 26, imuAccelerometer.data(), sizeof(imuAccelerometer));
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../pch.h"
+#include "firmware_interface.h"
+
+/**
+ * @brief Settings of a synthetic firmware 1240 packet stream.
+ *
+ * Glitch intervals count packets; 0 disables the glitch. The glitches mirror the ones datalogger_simulator.py can
+ * inject, but repeat every N packets instead of happening once.
+ */
+struct PacketGeneratorConfig
+{
+    std::string firmware = "1240";  ///< "1240" or "1240_imu".
+    TimePoint startTime = std::chrono::system_clock::now();  ///< Timestamp of the first packet.
+    double clicksPerSecond = 10.0;  ///< Mean click rate; clicks arrive as a Poisson process.
+    float clickAmplitude = 4000.0f;  ///< Peak click amplitude in ADC counts.
+    float noiseAmplitude = 100.0f;  ///< Standard deviation of the background noise in ADC counts.
+    std::vector<int> tdoaSamples = {0, 0, 0, 0};  ///< Arrival delay of each channel relative to channel 0, in samples.
+    int timeGlitchEvery = 0;  ///< Every N packets the clock jumps forward by timeGlitchMicroseconds.
+    int sizeGlitchEvery = 0;  ///< Every N packets sizeGlitchBytes of the packet are duplicated onto its end.
+    int dropEvery = 0;  ///< Every N packets the packet is lost in transit.
+    int duplicateEvery = 0;  ///< Every N packets the packet is delivered twice.
+    uint32_t seed = 0;  ///< Seed of the noise and click arrival times.
+};
+
+/**
+ * @class PacketGenerator1240
+ * @brief Synthesises the datagrams a firmware 1240 (or 1240 with IMU) datalogger sends.
+ *
+ * Each packet carries the next 124 samples per channel of Gaussian noise plus band-limited clicks. A click reaches
+ * each channel after that channel's configured delay, so the pipeline's TDOA estimates can be checked against known
+ * values. Timestamps advance by the firmware's packet interval regardless of how fast packets are requested, which
+ * lets a sender compress time to stress the listener. Noise is read from a precomputed table so synthesis costs little
+ * more than the big-endian sample encoding.
+ */
+class PacketGenerator1240
+{
+   public:
+    /// What the sender should do with a synthesised packet.
+    enum class PacketFate
+    {
+        Send,
+        Drop,
+        Duplicate
+    };
+
+    static constexpr int timeGlitchMicroseconds = 103;
+    static constexpr int sizeGlitchBytes = 30;
+    static constexpr int headerSize = 12;
+
+    explicit PacketGenerator1240(const PacketGeneratorConfig& config);
+
+    PacketFate next(std::vector<uint8_t>& packet);
+
+    int packetSize() const { return mPacketSize; }
+    int maxPacketSize() const { return mPacketSize + sizeGlitchBytes; }
+    int microIncrement() const { return mMicroIncrement; }
+    uint64_t packetsGenerated() const { return mPacketIndex; }
+
+    static void writeHeader(uint8_t* header, TimePoint packetTime);
+
+   private:
+    static constexpr int mImuByteSize = 32;
+    static constexpr int mClickLength = 32;
+    static constexpr size_t mNoiseTableSize = 1 << 16;
+
+    void writeSamples(uint8_t* payload);
+    void writeImu(uint8_t* imu, const uint8_t* header) const;
+    void scheduleClicks(uint64_t packetEndSample);
+    static bool isEvery(int interval, uint64_t packetNumber);
+
+    const std::unique_ptr<const IFirmware> mFirmware;
+    const int mNumChannels;
+    const int mSampleRate;
+    const int mMicroIncrement;
+    const int mSamplesPerChannel;
+    const bool mWithImu;
+    const int mPacketSize;
+
+    const PacketGeneratorConfig mConfig;
+    std::vector<int> mChannelDelays;  ///< tdoaSamples shifted so the earliest channel has delay 0.
+    int mMaxChannelDelay = 0;
+
+    std::mt19937 mRandomEngine;
+    std::exponential_distribution<double> mClickInterval;
+    std::vector<float> mNoiseTable;
+    std::array<float, mClickLength> mClickWaveform{};
+    std::vector<float> mSamples;  ///< Interleaved samples of the packet being built.
+
+    std::deque<uint64_t> mClickStarts;  ///< Start samples of clicks still overlapping the current packet.
+    double mNextClickStart = 0;
+    uint64_t mPacketIndex = 0;
+    std::chrono::microseconds mClockOffset{0};  ///< Accumulated time glitches.
+};
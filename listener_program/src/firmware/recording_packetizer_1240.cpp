@@ -0,0 +1,57 @@
+#include "recording_packetizer_1240.h"
+
+#include "packet_generator_1240.h"
+
+namespace
+{
+constexpr int sampleOffset = 32768;  // firmware 1240 sends samples as unsigned 16 bit
+}  // namespace
+
+/**
+ * @param recording Must outlive the packetizer.
+ * @param startTime Timestamp of the first packet.
+ * @throws std::invalid_argument If the recording does not have the firmware's channel count.
+ */
+RecordingPacketizer1240::RecordingPacketizer1240(const NpyRecording& recording, TimePoint startTime)
+    : mRecording(recording),
+      mStartTime(startTime),
+      mSamplesPerChannel(mFirmware.channelSize() / mFirmware.numPacketsToDetect()),
+      mNumPackets(recording.numSamples() / mSamplesPerChannel)
+{
+    if (recording.numChannels() != mFirmware.numChannels())
+    {
+        throw std::invalid_argument(
+            "Recording " + recording.filePath() + " has " + std::to_string(recording.numChannels()) +
+            " channels; firmware 1240 has " + std::to_string(mFirmware.numChannels()));
+    }
+}
+
+/**
+ * @brief Encodes the next packet of the recording.
+ * @param packet Receives packetSize() bytes.
+ * @return False once every whole packet has been encoded, in which case packet is untouched.
+ */
+bool RecordingPacketizer1240::next(std::span<uint8_t> packet)
+{
+    if (mPacketIndex == mNumPackets)
+    {
+        return false;
+    }
+    PacketGenerator1240::writeHeader(
+        packet.data(), mStartTime + std::chrono::microseconds(mFirmware.microIncre()) * mPacketIndex);
+
+    const int numChannels = mFirmware.numChannels();
+    const size_t firstSample = mPacketIndex * mSamplesPerChannel;
+    uint8_t* payload = packet.data() + PacketGenerator1240::headerSize;
+    for (int sample = 0; sample < mSamplesPerChannel; sample++)
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            const auto value = static_cast<uint16_t>(mRecording.sample(firstSample + sample, channel) + sampleOffset);
+            *payload++ = static_cast<uint8_t>(value >> 8);
+            *payload++ = static_cast<uint8_t>(value);
+        }
+    }
+    mPacketIndex++;
+    return true;
+}
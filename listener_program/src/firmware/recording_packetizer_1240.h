@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../io/npy_recording.h"
+#include "../pch.h"
+#include "firmware_1240.h"
+
+/**
+ * @class RecordingPacketizer1240
+ * @brief Cuts a recorded sample matrix into the firmware 1240 datagrams a datalogger would have sent for it.
+ *
+ * Packets are encoded exactly as datalogger_simulator.py sends a recording: samples are offset to unsigned 16 bit,
+ * interleaved by channel and stored big-endian, behind a header whose timestamp starts at startTime and advances by
+ * the firmware's packet interval. Trailing samples that do not fill a packet are left out, as the simulator does.
+ */
+class RecordingPacketizer1240
+{
+   public:
+    RecordingPacketizer1240(const NpyRecording& recording, TimePoint startTime);
+
+    bool next(std::span<uint8_t> packet);
+
+    int packetSize() const { return mFirmware.packetSize(); }
+    uint64_t numPackets() const { return mNumPackets; }
+    uint64_t packetsWritten() const { return mPacketIndex; }
+
+   private:
+    const Firmware1240 mFirmware;
+    const NpyRecording& mRecording;
+    const TimePoint mStartTime;
+    const int mSamplesPerChannel;
+    const uint64_t mNumPackets;
+    uint64_t mPacketIndex = 0;
+};
@@ -0,0 +1,41 @@
+#include "capture_socket_manager.h"
+
+/**
+ * @param socketManager The manager that actually receives the datagrams.
+ * @param captureFilePath File the datagrams are recorded to; it is created or truncated.
+ * @throws std::runtime_error If the capture file cannot be created.
+ */
+CaptureSocketManager::CaptureSocketManager(
+    std::unique_ptr<ISocketManager> socketManager, const std::string& captureFilePath)
+    : mSocketManager(std::move(socketManager)), mCaptureWriter(captureFilePath)
+{
+}
+
+/**
+ * @brief Receives one datagram through the wrapped manager and records it with its arrival time.
+ */
+int CaptureSocketManager::receiveData(int flags, struct sockaddr* addr, socklen_t* addrlen)
+{
+    int bytesReceived = mSocketManager->receiveData(flags, addr, addrlen);
+    if (bytesReceived > 0)
+    {
+        const std::vector<uint8_t>& dataBytes = mSocketManager->getReceivedData();
+        mCaptureWriter.write(PacketView(dataBytes.data(), bytesReceived), mSocketManager->lastArrivalTime());
+    }
+    return bytesReceived;
+}
+
+/**
+ * @brief Receives a batch through the wrapped manager and records each datagram with its arrival time.
+ */
+int CaptureSocketManager::receiveBatch(
+    std::span<const std::span<uint8_t>> buffers, std::span<size_t> lengths, std::span<TimePoint> arrivalTimes,
+    int flags)
+{
+    int packetsReceived = mSocketManager->receiveBatch(buffers, lengths, arrivalTimes, flags);
+    for (int i = 0; i < packetsReceived; i++)
+    {
+        mCaptureWriter.write(PacketView(buffers[i].data(), lengths[i]), arrivalTimes[i]);
+    }
+    return packetsReceived;
+}
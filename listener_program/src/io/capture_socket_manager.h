@@ -0,0 +1,39 @@
+#pragma once
+#include "../pch.h"
+#include "isocket_manager.h"
+#include "packet_capture.h"
+
+/**
+ * @brief Socket manager decorator that records every datagram received by the wrapped manager to a capture file.
+ *
+ * The capture keeps the arrival time of each datagram, so ReplaySocketManager can later reproduce the stream with
+ * its original timing.
+ */
+class CaptureSocketManager : public ISocketManager
+{
+   public:
+    CaptureSocketManager(std::unique_ptr<ISocketManager> socketManager, const std::string& captureFilePath);
+
+    void restartListener() override { mSocketManager->restartListener(); }
+    int getSocket() const override { return mSocketManager->getSocket(); }
+    int getPort() const override { return mSocketManager->getPort(); }
+    std::string getIp() const override { return mSocketManager->getIp(); }
+
+    int receiveData(int flags, struct sockaddr* addr, socklen_t* addrlen) override;
+
+    std::vector<uint8_t>& getReceivedData() override { return mSocketManager->getReceivedData(); }
+    TimePoint lastArrivalTime() const override { return mSocketManager->lastArrivalTime(); }
+    void setReceiveBufferSize(size_t newSize) override { mSocketManager->setReceiveBufferSize(newSize); }
+
+    int receiveBatch(
+        std::span<const std::span<uint8_t>> buffers, std::span<size_t> lengths, std::span<TimePoint> arrivalTimes,
+        int flags) override;
+
+    int getBatchSize() const override { return mSocketManager->getBatchSize(); }
+    bool appliesBackpressure() const override { return mSocketManager->appliesBackpressure(); }
+    uint64_t kernelDrops() const override { return mSocketManager->kernelDrops(); }
+
+   private:
+    std::unique_ptr<ISocketManager> mSocketManager;
+    PacketCaptureWriter mCaptureWriter;
+};
@@ -0,0 +1,172 @@
+#include "detection_log.h"
+
+using namespace DetectionLogFormat;
+
+static_assert(std::endian::native == std::endian::little, "Detection logs are written in host byte order");
+
+namespace
+{
+template <typename T>
+void appendValue(std::string& records, T value)
+{
+    records.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+}  // namespace
+
+/**
+ * @brief Builds the header of a new detection log: the fixed fields, then the column names, padded for alignment.
+ */
+std::string DetectionLogFormat::fileHeader(
+    int numChannels, int numChannelPairs, const std::vector<std::string>& columnNames)
+{
+    std::string joinedNames;
+    for (size_t i = 0; i < columnNames.size(); ++i)
+    {
+        joinedNames += columnNames[i];
+        if (i < columnNames.size() - 1) joinedNames += ",";
+    }
+
+    DetectionLogFileHeader header{
+        magic,
+        version,
+        static_cast<uint32_t>(paddedLength(sizeof(DetectionLogFileHeader) + joinedNames.size())),
+        static_cast<uint32_t>(recordSize(numChannelPairs)),
+        static_cast<uint32_t>(numChannels),
+        static_cast<uint32_t>(numChannelPairs),
+        static_cast<uint32_t>(joinedNames.size())};
+
+    std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes += joinedNames;
+    bytes.resize(header.headerSize, '\0');
+    return bytes;
+}
+
+/**
+ * @brief Appends one fixed-width record to records. tdoas and xCorrAmps must both have one entry per channel pair.
+ */
+void DetectionLogFormat::appendRecord(
+    std::string& records, TimePoint peakTime, float amplitude, float doaX, float doaY, float doaZ,
+    std::span<const float> tdoas, std::span<const float> xCorrAmps, std::chrono::microseconds latency)
+{
+    const size_t recordStart = records.size();
+    appendValue(records, std::chrono::duration_cast<std::chrono::microseconds>(peakTime.time_since_epoch()).count());
+    appendValue(records, amplitude);
+    appendValue(records, doaX);
+    appendValue(records, doaY);
+    appendValue(records, doaZ);
+    records.append(reinterpret_cast<const char*>(tdoas.data()), tdoas.size_bytes());
+    records.append(reinterpret_cast<const char*>(xCorrAmps.data()), xCorrAmps.size_bytes());
+    appendValue(records, static_cast<int32_t>(latency.count()));
+    records.resize(recordStart + recordSize(tdoas.size()), '\0');
+}
+
+/**
+ * @brief Maps the log and checks its header.
+ * @throws std::runtime_error If the file cannot be opened or mapped, or is not a detection log of a known version.
+ */
+DetectionLogReader::DetectionLogReader(const std::string& filePath) : mFilePath(filePath)
+{
+    mFileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (mFileDescriptor == -1)
+    {
+        throw std::runtime_error("Unable to open detection log " + filePath + ": " + strerror(errno) + "\n");
+    }
+
+    struct stat fileStatus;
+    if (fstat(mFileDescriptor, &fileStatus) == -1 ||
+        static_cast<size_t>(fileStatus.st_size) < sizeof(DetectionLogFileHeader))
+    {
+        close(mFileDescriptor);
+        throw std::runtime_error("Detection log " + filePath + " is too short to be a detection log\n");
+    }
+    mFileSize = static_cast<size_t>(fileStatus.st_size);
+
+    void* mapping = mmap(nullptr, mFileSize, PROT_READ, MAP_PRIVATE, mFileDescriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close(mFileDescriptor);
+        throw std::runtime_error("Unable to map detection log " + filePath + ": " + strerror(errno) + "\n");
+    }
+    mMapping = static_cast<const uint8_t*>(mapping);
+
+    std::memcpy(&mHeader, mMapping, sizeof(mHeader));
+    if (mHeader.magic != magic || mHeader.version != version || mHeader.headerSize > mFileSize ||
+        mHeader.recordSize != recordSize(mHeader.numChannelPairs) ||
+        sizeof(mHeader) + mHeader.columnNamesLength > mHeader.headerSize)
+    {
+        munmap(mapping, mFileSize);
+        close(mFileDescriptor);
+        throw std::runtime_error("File " + filePath + " is not a supported detection log\n");
+    }
+    mNumRecords = (mFileSize - mHeader.headerSize) / mHeader.recordSize;
+
+    std::stringstream joinedNames(
+        std::string(reinterpret_cast<const char*>(mMapping + sizeof(mHeader)), mHeader.columnNamesLength));
+    for (std::string name; std::getline(joinedNames, name, ',');)
+    {
+        mColumnNames.push_back(name);
+    }
+}
+
+DetectionLogReader::~DetectionLogReader()
+{
+    munmap(const_cast<uint8_t*>(mMapping), mFileSize);
+    close(mFileDescriptor);
+}
+
+/**
+ * @brief Returns the detection at index, which must be below size().
+ */
+DetectionLogRecord DetectionLogReader::record(size_t index) const
+{
+    const uint8_t* recordStart = mMapping + mHeader.headerSize + index * mHeader.recordSize;
+    const size_t numPairs = mHeader.numChannelPairs;
+
+    int64_t peakTimeUs;
+    float scalars[4];
+    int32_t latencyUs;
+    std::memcpy(&peakTimeUs, recordStart, sizeof(peakTimeUs));
+    std::memcpy(scalars, recordStart + sizeof(peakTimeUs), sizeof(scalars));
+    const auto* pairValues = reinterpret_cast<const float*>(recordStart + sizeof(peakTimeUs) + sizeof(scalars));
+    std::memcpy(&latencyUs, pairValues + 2 * numPairs, sizeof(latencyUs));
+
+    return DetectionLogRecord{
+        TimePoint(std::chrono::duration_cast<TimePoint::duration>(std::chrono::microseconds(peakTimeUs))),
+        scalars[0],
+        scalars[1],
+        scalars[2],
+        scalars[3],
+        std::span<const float>(pairValues, numPairs),
+        std::span<const float>(pairValues + numPairs, numPairs),
+        std::chrono::microseconds(latencyUs)};
+}
+
+/**
+ * @brief Writes the log as the equivalent CSV detection file.
+ */
+void DetectionLogReader::writeCsv(std::ostream& output) const
+{
+    for (size_t i = 0; i < mColumnNames.size(); ++i)
+    {
+        output << mColumnNames[i];
+        if (i < mColumnNames.size() - 1) output << ",";
+    }
+    output << "\n" << std::fixed << std::setprecision(6);
+
+    for (size_t i = 0; i < mNumRecords; ++i)
+    {
+        DetectionLogRecord detection = record(i);
+        output << std::chrono::duration_cast<std::chrono::microseconds>(detection.peakTime.time_since_epoch()).count()
+               << "," << detection.amplitude << "," << detection.doaX << "," << detection.doaY << ","
+               << detection.doaZ;
+        for (float tdoa : detection.tdoas)
+        {
+            output << "," << tdoa;
+        }
+        for (float xCorrAmp : detection.xCorrAmps)
+        {
+            output << "," << xCorrAmp;
+        }
+        output << "," << detection.latency.count() << "\n";
+    }
+}
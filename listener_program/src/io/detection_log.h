@@ -0,0 +1,92 @@
+#pragma once
+#include "../pch.h"
+
+/**
+ * @brief On-disk layout of a binary detection log, the compact alternative to the CSV detection file.
+ *
+ * A log starts with a DetectionLogFileHeader, followed by the CSV column names (comma separated) and zero padding up
+ * to headerSize bytes. Then come fixed-width records of recordSize bytes each, one per detection:
+ *
+ *     int64 peak time (µs since epoch) | float32 amplitude | float32 DOA x, y, z | float32 TDOA[numChannelPairs] |
+ *     float32 XCorr[numChannelPairs] | int32 latency (µs) | zero padding to a multiple of 8 bytes
+ *
+ * Everything is little-endian, and both headerSize and recordSize are multiples of 8, so the records can be mapped
+ * straight into a structured array (see analysis/detection_log.py).
+ */
+namespace DetectionLogFormat
+{
+inline constexpr std::array<char, 8> magic = {'F', 'W', 'D', 'L', 'O', 'G', '0', '1'};
+inline constexpr uint32_t version = 1;
+inline constexpr size_t alignment = 8;
+
+struct DetectionLogFileHeader
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t headerSize;  ///< Bytes before the first record, including the column names.
+    uint32_t recordSize;
+    uint32_t numChannels;
+    uint32_t numChannelPairs;
+    uint32_t columnNamesLength;  ///< Bytes of column names following this header.
+};
+
+inline size_t paddedLength(size_t length) { return (length + alignment - 1) & ~(alignment - 1); }
+
+inline size_t recordSize(size_t numChannelPairs)
+{
+    return paddedLength(sizeof(int64_t) + 4 * sizeof(float) + 2 * numChannelPairs * sizeof(float) + sizeof(int32_t));
+}
+
+std::string fileHeader(int numChannels, int numChannelPairs, const std::vector<std::string>& columnNames);
+
+void appendRecord(
+    std::string& records, TimePoint peakTime, float amplitude, float doaX, float doaY, float doaZ,
+    std::span<const float> tdoas, std::span<const float> xCorrAmps, std::chrono::microseconds latency);
+}  // namespace DetectionLogFormat
+
+/**
+ * @brief One detection of a binary detection log. The TDOA and XCorr views point into the reader's mapping.
+ */
+struct DetectionLogRecord
+{
+    TimePoint peakTime;
+    float amplitude;
+    float doaX;
+    float doaY;
+    float doaZ;
+    std::span<const float> tdoas;
+    std::span<const float> xCorrAmps;
+    std::chrono::microseconds latency;
+};
+
+/**
+ * @class DetectionLogReader
+ * @brief Gives random access to the records of a binary detection log through a read-only memory mapping.
+ */
+class DetectionLogReader
+{
+   public:
+    explicit DetectionLogReader(const std::string& filePath);
+    ~DetectionLogReader();
+
+    DetectionLogReader(const DetectionLogReader&) = delete;
+    DetectionLogReader& operator=(const DetectionLogReader&) = delete;
+
+    size_t size() const { return mNumRecords; }
+    int numChannels() const { return static_cast<int>(mHeader.numChannels); }
+    int numChannelPairs() const { return static_cast<int>(mHeader.numChannelPairs); }
+    const std::vector<std::string>& columnNames() const { return mColumnNames; }
+
+    DetectionLogRecord record(size_t index) const;
+
+    void writeCsv(std::ostream& output) const;
+
+   private:
+    std::string mFilePath;
+    int mFileDescriptor = -1;
+    const uint8_t* mMapping = nullptr;
+    size_t mFileSize = 0;
+    DetectionLogFormat::DetectionLogFileHeader mHeader;
+    std::vector<std::string> mColumnNames;
+    size_t mNumRecords = 0;  ///< Whole records in the file; a partly written last record is ignored.
+};
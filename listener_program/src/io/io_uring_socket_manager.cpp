@@ -0,0 +1,224 @@
+#include "io_uring_socket_manager.h"
+
+#ifdef HAVE_LIBURING
+
+/**
+ * @brief Creates the socket (via UdpSocketManager) and the io_uring instance with its provided-buffer ring.
+ * @throws std::runtime_error If io_uring cannot be initialised, e.g. on kernels older than 6.0.
+ */
+IoUringSocketManager::IoUringSocketManager(const SocketVariables& socketVariables)
+    : UdpSocketManager(socketVariables),
+      mMessageTemplate{},
+      mProvidedBufferSize(
+          sizeof(struct io_uring_recvmsg_out) + mControlSize + mMaxDatagramSize),
+      mProvidedBuffers(mProvidedBufferSize * mNumProvidedBuffers),
+      mCompletions(getBatchSize())
+{
+    mMessageTemplate.msg_namelen = 0;
+    mMessageTemplate.msg_controllen = mControlSize;
+    setupRing();
+}
+
+IoUringSocketManager::~IoUringSocketManager() { teardownRing(); }
+
+/**
+ * @brief Creates the io_uring instance and hands every provided buffer to the kernel.
+ * @throws std::runtime_error If the ring or the buffer ring cannot be created.
+ */
+void IoUringSocketManager::setupRing()
+{
+    // Size the completion queue for a full buffer ring so a burst cannot overflow it and end the multishot request
+    struct io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = mNumProvidedBuffers;
+    int result = io_uring_queue_init_params(8, &mRing, &params);
+    if (result < 0)
+    {
+        throw std::runtime_error("Error initializing io_uring: " + std::string(strerror(-result)) + "\n");
+    }
+    mRingInitialized = true;
+
+    int error = 0;
+    mBufferRing = io_uring_setup_buf_ring(&mRing, mNumProvidedBuffers, mBufferGroupId, 0, &error);
+    if (mBufferRing == nullptr)
+    {
+        teardownRing();
+        throw std::runtime_error("Error registering io_uring buffer ring: " + std::string(strerror(-error)) + "\n");
+    }
+
+    for (unsigned bufferId = 0; bufferId < mNumProvidedBuffers; bufferId++)
+    {
+        recycleBuffer(static_cast<unsigned short>(bufferId), static_cast<int>(bufferId));
+    }
+    io_uring_buf_ring_advance(mBufferRing, mNumProvidedBuffers);
+    mReceiveArmed = false;
+}
+
+/**
+ * @brief Cancels any outstanding receive and releases the ring and its buffers.
+ */
+void IoUringSocketManager::teardownRing()
+{
+    if (!mRingInitialized)
+    {
+        return;
+    }
+    if (mBufferRing != nullptr)
+    {
+        io_uring_free_buf_ring(&mRing, mBufferRing, mNumProvidedBuffers, mBufferGroupId);
+        mBufferRing = nullptr;
+    }
+    io_uring_queue_exit(&mRing);
+    mRingInitialized = false;
+    mReceiveArmed = false;
+}
+
+/**
+ * @brief Recreates the socket and the ring; the old multishot request would otherwise keep the old socket alive.
+ */
+void IoUringSocketManager::restartListener()
+{
+    teardownRing();
+    UdpSocketManager::restartListener();
+    setupRing();
+}
+
+/**
+ * @brief Queues the provided buffer bufferId at position ringOffset past the current buffer ring tail.
+ */
+void IoUringSocketManager::recycleBuffer(unsigned short bufferId, int ringOffset)
+{
+    io_uring_buf_ring_add(
+        mBufferRing, mProvidedBuffers.data() + static_cast<size_t>(bufferId) * mProvidedBufferSize,
+        static_cast<unsigned>(mProvidedBufferSize), bufferId, io_uring_buf_ring_mask(mNumProvidedBuffers), ringOffset);
+}
+
+/**
+ * @brief Submits a multishot recvmsg that keeps filling provided buffers until it is cancelled or runs out of them.
+ * @throws std::runtime_error If no submission queue entry is available.
+ */
+void IoUringSocketManager::armMultishotReceive()
+{
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&mRing);
+    if (sqe == nullptr)
+    {
+        throw std::runtime_error("io_uring submission queue is full\n");
+    }
+    io_uring_prep_recvmsg_multishot(sqe, getSocket(), &mMessageTemplate, 0);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = mBufferGroupId;
+    io_uring_submit(&mRing);
+    mReceiveArmed = true;
+}
+
+/**
+ * @brief Reaps up to min(buffers.size(), getBatchSize()) received datagrams from the completion queue.
+ *
+ * Blocks until at least one completion is available, or for at most the receive timeout. Each datagram is copied out
+ * of its provided buffer into the matching caller buffer (typically a free slot of the shared packet ring) and the
+ * provided buffer is immediately returned to the kernel. If the kernel ran out of provided buffers the multishot
+ * request is re-armed on the next call.
+ *
+ * @param buffers Destination buffers, one per datagram.
+ * @param lengths Receives the number of bytes written into each buffer.
+ * @param arrivalTimes Receives the kernel arrival time of each datagram, or the reap time if none was attached.
+ * @param flags Unused; io_uring completions are always reaped in blocking mode.
+ * @return Number of datagrams received, 0 if none arrived within the receive timeout, or -1 on error.
+ */
+int IoUringSocketManager::receiveBatch(
+    std::span<const std::span<uint8_t>> buffers, std::span<size_t> lengths, std::span<TimePoint> arrivalTimes,
+    [[maybe_unused]] int flags)
+{
+    const unsigned maxPackets = static_cast<unsigned>(std::min<size_t>(buffers.size(), mCompletions.size()));
+
+    if (!mReceiveArmed)
+    {
+        armMultishotReceive();
+    }
+
+    // The multishot request ignores SO_RCVTIMEO, so the wait itself is bounded
+    struct __kernel_timespec timeout{};
+    timeout.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(mReceiveTimeout).count();
+    struct io_uring_cqe* firstCompletion = nullptr;
+    int result = io_uring_wait_cqe_timeout(&mRing, &firstCompletion, &timeout);
+    if (result == -ETIME)
+    {
+        return 0;
+    }
+    if (result < 0)
+    {
+        return -1;
+    }
+
+    const unsigned numCompletions = io_uring_peek_batch_cqe(&mRing, mCompletions.data(), maxPackets);
+    const TimePoint reapTime = std::chrono::system_clock::now();
+
+    int packetsReceived = 0;
+    int buffersRecycled = 0;
+    bool receiveFailed = false;
+    for (unsigned i = 0; i < numCompletions; i++)
+    {
+        struct io_uring_cqe* cqe = mCompletions[i];
+        if (!(cqe->flags & IORING_CQE_F_MORE))
+        {
+            mReceiveArmed = false;  // the multishot request has terminated and must be resubmitted
+        }
+
+        if (cqe->res < 0)
+        {
+            // Running out of provided buffers is recoverable by re-arming; anything else is a socket error
+            receiveFailed = receiveFailed || (cqe->res != -ENOBUFS);
+            continue;
+        }
+        if (!(cqe->flags & IORING_CQE_F_BUFFER))
+        {
+            continue;
+        }
+
+        const auto bufferId = static_cast<unsigned short>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        uint8_t* providedBuffer = mProvidedBuffers.data() + static_cast<size_t>(bufferId) * mProvidedBufferSize;
+
+        struct io_uring_recvmsg_out* message = io_uring_recvmsg_validate(providedBuffer, cqe->res, &mMessageTemplate);
+        if (message != nullptr)
+        {
+            const size_t payloadLength = std::min<size_t>(
+                io_uring_recvmsg_payload_length(message, cqe->res, &mMessageTemplate), buffers[packetsReceived].size());
+            std::memcpy(
+                buffers[packetsReceived].data(), io_uring_recvmsg_payload(message, &mMessageTemplate), payloadLength);
+            lengths[packetsReceived] = payloadLength;
+            arrivalTimes[packetsReceived] = reapTime;
+
+            for (struct cmsghdr* cmsg = io_uring_recvmsg_cmsg_firsthdr(message, &mMessageTemplate); cmsg != nullptr;
+                 cmsg = io_uring_recvmsg_cmsg_nexthdr(message, &mMessageTemplate, cmsg))
+            {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+                {
+                    struct timespec kernelTime;
+                    std::memcpy(&kernelTime, CMSG_DATA(cmsg), sizeof(kernelTime));
+                    arrivalTimes[packetsReceived] = TimePoint(std::chrono::duration_cast<TimePoint::duration>(
+                        std::chrono::seconds(kernelTime.tv_sec) + std::chrono::nanoseconds(kernelTime.tv_nsec)));
+                }
+                else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+                {
+                    uint32_t dropCount;
+                    std::memcpy(&dropCount, CMSG_DATA(cmsg), sizeof(dropCount));
+                    recordDropCount(dropCount);
+                }
+            }
+            packetsReceived++;
+        }
+
+        recycleBuffer(bufferId, buffersRecycled++);
+    }
+
+    io_uring_buf_ring_advance(mBufferRing, buffersRecycled);
+    io_uring_cq_advance(&mRing, numCompletions);
+
+    if (packetsReceived == 0 && receiveFailed)
+    {
+        return -1;
+    }
+    return packetsReceived;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+#include "../pch.h"
+#include "udp_socket_manager.h"
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+
+/**
+ * @brief UDP socket manager that receives through io_uring instead of one recvmmsg call per batch.
+ *
+ * A single multishot recvmsg request stays armed on the socket. The kernel places each datagram, together with its
+ * SO_TIMESTAMPNS and SO_RXQ_OVFL control messages, into the next buffer of a preallocated provided-buffer ring and
+ * posts a completion, so steady-state receiving needs no system call per packet: receiveBatch only reaps completions
+ * already in shared memory and blocks in the kernel when none are pending. Socket creation, binding and the
+ * single-packet path are inherited from UdpSocketManager.
+ */
+class IoUringSocketManager : public UdpSocketManager
+{
+   public:
+    explicit IoUringSocketManager(const SocketVariables& socketVariables);
+    ~IoUringSocketManager() override;
+
+    IoUringSocketManager(const IoUringSocketManager&) = delete;
+    IoUringSocketManager& operator=(const IoUringSocketManager&) = delete;
+
+    void restartListener() override;
+
+    int receiveBatch(
+        std::span<const std::span<uint8_t>> buffers, std::span<size_t> lengths, std::span<TimePoint> arrivalTimes,
+        int flags) override;
+
+   private:
+    static constexpr unsigned mNumProvidedBuffers = 256;  ///< Must be a power of two.
+    static constexpr int mBufferGroupId = 0;
+    static constexpr size_t mMaxDatagramSize = 2048;
+
+    void setupRing();
+    void teardownRing();
+    void armMultishotReceive();
+    void recycleBuffer(unsigned short bufferId, int ringOffset);
+
+    struct io_uring mRing;
+    struct io_uring_buf_ring* mBufferRing = nullptr;
+    bool mRingInitialized = false;
+    bool mReceiveArmed = false;  ///< Whether a multishot request is currently outstanding.
+
+    struct msghdr mMessageTemplate;  ///< Tells the kernel how much name/control space each provided buffer reserves.
+    size_t mProvidedBufferSize;  ///< recvmsg header + control message space + largest datagram.
+    std::vector<uint8_t> mProvidedBuffers;  ///< Backing storage for all provided buffers.
+    std::vector<struct io_uring_cqe*> mCompletions;  ///< Scratch space for reaped completions.
+};
+#endif
@@ -14,5 +14,29 @@ class ISocketManager
     virtual int receiveData(int flags, struct sockaddr* addr, socklen_t* addrlen) = 0;
 
     virtual std::vector<uint8_t>& getReceivedData() = 0;
+
+    /**
+     * @brief When the datagram last returned by receiveData arrived: the kernel timestamp if the source has one,
+     * otherwise the time it was read.
+     */
+    virtual TimePoint lastArrivalTime() const = 0;
     virtual void setReceiveBufferSize(size_t newSize) = 0;
-};
\ No newline at end of file
+
+    virtual int receiveBatch(
+        std::span<const std::span<uint8_t>> buffers, std::span<size_t> lengths, std::span<TimePoint> arrivalTimes,
+        int flags) = 0;
+
+    virtual int getBatchSize() const = 0;
+
+    /**
+     * @brief True if the source holds packets back until they are requested (e.g. a capture replay), so a full packet
+     * queue should be waited out rather than treated as an overflow.
+     */
+    virtual bool appliesBackpressure() const = 0;
+
+    /**
+     * @brief Datagrams the kernel dropped since the last restartListener because the socket's receive buffer was
+     * full, e.g. while the listener waited for a free slot; 0 if the source cannot drop or the count is unavailable.
+     */
+    virtual uint64_t kernelDrops() const = 0;
+};
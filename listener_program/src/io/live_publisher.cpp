@@ -0,0 +1,116 @@
+#include "live_publisher.h"
+
+#include "detection_log.h"
+
+using namespace LiveMessageFormat;
+
+static_assert(std::endian::native == std::endian::little, "Live messages are sent in host byte order");
+
+/**
+ * @brief Opens a non-blocking datagram socket towards address ("udp:<ip>:<port>" or "unix:<socket path>").
+ * @throws std::invalid_argument If the address is malformed.
+ * @throws std::runtime_error If the socket cannot be created.
+ */
+LivePublisher::LivePublisher(const std::string& address) : mAddress(address)
+{
+    int family = AF_UNSPEC;
+    if (address.starts_with("udp:"))
+    {
+        const size_t portSeparator = address.rfind(':');
+        sockaddr_in destination{};
+        destination.sin_family = AF_INET;
+        std::string ip = address.substr(4, portSeparator - 4);
+        int port = 0;
+        auto [end, error] =
+            std::from_chars(address.data() + portSeparator + 1, address.data() + address.size(), port);
+        if (portSeparator < 4 || inet_pton(AF_INET, ip.c_str(), &destination.sin_addr) != 1 ||
+            error != std::errc() || end != address.data() + address.size() || port <= 0 || port > 65535)
+        {
+            throw std::invalid_argument("Malformed liveOutputAddress: " + address);
+        }
+        destination.sin_port = htons(static_cast<uint16_t>(port));
+        std::memcpy(&mDestination, &destination, sizeof(destination));
+        mDestinationLength = sizeof(destination);
+        family = AF_INET;
+    }
+    else if (address.starts_with("unix:"))
+    {
+        sockaddr_un destination{};
+        destination.sun_family = AF_UNIX;
+        const std::string path = address.substr(5);
+        if (path.empty() || path.size() >= sizeof(destination.sun_path))
+        {
+            throw std::invalid_argument("Malformed liveOutputAddress: " + address);
+        }
+        std::memcpy(destination.sun_path, path.c_str(), path.size() + 1);
+        std::memcpy(&mDestination, &destination, sizeof(destination));
+        mDestinationLength = sizeof(destination);
+        family = AF_UNIX;
+    }
+    else
+    {
+        throw std::invalid_argument("liveOutputAddress must start with udp: or unix:, got " + address);
+    }
+
+    mSocket = socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (mSocket == -1)
+    {
+        throw std::runtime_error("Unable to create live output socket: " + std::string(strerror(errno)) + "\n");
+    }
+    std::cout << "Publishing detections and track updates to " << address << std::endl;
+}
+
+LivePublisher::~LivePublisher() { close(mSocket); }
+
+/**
+ * @brief Sends a detection message. tdoas and xCorrAmps must both have one entry per channel pair.
+ */
+void LivePublisher::publishDetection(
+    float amplitude, float doaX, float doaY, float doaZ, std::span<const float> tdoas,
+    std::span<const float> xCorrAmps, const TimePoint& peakTime, std::chrono::microseconds latency)
+{
+    DetectionMessageHeader header{MessageType::Detection, static_cast<uint32_t>(tdoas.size())};
+    mDetectionMessage.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+    DetectionLogFormat::appendRecord(
+        mDetectionMessage, peakTime, amplitude, doaX, doaY, doaZ, tdoas, xCorrAmps, latency);
+    send(mDetectionMessage);
+}
+
+/**
+ * @brief Sends a track update message.
+ */
+void LivePublisher::publishTrackUpdate(int trackId, const TimePoint& time, double elevation, double azimuth)
+{
+    TrackUpdateMessage message{
+        MessageType::TrackUpdate, trackId,
+        std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count(), elevation, azimuth};
+    send(std::string_view(reinterpret_cast<const char*>(&message), sizeof(message)));
+}
+
+/**
+ * @brief One-line summary of the messages sent and dropped so far.
+ */
+std::string LivePublisher::summary() const
+{
+    std::stringstream summary;
+    summary << "to " << mAddress << " sent: " << sent() << " dropped: " << dropped();
+    return summary.str();
+}
+
+/**
+ * @brief Sends one datagram without blocking, counting it as dropped if the socket does not take it whole.
+ */
+void LivePublisher::send(std::string_view message)
+{
+    ssize_t sentBytes = sendto(
+        mSocket, message.data(), message.size(), MSG_DONTWAIT | MSG_NOSIGNAL,
+        reinterpret_cast<const sockaddr*>(&mDestination), mDestinationLength);
+    if (sentBytes == static_cast<ssize_t>(message.size()))
+    {
+        mSent.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
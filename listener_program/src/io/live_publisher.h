@@ -0,0 +1,73 @@
+#pragma once
+#include "../pch.h"
+
+/**
+ * @brief Layout of the datagrams sent by LivePublisher. Every field is little-endian.
+ *
+ * Each datagram starts with a uint32 MessageType. A detection message continues with a uint32 channel pair count and
+ * then one binary detection log record (see DetectionLogFormat). A track update message is a TrackUpdateMessage.
+ */
+namespace LiveMessageFormat
+{
+enum class MessageType : uint32_t
+{
+    Detection = 1,
+    TrackUpdate = 2,
+};
+
+struct DetectionMessageHeader
+{
+    MessageType type;
+    uint32_t numChannelPairs;
+};
+
+struct TrackUpdateMessage
+{
+    MessageType type;
+    int32_t trackId;
+    int64_t timeUs;  ///< Time of the observation that updated the track, in µs since epoch.
+    double elevation;  ///< Updated track elevation, in degrees.
+    double azimuth;  ///< Updated track azimuth, in degrees.
+};
+}  // namespace LiveMessageFormat
+
+/**
+ * @class LivePublisher
+ * @brief Publishes every detection and track update as soon as it is made, as one datagram on a local socket.
+ *
+ * The destination is "udp:<ip>:<port>" or "unix:<socket path>" (a Unix-domain datagram socket). Sends never block:
+ * a message that the socket cannot take right away, or that finds no consumer listening, is dropped and counted, so
+ * a slow or absent consumer never stalls the pipeline. publishDetection and publishTrackUpdate may be called
+ * concurrently with each other, but each from one thread at a time.
+ */
+class LivePublisher
+{
+   public:
+    explicit LivePublisher(const std::string& address);
+    ~LivePublisher();
+
+    LivePublisher(const LivePublisher&) = delete;
+    LivePublisher& operator=(const LivePublisher&) = delete;
+
+    void publishDetection(
+        float amplitude, float doaX, float doaY, float doaZ, std::span<const float> tdoas,
+        std::span<const float> xCorrAmps, const TimePoint& peakTime, std::chrono::microseconds latency);
+    void publishTrackUpdate(int trackId, const TimePoint& time, double elevation, double azimuth);
+
+    uint64_t sent() const { return mSent.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+    std::string summary() const;
+
+   private:
+    void send(std::string_view message);
+
+    std::string mAddress;
+    int mSocket = -1;
+    sockaddr_storage mDestination{};
+    socklen_t mDestinationLength = 0;
+    std::string mDetectionMessage;  ///< Reused across detections, so publishing does not allocate.
+
+    std::atomic<uint64_t> mSent = 0;
+    std::atomic<uint64_t> mDropped = 0;  ///< Messages the socket refused, e.g. because no consumer kept up.
+};
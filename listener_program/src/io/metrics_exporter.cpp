@@ -0,0 +1,264 @@
+#include "metrics_exporter.h"
+
+#include "../stage_tracer.h"
+
+namespace
+{
+constexpr std::chrono::milliseconds pollInterval(200);  ///< How often the exporter thread checks for shutdown.
+
+/**
+ * @brief Appends one metric family: its type line, then one sample per stream.
+ */
+void appendFamily(
+    std::string& text, const std::string& name, const char* type, const std::vector<std::string>& streamNames,
+    const std::function<uint64_t(size_t)>& valueOfStream)
+{
+    text += "# TYPE freewilli_" + name + " " + type + "\n";
+    for (size_t i = 0; i < streamNames.size(); i++)
+    {
+        text += "freewilli_" + name + "{stream=\"" + streamNames[i] + "\"} " + std::to_string(valueOfStream(i)) + "\n";
+    }
+}
+
+/**
+ * @brief Appends the p50, p99 and sample count of one histogram as samples of a summary family.
+ */
+template <typename Histogram>
+void appendSummary(std::string& text, const std::string& name, const std::string& labels, const Histogram& histogram)
+{
+    for (const auto& [quantile, quantileLabel] : {std::pair{0.5, "0.5"}, std::pair{0.99, "0.99"}})
+    {
+        text += "freewilli_" + name + "{" + labels + ",quantile=\"" + quantileLabel + "\"} " +
+                std::to_string(histogram.percentile(quantile).count()) + "\n";
+    }
+    text += "freewilli_" + name + "_count{" + labels + "} " + std::to_string(histogram.count()) + "\n";
+}
+}  // namespace
+
+/**
+ * @param filePath Metrics file to rewrite every interval; empty to disable it.
+ * @param port Local TCP port to serve the metrics on; 0 to disable the endpoint.
+ * @param interval Time between rewrites of the metrics file.
+ * @throws std::runtime_error If the endpoint cannot listen on the port.
+ */
+MetricsExporter::MetricsExporter(const std::string& filePath, int port, std::chrono::seconds interval)
+    : mFilePath(filePath), mInterval(interval)
+{
+    if (port == 0)
+    {
+        return;
+    }
+    mListenSocket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (mListenSocket == -1)
+    {
+        throw std::runtime_error("Unable to create metrics socket: " + std::string(strerror(errno)) + "\n");
+    }
+    const int reuse = 1;
+    setsockopt(mListenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(mListenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1 ||
+        listen(mListenSocket, 4) == -1)
+    {
+        const std::string error = strerror(errno);
+        close(mListenSocket);
+        throw std::runtime_error("Unable to serve metrics on port " + std::to_string(port) + ": " + error + "\n");
+    }
+    std::cout << "Serving metrics on http://127.0.0.1:" << port << "/metrics" << std::endl;
+}
+
+/**
+ * @brief Stops the exporter thread, writing the metrics file one last time.
+ */
+MetricsExporter::~MetricsExporter()
+{
+    mStopping = true;
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+    if (mListenSocket != -1)
+    {
+        close(mListenSocket);
+    }
+}
+
+/**
+ * @brief Exports sharedDataManager's counters under stream="<name>". The manager must outlive the exporter.
+ */
+void MetricsExporter::addStream(const std::string& name, const SharedDataManager& sharedDataManager)
+{
+    mStreams.push_back(Stream{name, &sharedDataManager});
+}
+
+/**
+ * @brief Starts the exporter thread.
+ */
+void MetricsExporter::start() { mThread = std::thread(&MetricsExporter::run, this); }
+
+/**
+ * @brief Formats the current value of every metric in the Prometheus text exposition format.
+ */
+std::string MetricsExporter::render() const
+{
+    std::vector<std::string> streamNames;
+    for (const Stream& stream : mStreams)
+    {
+        streamNames.push_back(stream.name);
+    }
+    auto data = [this](size_t i) -> const SharedDataManager& { return *mStreams[i].sharedDataManager; };
+
+    std::string text;
+    appendFamily(
+        text, "packets_received_total", "counter", streamNames, [&](size_t i) { return data(i).packetsReceived.load(); });
+    appendFamily(
+        text, "packets_lost_total", "counter", streamNames, [&](size_t i) { return data(i).packetsLost.load(); });
+    appendFamily(
+        text, "packets_discarded_total", "counter", streamNames,
+        [&](size_t i) { return data(i).packetsDiscarded.load(); });
+    appendFamily(text, "resyncs_total", "counter", streamNames, [&](size_t i) { return data(i).resyncCounter.load(); });
+    appendFamily(
+        text, "detections_total", "counter", streamNames, [&](size_t i) { return data(i).detectionCounter.load(); });
+    for (size_t counter = 0; counter < static_cast<size_t>(MetricCounter::Count); counter++)
+    {
+        const auto metric = static_cast<MetricCounter>(counter);
+        appendFamily(
+            text, std::string(MetricsRegistry::name(metric)) + "_total", "counter", streamNames,
+            [&](size_t i) { return data(i).metrics.value(metric); });
+    }
+
+    appendFamily(text, "queue_depth", "gauge", streamNames, [&](size_t i) { return data(i).queueSize(); });
+    for (size_t gauge = 0; gauge < static_cast<size_t>(MetricGauge::Count); gauge++)
+    {
+        const auto metric = static_cast<MetricGauge>(gauge);
+        appendFamily(
+            text, MetricsRegistry::name(metric), "gauge", streamNames,
+            [&](size_t i) { return data(i).metrics.value(metric); });
+    }
+
+    text += "# TYPE freewilli_flush_duration_microseconds summary\n";
+    for (size_t i = 0; i < mStreams.size(); i++)
+    {
+        appendSummary(
+            text, "flush_duration_microseconds", "stream=\"" + streamNames[i] + "\"", data(i).metrics.flushDuration());
+    }
+
+#ifdef FREEWILLI_TRACING
+    // Process-wide, and covering only the current report interval, since the tracer is reset after each report
+    text += "# TYPE freewilli_stage_duration_nanoseconds summary\n";
+    for (size_t stage = 0; stage < static_cast<size_t>(TraceStage::Count); stage++)
+    {
+        const auto traceStage = static_cast<TraceStage>(stage);
+        appendSummary(
+            text, "stage_duration_nanoseconds", std::string("stage=\"") + StageTracer::stageName(traceStage) + "\"",
+            StageTracer::instance().histogram(traceStage));
+    }
+#endif
+    return text;
+}
+
+/**
+ * @brief Exporter thread body: rewrites the file every interval and answers HTTP requests in between.
+ */
+void MetricsExporter::run()
+{
+    auto nextWrite = std::chrono::steady_clock::now();
+    while (!mStopping)
+    {
+        if (!mFilePath.empty() && std::chrono::steady_clock::now() >= nextWrite)
+        {
+            writeFile();
+            nextWrite += mInterval;
+        }
+
+        if (mListenSocket == -1)
+        {
+            std::this_thread::sleep_for(pollInterval);
+            continue;
+        }
+        pollfd listener{mListenSocket, POLLIN, 0};
+        if (poll(&listener, 1, static_cast<int>(pollInterval.count())) <= 0)
+        {
+            continue;
+        }
+        int clientSocket = accept4(mListenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientSocket != -1)
+        {
+            serveClient(clientSocket);
+            close(clientSocket);
+        }
+    }
+    if (!mFilePath.empty())
+    {
+        writeFile();
+    }
+}
+
+/**
+ * @brief Replaces the metrics file with the current metrics. Failures are reported and retried next interval.
+ */
+void MetricsExporter::writeFile() const
+{
+    const std::string temporaryPath = mFilePath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        file << render();
+        if (!file)
+        {
+            std::cerr << "Unable to write metrics file " << temporaryPath << std::endl;
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, mFilePath, error);
+    if (error)
+    {
+        std::cerr << "Unable to replace metrics file " << mFilePath << ": " << error.message() << std::endl;
+    }
+}
+
+/**
+ * @brief Answers one HTTP request, whatever its path, with the current metrics.
+ *
+ * The client socket is non-blocking, and a client that has not taken the whole response within pollInterval is
+ * dropped, so a scraper that stops reading cannot hold up the file rewrites or shutdown.
+ */
+void MetricsExporter::serveClient(int clientSocket) const
+{
+    // The request itself is not needed, but reading it lets the client see a clean close
+    pollfd client{clientSocket, POLLIN, 0};
+    std::array<char, 1024> request;
+    if (poll(&client, 1, static_cast<int>(pollInterval.count())) > 0)
+    {
+        [[maybe_unused]] ssize_t ignored = recv(clientSocket, request.data(), request.size(), MSG_DONTWAIT);
+    }
+
+    const std::string body = render();
+    const std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                                 std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    const auto deadline = std::chrono::steady_clock::now() + pollInterval;
+    size_t sentBytes = 0;
+    while (sentBytes < response.size())
+    {
+        ssize_t result = send(clientSocket, response.data() + sentBytes, response.size() - sentBytes, MSG_NOSIGNAL);
+        if (result > 0)
+        {
+            sentBytes += static_cast<size_t>(result);
+            continue;
+        }
+        if (result == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            const auto remaining =
+                std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            pollfd writable{clientSocket, POLLOUT, 0};
+            if (remaining.count() > 0 && poll(&writable, 1, static_cast<int>(remaining.count())) > 0)
+            {
+                continue;
+            }
+        }
+        return;  // the client went away or stopped reading; it can scrape again
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "../pch.h"
+#include "../shared_data_manager.h"
+
+/**
+ * @class MetricsExporter
+ * @brief Exposes every stream's counters in the Prometheus text format, as a file and over HTTP.
+ *
+ * A background thread rewrites the metrics file once per interval, atomically by renaming a temporary file so a
+ * reader (e.g. node_exporter's textfile collector) never sees a partial one, and answers HTTP requests on
+ * 127.0.0.1:<port> with the current metrics. Each stream's metrics are labelled stream="<name>". The per-stage
+ * processing times are included in tracing builds (see StageTracer).
+ *
+ * Streams must be added before start(). The exporter only reads the streams' atomics, so it never holds up the
+ * pipeline.
+ */
+class MetricsExporter
+{
+   public:
+    MetricsExporter(const std::string& filePath, int port, std::chrono::seconds interval);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    void addStream(const std::string& name, const SharedDataManager& sharedDataManager);
+
+    void start();
+
+    std::string render() const;
+
+   private:
+    struct Stream
+    {
+        std::string name;
+        const SharedDataManager* sharedDataManager;
+    };
+
+    void run();
+    void writeFile() const;
+    void serveClient(int clientSocket) const;
+
+    std::string mFilePath;  ///< Empty when the file is disabled.
+    std::chrono::seconds mInterval;
+    int mListenSocket = -1;  ///< -1 when the HTTP endpoint is disabled.
+    std::vector<Stream> mStreams;
+
+    std::atomic<bool> mStopping = false;
+    std::thread mThread;
+};
@@ -0,0 +1,130 @@
+#include "npy_recording.h"
+
+namespace
+{
+constexpr std::string_view npyMagic = "\x93NUMPY";
+constexpr size_t npyPreambleSize = 8;  ///< Magic and the two version bytes.
+
+/**
+ * @brief Returns the text following "'key':" in a .npy header dictionary, without leading spaces.
+ * @throws std::runtime_error If the key is missing.
+ */
+std::string_view headerValue(std::string_view header, const std::string& key, const std::string& filePath)
+{
+    const std::string quotedKey = "'" + key + "':";
+    const size_t position = header.find(quotedKey);
+    if (position == std::string_view::npos)
+    {
+        throw std::runtime_error("Recording " + filePath + " has no " + key + " in its header\n");
+    }
+    std::string_view value = header.substr(position + quotedKey.size());
+    return value.substr(std::min(value.find_first_not_of(' '), value.size()));
+}
+}  // namespace
+
+/**
+ * @brief Maps the file and checks that it holds a two-dimensional int16 matrix.
+ * @throws std::runtime_error If the file cannot be opened or mapped, or is not a .npy file.
+ * @throws std::invalid_argument If the matrix is not little-endian int16 with one column per channel.
+ */
+NpyRecording::NpyRecording(const std::string& filePath) : mFilePath(filePath)
+{
+    mFileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (mFileDescriptor == -1)
+    {
+        throw std::runtime_error("Unable to open recording " + filePath + ": " + strerror(errno) + "\n");
+    }
+
+    struct stat fileStatus;
+    if (fstat(mFileDescriptor, &fileStatus) == -1 || static_cast<size_t>(fileStatus.st_size) < npyPreambleSize + 2)
+    {
+        close(mFileDescriptor);
+        throw std::runtime_error("Recording " + filePath + " is too short to be a .npy file\n");
+    }
+    mFileSize = static_cast<size_t>(fileStatus.st_size);
+
+    void* mapping = mmap(nullptr, mFileSize, PROT_READ, MAP_PRIVATE, mFileDescriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close(mFileDescriptor);
+        throw std::runtime_error("Unable to map recording " + filePath + ": " + strerror(errno) + "\n");
+    }
+    mMapping = static_cast<const uint8_t*>(mapping);
+    madvise(mapping, mFileSize, MADV_SEQUENTIAL);
+
+    try
+    {
+        if (std::string_view(reinterpret_cast<const char*>(mMapping), npyMagic.size()) != npyMagic)
+        {
+            throw std::runtime_error("File " + filePath + " is not a .npy file\n");
+        }
+        // Version 1 stores the header length in 2 bytes, versions 2 and 3 in 4, little-endian
+        const uint8_t majorVersion = mMapping[npyMagic.size()];
+        const size_t lengthSize = majorVersion == 1 ? 2 : 4;
+        size_t headerLength = 0;
+        for (size_t i = 0; i < lengthSize; i++)
+        {
+            headerLength |= static_cast<size_t>(mMapping[npyPreambleSize + i]) << (8 * i);
+        }
+        const size_t dataOffset = npyPreambleSize + lengthSize + headerLength;
+        if (dataOffset > mFileSize)
+        {
+            throw std::runtime_error("Recording " + filePath + " has a truncated header\n");
+        }
+        parseHeader(std::string(reinterpret_cast<const char*>(mMapping) + npyPreambleSize + lengthSize, headerLength));
+
+        if (dataOffset + mNumSamples * mNumChannels * sizeof(int16_t) > mFileSize)
+        {
+            throw std::runtime_error("Recording " + filePath + " is shorter than its header says\n");
+        }
+        mData = mMapping + dataOffset;
+    }
+    catch (...)
+    {
+        munmap(mapping, mFileSize);
+        close(mFileDescriptor);
+        throw;
+    }
+}
+
+NpyRecording::~NpyRecording()
+{
+    munmap(const_cast<uint8_t*>(mMapping), mFileSize);
+    close(mFileDescriptor);
+}
+
+/**
+ * @brief Reads the dtype, memory order and shape from the header dictionary, e.g.
+ * "{'descr': '<i2', 'fortran_order': True, 'shape': (86082, 4), }".
+ */
+void NpyRecording::parseHeader(const std::string& header)
+{
+    const std::string_view descr = headerValue(header, "descr", mFilePath);
+    if (descr.substr(0, 5) != "'<i2'")
+    {
+        throw std::invalid_argument("Recording " + mFilePath + " must hold little-endian int16 samples\n");
+    }
+    mFortranOrder = headerValue(header, "fortran_order", mFilePath).substr(0, 4) == "True";
+
+    const std::string_view shapeText = headerValue(header, "shape", mFilePath);
+    const size_t shapeEnd = shapeText.find(')');
+    if (shapeText.empty() || shapeText.front() != '(' || shapeEnd == std::string_view::npos)
+    {
+        throw std::runtime_error("Recording " + mFilePath + " has a malformed shape\n");
+    }
+    std::vector<size_t> shape;
+    std::stringstream dimensions(std::string(shapeText.substr(1, shapeEnd - 1)));
+    for (std::string dimension; std::getline(dimensions, dimension, ',');)
+    {
+        if (dimension.find_first_not_of(' ') != std::string::npos)
+        {
+            shape.push_back(std::stoull(dimension));
+        }
+    }
+    if (shape.size() != 2 || shape[1] == 0)
+    {
+        throw std::invalid_argument("Recording " + mFilePath + " must be a matrix of samples by channels\n");
+    }
+    mNumSamples = shape[0];
+    mNumChannels = static_cast<int>(shape[1]);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "../pch.h"
+
+/**
+ * @class NpyRecording
+ * @brief A recorded sample matrix in NumPy's .npy format, read straight from a read-only memory mapping.
+ *
+ * The archive format is the one datalogger_simulator.py streams: little-endian int16 ADC counts, one row per sample
+ * and one column per channel, in either C or Fortran order. Nothing is copied on load, so a large recording costs
+ * only the pages actually read.
+ */
+class NpyRecording
+{
+   public:
+    explicit NpyRecording(const std::string& filePath);
+    ~NpyRecording();
+
+    NpyRecording(const NpyRecording&) = delete;
+    NpyRecording& operator=(const NpyRecording&) = delete;
+
+    size_t numSamples() const { return mNumSamples; }
+    int numChannels() const { return mNumChannels; }
+    const std::string& filePath() const { return mFilePath; }
+
+    /** @brief Sample index of channel, in ADC counts. */
+    int16_t sample(size_t index, int channel) const
+    {
+        const size_t element = mFortranOrder ? channel * mNumSamples + index : index * mNumChannels + channel;
+        int16_t value;
+        std::memcpy(&value, mData + element * sizeof(int16_t), sizeof(value));
+        return value;
+    }
+
+   private:
+    void parseHeader(const std::string& header);
+
+    std::string mFilePath;
+    int mFileDescriptor = -1;
+    const uint8_t* mMapping = nullptr;
+    size_t mFileSize = 0;
+    const uint8_t* mData = nullptr;  ///< First sample, just past the header.
+    size_t mNumSamples = 0;
+    int mNumChannels = 0;
+    bool mFortranOrder = false;  ///< Each channel's samples are contiguous, rather than each sample's channels.
+};
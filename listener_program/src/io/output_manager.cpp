@@ -1,15 +1,156 @@
 #include "output_manager.h"
 
+#include "../stage_tracer.h"
+#include "../utils.h"
+#include "detection_log.h"
+
+namespace
+{
+/**
+ * @brief Writes all of text to the file, retrying short writes.
+ * @throws std::runtime_error If the write fails (e.g. the disk is full).
+ */
+void writeAll(int fileDescriptor, std::string_view text, const std::string& filePath)
+{
+    while (!text.empty())
+    {
+        ssize_t written = ::write(fileDescriptor, text.data(), text.size());
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error("Error: Unable to write to file " + filePath + ": " + strerror(errno));
+        }
+        text.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+/**
+ * @brief Appends a value to a CSV row, formatted as std::to_string would but without allocating.
+ */
+template <typename T>
+void appendNumber(std::string& row, T value)
+{
+    char field[64];
+    std::to_chars_result result;
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        result = std::to_chars(field, field + sizeof(field), value, std::chars_format::fixed, 6);
+    }
+    else
+    {
+        result = std::to_chars(field, field + sizeof(field), value);
+    }
+    row.append(field, result.ptr);
+}
+
+template <typename T>
+void appendField(std::string& row, T value)
+{
+    row.push_back(',');
+    appendNumber(row, value);
+}
+}  // namespace
+
+/**
+ * @brief Allocates room for capacity rows of numChannelPairs TDOAs and XCorr amplitudes, discarding any rows.
+ */
+void DetectionBuffer::allocate(size_t capacity, int numChannelPairs)
+{
+    mSize = 0;
+    mAmps.resize(capacity);
+    mDoaX.resize(capacity);
+    mDoaY.resize(capacity);
+    mDoaZ.resize(capacity);
+    mTdoas.resize(static_cast<Eigen::Index>(capacity), numChannelPairs);
+    mXCorrAmps.resize(static_cast<Eigen::Index>(capacity), numChannelPairs);
+    mPeakTimes.resize(capacity);
+    mLatencies.resize(capacity);
+}
+
+/**
+ * @brief Copies one detection into the next free row. The buffer must not be full.
+ * @throws std::runtime_error If tdoas or xCorrAmps do not have one entry per channel pair.
+ */
+void DetectionBuffer::append(
+    float amplitude, float doaX, float doaY, float doaZ, const Eigen::VectorXf& tdoas,
+    const Eigen::VectorXf& xCorrAmps, const TimePoint& peakTime, std::chrono::microseconds latency)
+{
+    if (tdoas.size() != mTdoas.cols())
+    {
+        throw std::runtime_error("Error: Inconsistent TDOA vector size at index " + std::to_string(mSize));
+    }
+    if (xCorrAmps.size() != mXCorrAmps.cols())
+    {
+        throw std::runtime_error("Error: Inconsistent XCorr vector size at index " + std::to_string(mSize));
+    }
+    const Eigen::Index row = static_cast<Eigen::Index>(mSize);
+    mAmps[mSize] = amplitude;
+    mDoaX[mSize] = doaX;
+    mDoaY[mSize] = doaY;
+    mDoaZ[mSize] = doaZ;
+    mTdoas.row(row) = tdoas.transpose();
+    mXCorrAmps.row(row) = xCorrAmps.transpose();
+    mPeakTimes[mSize] = peakTime;
+    mLatencies[mSize] = latency;
+    mSize++;
+}
+
+/**
+ * @brief Starts the writer thread. The buffers are allocated once the channel count is known.
+ * @param detectionLogFormat "csv", "binary" (see DetectionLogFormat) or "both".
+ * @param liveOutputAddress Where to publish each detection as it is appended (see LivePublisher); empty to disable.
+ * @param metrics The stream's metrics, for the writer's flush counts and durations; null not to record them.
+ * @throws std::invalid_argument If detectionLogFormat is not one of these, or liveOutputAddress is malformed.
+ */
 OutputManager::OutputManager(
-    std::chrono::seconds programRuntime, bool integrationTesting, const std::string& loggingDirectory)
-    : mFlushInterval(std::chrono::seconds(30)),
+    std::chrono::seconds programRuntime, bool integrationTesting, const std::string& loggingDirectory,
+    const std::string& detectionLogFormat, const std::string& liveOutputAddress, MetricsRegistry* metrics)
+    : mWriteCsv(detectionLogFormat == "csv" || detectionLogFormat == "both"),
+      mWriteBinary(detectionLogFormat == "binary" || detectionLogFormat == "both"),
+      mFlushInterval(std::chrono::seconds(30)),
       mBufferSizeThreshold(1000),
+      mBufferCapacity(4 * mBufferSizeThreshold),
       mLastFlushTime(std::chrono::steady_clock::now()),
       mProgramRuntime(programRuntime),
       mProgramStartTime(std::chrono::system_clock::now()),
       mIntegrationTesting(integrationTesting),
-      mLoggingDirectory(loggingDirectory)
+      mLoggingDirectory(loggingDirectory),
+      mMetrics(metrics)
 {
+    if (!mWriteCsv && !mWriteBinary)
+    {
+        throw std::invalid_argument("Unknown detectionLogFormat: " + detectionLogFormat);
+    }
+    if (!liveOutputAddress.empty())
+    {
+        mLivePublisher = std::make_unique<LivePublisher>(liveOutputAddress);
+    }
+    mWriterThread = std::thread(&OutputManager::runWriter, this);
+}
+
+/**
+ * @brief Writes out any buffered rows, then stops the writer thread and closes the detection file.
+ */
+OutputManager::~OutputManager()
+{
+    try
+    {
+        drain();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mWriterLock);
+        mStopping = true;
+    }
+    mWriterWake.notify_all();
+    mWriterThread.join();
+    closeOutputFile();
 }
 
 /**
@@ -18,7 +159,8 @@ OutputManager::OutputManager(
  * This function creates an output file whose name is derived from the first received timestamp.
  * The file is used to log computed detection values, including peak time, amplitude,
  * direction of arrival (DOA) coordinates, time difference of arrival (TDOA),
- * and cross-correlation (XCorr) amplitude values.
+ * cross-correlation (XCorr) amplitude values and the packet-arrival-to-output latency.
+ * The binary detection log, if enabled, gets the same name with a ".bin" suffix.
  *
  * @param timestamp The first received timestamp, used to generate the output filename.
  * @param numChannels The number of channels in the data, used to generate TDOA and XCorr labels.
@@ -26,15 +168,18 @@ OutputManager::OutputManager(
  */
 void OutputManager::initializeOutputFile(const TimePoint& timestamp, const int numChannels)
 {
-    mDetectionOutputFile = mLoggingDirectory + convertTimePointToString(timestamp);
-    std::cout << "Creating and writing to file: " << mDetectionOutputFile << std::endl;
-
-    std::ofstream file(mDetectionOutputFile, std::ofstream::out | std::ofstream::trunc);
-    if (!file.is_open())
+    // Rows buffered from a previous stream belong to that stream's file
+    if (isOutputFileOpen())
     {
-        throw std::runtime_error("Error: Unable to open file for writing: " + mDetectionOutputFile);
+        drain();
+        closeOutputFile();
     }
 
+    mDetectionOutputFile = mLoggingDirectory + convertTimePointToString(timestamp);
+    mBinaryOutputFile = mDetectionOutputFile + ".bin";
+    mNumChannelPairs = numChannels * (numChannels - 1) / 2;
+    allocateBuffers(mNumChannelPairs);
+
     std::vector<std::string> columnNames = {"PeakTime", "Amplitude", "DOA_x", "DOA_y", "DOA_z"};
 
     // Generate TDOA and XCorr labels
@@ -44,16 +189,68 @@ void OutputManager::initializeOutputFile(const TimePoint& timestamp, const int n
     // Combine all column names
     columnNames.insert(columnNames.end(), tdoaLabels.begin(), tdoaLabels.end());
     columnNames.insert(columnNames.end(), xcorrLabels.begin(), xcorrLabels.end());
+    columnNames.push_back("Latency_us");
 
-    // Write the column names to the file, separated by commas
-    for (size_t i = 0; i < columnNames.size(); ++i)
+    if (mWriteCsv)
     {
-        file << columnNames[i];
-        if (i < columnNames.size() - 1) file << ",";
+        std::cout << "Creating and writing to file: " << mDetectionOutputFile << std::endl;
+        mFileDescriptor = open(mDetectionOutputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (mFileDescriptor == -1)
+        {
+            throw std::runtime_error("Error: Unable to open file for writing: " + mDetectionOutputFile);
+        }
+
+        // Write the column names to the file, separated by commas
+        std::string header;
+        for (size_t i = 0; i < columnNames.size(); ++i)
+        {
+            header += columnNames[i];
+            if (i < columnNames.size() - 1) header += ",";
+        }
+        header += "\n";
+        writeAll(mFileDescriptor, header, mDetectionOutputFile);
     }
-    file << std::endl;
 
-    file.close();
+    if (mWriteBinary)
+    {
+        std::cout << "Creating and writing to file: " << mBinaryOutputFile << std::endl;
+        mBinaryFileDescriptor = open(mBinaryOutputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (mBinaryFileDescriptor == -1)
+        {
+            throw std::runtime_error("Error: Unable to open file for writing: " + mBinaryOutputFile);
+        }
+        writeAll(
+            mBinaryFileDescriptor, DetectionLogFormat::fileHeader(numChannels, mNumChannelPairs, columnNames),
+            mBinaryOutputFile);
+    }
+}
+
+/**
+ * @brief Sizes both buffers, and the writer's binary record buffer, for rows of numChannelPairs pairs. Any buffered
+ * rows are discarded, so the writer must be idle and the front buffer already written.
+ */
+void OutputManager::allocateBuffers(int numChannelPairs)
+{
+    mBuffer.allocate(mBufferCapacity, numChannelPairs);
+    mWriteBuffer.allocate(mBufferCapacity, numChannelPairs);
+    mWriteRecords.reserve(mBufferCapacity * DetectionLogFormat::recordSize(numChannelPairs));
+}
+
+/**
+ * @brief Closes the detection files. The writer thread must be idle.
+ */
+void OutputManager::closeOutputFile()
+{
+    if (mFileDescriptor != -1)
+    {
+        close(mFileDescriptor);
+        mFileDescriptor = -1;
+    }
+    if (mBinaryFileDescriptor != -1)
+    {
+        close(mBinaryFileDescriptor);
+        mBinaryFileDescriptor = -1;
+    }
 }
 
 /**
@@ -84,121 +281,195 @@ std::vector<std::string> OutputManager::generateChannelComboLabels(const std::st
 }
 
 /**
- * @brief Writes the buffer data to the output file and resets the flush time.
+ * @brief Hands the buffered rows to the writer thread and resets the flush time.
+ *
+ * Does nothing if the writer is still busy with the previous batch; the rows stay buffered for the next flush.
+ * @throws std::runtime_error If no detection file has been opened yet.
  */
 void OutputManager::write()
 {
-    // auto beforeFlush = std::chrono::steady_clock::now();
-    appendBufferToFile();
-    // auto afterFlush = std::chrono::steady_clock::now();
-    // std::chrono::duration<double> durationFlush = afterFlush - beforeFlush;
+    if (!isOutputFileOpen())
+    {
+        throw std::runtime_error("Error: Unable to open file for appending: " + mDetectionOutputFile);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mWriterLock);
+        if (mWritePending)
+        {
+            return;
+        }
+        std::swap(mBuffer, mWriteBuffer);
+        mWritePending = true;
+    }
+    mWriterWake.notify_all();
 
     mLastFlushTime = std::chrono::steady_clock::now();
 }
 
 /**
- * @brief Clears all data from the buffer.
+ * @brief Blocks until the writer thread has written its current batch.
+ * @throws Whatever the writer thread failed with, if it failed.
+ */
+void OutputManager::waitForWriter()
+{
+    std::unique_lock<std::mutex> lock(mWriterLock);
+    mWriterWake.wait(lock, [this]() { return !mWritePending; });
+    if (mWriterError)
+    {
+        std::rethrow_exception(std::exchange(mWriterError, nullptr));
+    }
+}
+
+/**
+ * @brief Blocks until every buffered row has been written to the detection file.
+ */
+void OutputManager::drain()
+{
+    waitForWriter();
+    if (mBuffer.size() != 0 && isOutputFileOpen())
+    {
+        write();
+        waitForWriter();
+    }
+}
+
+/**
+ * @brief Writer thread body: writes each batch handed over by write(), until destruction.
  */
-void OutputManager::clearBuffer()
+void OutputManager::runWriter()
 {
-    mBuffer.mAmps.clear();
-    mBuffer.mDoaX.clear();
-    mBuffer.mDoaY.clear();
-    mBuffer.mDoaZ.clear();
-    mBuffer.mTdoaVector.clear();
-    mBuffer.mXCorrAmps.clear();
-    mBuffer.mPeakTimes.clear();
+    std::unique_lock<std::mutex> lock(mWriterLock);
+    while (true)
+    {
+        mWriterWake.wait(lock, [this]() { return mStopping || mWritePending; });
+        if (!mWritePending)
+        {
+            return;
+        }
+
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            TRACE_STAGE(Flush);
+            const auto flushStart = std::chrono::steady_clock::now();
+            appendBufferToFile(mWriteBuffer);
+            if (mMetrics)
+            {
+                mMetrics->add(MetricCounter::Flushes);
+                mMetrics->flushDuration().record(std::chrono::steady_clock::now() - flushStart);
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        mWriteBuffer.clear();
+        lock.lock();
+
+        if (error && !mWriterError)
+        {
+            mWriterError = error;
+        }
+        mWritePending = false;
+        mWriterWake.notify_all();
+    }
 }
 
 /**
- * @brief Appends a single data row to the buffer.
+ * @brief Appends a single data row to the buffer, and publishes it if live output is enabled.
+ *
+ * @param latency Time from the arrival of the detection window's last packet to this call.
  */
 void OutputManager::appendToBuffer(
     const float peakAmp, const float doaX, const float doaY, const float doaZ, const Eigen::VectorXf& tdoaVector,
-    const Eigen::VectorXf& xCorrAmps, const TimePoint& peakTime)
+    const Eigen::VectorXf& xCorrAmps, const TimePoint& peakTime, std::chrono::microseconds latency)
 {
-    mBuffer.mAmps.push_back(peakAmp);
-    mBuffer.mDoaX.push_back(doaX);
-    mBuffer.mDoaY.push_back(doaY);
-    mBuffer.mDoaZ.push_back(doaZ);
-    mBuffer.mTdoaVector.push_back(tdoaVector);
-    mBuffer.mXCorrAmps.push_back(xCorrAmps);
-    mBuffer.mPeakTimes.push_back(peakTime);
+    if (mBuffer.capacity() == 0)
+    {
+        // Rows appended before any output file exists size the buffers themselves
+        allocateBuffers(static_cast<int>(tdoaVector.size()));
+    }
+    else if (mBuffer.isFull())
+    {
+        waitForWriter();
+        write();
+    }
+    mBuffer.append(peakAmp, doaX, doaY, doaZ, tdoaVector, xCorrAmps, peakTime, latency);
+
+    if (mLivePublisher)
+    {
+        mLivePublisher->publishDetection(
+            peakAmp, doaX, doaY, doaZ, mBuffer.tdoas(mBuffer.size() - 1), mBuffer.xCorrAmps(mBuffer.size() - 1),
+            peakTime, latency);
+    }
 }
 
 /**
  * @brief Appends buffered detection data to the output file.
  *
- * This function writes stored detection values from the internal buffer to the output file.
+ * This function writes stored detection values from the given buffer to the output file.
  * Each row in the file represents a detection event and includes the following data:
  * - Peak detection time (microseconds since epoch)
  * - Signal amplitude
  * - Direction of arrival (DOA) coordinates (X, Y, Z)
  * - Time difference of arrival (TDOA) values for channel pairs
  * - Cross-correlation (XCorr) amplitude values for channel pairs
+ * - Latency from packet arrival to output (microseconds)
+ *
+ * The rows are formatted into one string and written with a single call, and likewise appended as records to the
+ * binary detection log if enabled. Runs on the writer thread.
  *
- * @throws std::runtime_error If the file cannot be opened for writing or if buffer sizes are inconsistent.
+ * @throws std::runtime_error If the file cannot be written or the rows do not match the binary log header.
  */
-void OutputManager::appendBufferToFile()
+void OutputManager::appendBufferToFile(const DetectionBuffer& buffer)
 {
-    std::ofstream file(mDetectionOutputFile, std::ofstream::out | std::ofstream::app);
-    if (!file.is_open())
-    {
-        throw std::runtime_error("Error: Unable to open file for appending: " + mDetectionOutputFile);
-    }
-
-    size_t dataSize = mBuffer.mAmps.size();
-    if (mBuffer.mDoaX.size() != dataSize || mBuffer.mDoaY.size() != dataSize || mBuffer.mDoaZ.size() != dataSize ||
-        mBuffer.mTdoaVector.size() != dataSize || mBuffer.mXCorrAmps.size() != dataSize ||
-        mBuffer.mPeakTimes.size() != dataSize)
-    {
-        throw std::runtime_error("Error: Mismatched buffer sizes in BufferStruct.");
-    }
-
-    int numChannelPairs = mBuffer.mTdoaVector[0].size();
+    const size_t dataSize = buffer.size();
+    const int numChannelPairs = buffer.numChannelPairs();
 
-    for (size_t i = 0; i < dataSize; ++i)
+    if (mFileDescriptor != -1)
     {
-        std::vector<std::string> rowData;
-
-        auto timePoint = mBuffer.mPeakTimes[i];
-        auto timeSinceEpoch = std::chrono::duration_cast<std::chrono::microseconds>(timePoint.time_since_epoch());
-        rowData.emplace_back(std::to_string(timeSinceEpoch.count()));
-
-        rowData.push_back(std::to_string(mBuffer.mAmps[i]));
-        rowData.push_back(std::to_string(mBuffer.mDoaX[i]));
-        rowData.push_back(std::to_string(mBuffer.mDoaY[i]));
-        rowData.push_back(std::to_string(mBuffer.mDoaZ[i]));
-
-        Eigen::VectorXf tdoaVec = mBuffer.mTdoaVector[i];
-        if (tdoaVec.size() != numChannelPairs)
-        {
-            throw std::runtime_error("Error: Inconsistent TDOA vector size at index " + std::to_string(i));
-        }
-        for (int j = 0; j < tdoaVec.size(); ++j)
+        mWriteText.clear();
+        for (size_t i = 0; i < dataSize; ++i)
         {
-            rowData.push_back(std::to_string(tdoaVec[j]));
+            auto timePoint = buffer.peakTimes()[i];
+            auto timeSinceEpoch = std::chrono::duration_cast<std::chrono::microseconds>(timePoint.time_since_epoch());
+            appendNumber(mWriteText, timeSinceEpoch.count());
+
+            appendField(mWriteText, buffer.amplitudes()[i]);
+            appendField(mWriteText, buffer.doaX()[i]);
+            appendField(mWriteText, buffer.doaY()[i]);
+            appendField(mWriteText, buffer.doaZ()[i]);
+            for (float tdoa : buffer.tdoas(i))
+            {
+                appendField(mWriteText, tdoa);
+            }
+            for (float xCorrAmp : buffer.xCorrAmps(i))
+            {
+                appendField(mWriteText, xCorrAmp);
+            }
+            appendField(mWriteText, buffer.latencies()[i].count());
+            mWriteText += '\n';
         }
+        writeAll(mFileDescriptor, mWriteText, mDetectionOutputFile);
+    }
 
-        Eigen::VectorXf xcorrVec = mBuffer.mXCorrAmps[i];
-        if (xcorrVec.size() != numChannelPairs)
-        {
-            throw std::runtime_error("Error: Inconsistent XCorr vector size at index " + std::to_string(i));
-        }
-        for (int j = 0; j < xcorrVec.size(); ++j)
+    if (mBinaryFileDescriptor != -1)
+    {
+        if (numChannelPairs != mNumChannelPairs)
         {
-            rowData.push_back(std::to_string(xcorrVec[j]));
+            throw std::runtime_error(
+                "Error: " + std::to_string(numChannelPairs) + " channel pairs do not match the binary log header");
         }
-
-        for (size_t k = 0; k < rowData.size(); ++k)
+        mWriteRecords.clear();
+        for (size_t i = 0; i < dataSize; ++i)
         {
-            file << rowData[k];
-            if (k < rowData.size() - 1) file << ",";
+            DetectionLogFormat::appendRecord(
+                mWriteRecords, buffer.peakTimes()[i], buffer.amplitudes()[i], buffer.doaX()[i], buffer.doaY()[i],
+                buffer.doaZ()[i], buffer.tdoas(i), buffer.xCorrAmps(i), buffer.latencies()[i]);
         }
-        file << std::endl;
+        writeAll(mBinaryFileDescriptor, mWriteRecords, mBinaryOutputFile);
     }
-
-    file.close();
 }
 
 /**
@@ -206,7 +477,15 @@ void OutputManager::appendBufferToFile()
  */
 void OutputManager::flushBufferIfNecessary()
 {
-    int bufferSize = mBuffer.mPeakTimes.size();
+    {
+        std::lock_guard<std::mutex> lock(mWriterLock);
+        if (mWriterError)
+        {
+            std::rethrow_exception(std::exchange(mWriterError, nullptr));
+        }
+    }
+
+    size_t bufferSize = mBuffer.size();
 
     if (bufferSize == 0)
     {
@@ -219,7 +498,6 @@ void OutputManager::flushBufferIfNecessary()
     if (mIntegrationTesting || bufferSize >= mBufferSizeThreshold || mFlushInterval <= timeSinceLastFlush)
     {
         write();
-        clearBuffer();
     }
 }
 
@@ -230,10 +508,10 @@ void OutputManager::flushBufferIfNecessary()
  * that caused an error.
  *
  * @param errorTimestamps A span containing timestamps of the errored data packets.
- * @param erroredDataBytes A vector of byte arrays representing the raw data packets that triggered the error.
+ * @param erroredDataBytes Views of the raw data packets that triggered the error.
  */
 void OutputManager::writeDataToCerr(
-    std::span<TimePoint> errorTimestamps, const std::vector<std::vector<uint8_t>>& erroredDataBytes)
+    std::span<const TimePoint> errorTimestamps, std::span<const PacketView> erroredDataBytes)
 {
     std::stringstream errorMessage;  // Compose message to dispatch
 
@@ -315,19 +593,18 @@ void OutputManager::saveSpectraForTraining(
 }
 
 /**
- * @brief Determines if the program should terminate based on the runtime
- * duration.
+ * @brief Asks every stream to stop once the runtime duration is reached.
+ *
+ * The program is not exited here: the other streams still hold buffered detections, so each stream's threads stop
+ * on the flag and main destroys the runners, which drains every OutputManager.
  */
-void OutputManager::terminateProgramIfNecessary()
+void OutputManager::stopProgramIfNecessary()
 {
     TimePoint currentTime = std::chrono::system_clock::now();
     auto elapsedTime = currentTime - mProgramStartTime;
-    if (elapsedTime >= mProgramRuntime)
+    if (elapsedTime >= mProgramRuntime && !isProgramStopRequested())
     {
-        write();
         std::cout << "Terminating program... duration reached" << std::endl;
-        std::cout.flush();  // 🔹 Force flushing std::cout before exit
-        // std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        std::exit(0);
+        requestProgramStop();
     }
 }
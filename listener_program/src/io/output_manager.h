@@ -1,58 +1,138 @@
 #pragma once
 
+#include "../metrics_registry.h"
 #include "../pch.h"
 #include "../tracker/tracker.h"
+#include "live_publisher.h"
 
 /**
- * @brief A struct to hold buffer data for detection and tracking.
+ * @brief A fixed-capacity, struct-of-arrays buffer of detection rows.
+ *
+ * Each field is stored contiguously across rows: flat arrays for the scalars and a row-major matrix, one row per
+ * detection, for the TDOAs and XCorr amplitudes. All storage is allocated up front by allocate(), so append() and
+ * clear() never allocate.
  */
-struct BufferStruct
+class DetectionBuffer
 {
+   public:
+    using PairMatrix = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    void allocate(size_t capacity, int numChannelPairs);
+    void append(
+        float amplitude, float doaX, float doaY, float doaZ, const Eigen::VectorXf& tdoas,
+        const Eigen::VectorXf& xCorrAmps, const TimePoint& peakTime, std::chrono::microseconds latency);
+    void clear() { mSize = 0; }
+
+    size_t size() const { return mSize; }
+    size_t capacity() const { return mPeakTimes.size(); }
+    bool isFull() const { return mSize == capacity(); }
+    int numChannelPairs() const { return static_cast<int>(mTdoas.cols()); }
+
+    std::span<const float> amplitudes() const { return {mAmps.data(), mSize}; }
+    std::span<const float> doaX() const { return {mDoaX.data(), mSize}; }
+    std::span<const float> doaY() const { return {mDoaY.data(), mSize}; }
+    std::span<const float> doaZ() const { return {mDoaZ.data(), mSize}; }
+    std::span<const float> tdoas(size_t row) const { return pairRow(mTdoas, row); }
+    std::span<const float> xCorrAmps(size_t row) const { return pairRow(mXCorrAmps, row); }
+    std::span<const TimePoint> peakTimes() const { return {mPeakTimes.data(), mSize}; }
+    std::span<const std::chrono::microseconds> latencies() const { return {mLatencies.data(), mSize}; }
+
+   private:
+    static std::span<const float> pairRow(const PairMatrix& matrix, size_t row)
+    {
+        return std::span<const float>(matrix.row(static_cast<Eigen::Index>(row)).data(), matrix.cols());
+    }
+
+    size_t mSize = 0;
     std::vector<float> mAmps;
     std::vector<float> mDoaX;
     std::vector<float> mDoaY;
     std::vector<float> mDoaZ;
-    std::vector<Eigen::VectorXf> mTdoaVector;
-    std::vector<Eigen::VectorXf> mXCorrAmps;
+    PairMatrix mTdoas;  ///< capacity x channel pairs.
+    PairMatrix mXCorrAmps;  ///< capacity x channel pairs.
     std::vector<TimePoint> mPeakTimes;
+    std::vector<std::chrono::microseconds> mLatencies;  ///< Packet arrival to detection output, per row.
 };
 
 /**
  * @brief A class to manage the observation buffer for detection and tracking.
+ *
+ * Detections are appended to a front buffer on the processing thread. A flush swaps it with a back buffer that a
+ * background writer thread formats and writes to the detection file, which it keeps open, in one batch. The
+ * processing thread therefore never waits on the disk, except when a new file is started or the stream is drained.
+ * If the writer is still busy with the previous batch, rows keep accumulating in the front buffer until it is done;
+ * only if it fills up does the processing thread wait for the writer.
+ * Detections go to a CSV file, a binary detection log (see DetectionLogFormat), or both. If a live output address
+ * is configured, each detection is also published immediately through a LivePublisher.
  */
 class OutputManager
 {
    public:
-    OutputManager(std::chrono::seconds programRuntimei, bool integrationTesting, const std::string& loggingDirectory);
+    OutputManager(
+        std::chrono::seconds programRuntimei, bool integrationTesting, const std::string& loggingDirectory,
+        const std::string& detectionLogFormat = "csv", const std::string& liveOutputAddress = "",
+        MetricsRegistry* metrics = nullptr);
+    ~OutputManager();
+
+    OutputManager(const OutputManager&) = delete;
+    OutputManager& operator=(const OutputManager&) = delete;
 
     void appendToBuffer(const float peakAmp, const float doaX, const float doaY, const float doaZ,
-                        const Eigen::VectorXf& tdoaVector, const Eigen::VectorXf& xCorrAmps, const TimePoint& peakTime);
+                        const Eigen::VectorXf& tdoaVector, const Eigen::VectorXf& xCorrAmps, const TimePoint& peakTime,
+                        std::chrono::microseconds latency);
     void flushBufferIfNecessary();
 
-    void writeDataToCerr(std::span<TimePoint> errorTimestamps,
-                         const std::vector<std::vector<uint8_t>>& erroredDataBytes);
+    void writeDataToCerr(std::span<const TimePoint> errorTimestamps, std::span<const PacketView> erroredDataBytes);
 
     void initializeOutputFile(const TimePoint& timestamp, const int numChannels);
 
     void saveSpectraForTraining(const std::string& filename, int label, const Eigen::VectorXcf& frequencyDomainData);
 
-    void terminateProgramIfNecessary();
+    void stopProgramIfNecessary();
+    void drain();
+
+    /** @brief The publisher of live detections, for the tracker to share; null when live output is disabled. */
+    LivePublisher* livePublisher() const { return mLivePublisher.get(); }
 
    private:
-    void appendBufferToFile();
+    void allocateBuffers(int numChannelPairs);
+    void appendBufferToFile(const DetectionBuffer& buffer);
     void write();
-    void clearBuffer();
+    void waitForWriter();
+    void closeOutputFile();
+    bool isOutputFileOpen() const { return mFileDescriptor != -1 || mBinaryFileDescriptor != -1; }
+    void runWriter();
 
     std::vector<std::string> generateChannelComboLabels(const std::string& labelPrefix, int numChannels);
 
+    const bool mWriteCsv;
+    const bool mWriteBinary;
     std::string mDetectionOutputFile;
+    std::string mBinaryOutputFile;
+    int mFileDescriptor = -1;  ///< Used by the writer thread while a batch is pending, by the caller otherwise.
+    int mBinaryFileDescriptor = -1;  ///< Likewise, for the binary detection log.
+    int mNumChannelPairs = 0;
     std::chrono::milliseconds mFlushInterval;
     size_t mBufferSizeThreshold;
+    size_t mBufferCapacity;  ///< Rows each buffer holds; appending to a full one waits for the writer.
     std::chrono::time_point<std::chrono::steady_clock> mLastFlushTime;
-    BufferStruct mBuffer;
+    DetectionBuffer mBuffer;  ///< Front buffer, appended to by the processing thread.
 
     std::chrono::seconds mProgramRuntime;
     TimePoint mProgramStartTime;
     bool mIntegrationTesting;
     std::string mLoggingDirectory;
+    MetricsRegistry* mMetrics;  ///< Counts flushes and their durations; null when not exported.
+    std::unique_ptr<LivePublisher> mLivePublisher;
+
+    std::mutex mWriterLock;
+    std::condition_variable mWriterWake;
+    DetectionBuffer mWriteBuffer;  ///< Back buffer, owned by the writer thread while mWritePending is set.
+    std::string mWriteText;  ///< The writer's formatting buffer, reused across batches.
+    std::string mWriteRecords;  ///< The writer's binary record buffer, reused across batches.
+    bool mWritePending = false;
+    bool mStopping = false;
+    std::exception_ptr mWriterError;  ///< First failure of the writer thread, rethrown on the processing thread.
+
+    std::thread mWriterThread;  ///< Declared last so that everything it uses exists before it starts.
 };
@@ -0,0 +1,189 @@
+#include "packet_capture.h"
+
+using namespace PacketCaptureFormat;
+
+namespace
+{
+constexpr uint32_t captureVersion = 1;
+}
+
+/**
+ * @brief Creates (or truncates) the capture file and writes its header.
+ * @throws std::runtime_error If the file cannot be created or mapped.
+ */
+PacketCaptureWriter::PacketCaptureWriter(const std::string& filePath) : mFilePath(filePath)
+{
+    mFileDescriptor = open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (mFileDescriptor == -1)
+    {
+        throw std::runtime_error("Unable to create capture file " + filePath + ": " + strerror(errno) + "\n");
+    }
+
+    PacketCaptureFileHeader header{magic, captureVersion, 0};
+    try
+    {
+        reserve(sizeof(header));
+    }
+    catch (...)
+    {
+        close(mFileDescriptor);
+        throw;
+    }
+    std::memcpy(mMapping, &header, sizeof(header));
+    mBytesWritten = sizeof(header);
+}
+
+/**
+ * @brief Unmaps the file and trims the preallocated tail so the file ends after the last record.
+ */
+PacketCaptureWriter::~PacketCaptureWriter()
+{
+    if (mMapping != nullptr)
+    {
+        munmap(mMapping, mMappedSize);
+    }
+    if (mFileDescriptor != -1)
+    {
+        if (ftruncate(mFileDescriptor, static_cast<off_t>(mBytesWritten)) == -1)
+        {
+            std::cerr << "Unable to trim capture file " << mFilePath << ": " << strerror(errno) << std::endl;
+        }
+        close(mFileDescriptor);
+    }
+}
+
+/**
+ * @brief Grows the file and its mapping, in whole chunks, until it can hold requiredSize bytes.
+ * @throws std::runtime_error If the file cannot be extended or remapped (e.g. the disk is full).
+ */
+void PacketCaptureWriter::reserve(size_t requiredSize)
+{
+    if (requiredSize <= mMappedSize)
+    {
+        return;
+    }
+    const size_t newSize = ((requiredSize + mChunkSize - 1) / mChunkSize) * mChunkSize;
+
+    if (mMapping != nullptr)
+    {
+        munmap(mMapping, mMappedSize);
+        mMapping = nullptr;
+        mMappedSize = 0;
+    }
+    if (ftruncate(mFileDescriptor, static_cast<off_t>(newSize)) == -1)
+    {
+        throw std::runtime_error("Unable to extend capture file " + mFilePath + ": " + strerror(errno) + "\n");
+    }
+
+    void* mapping = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFileDescriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+        throw std::runtime_error("Unable to map capture file " + mFilePath + ": " + strerror(errno) + "\n");
+    }
+    mMapping = static_cast<uint8_t*>(mapping);
+    mMappedSize = newSize;
+}
+
+/**
+ * @brief Appends one datagram to the capture.
+ * @param packet The datagram payload.
+ * @param arrivalTime When the datagram arrived at the socket.
+ */
+void PacketCaptureWriter::write(PacketView packet, TimePoint arrivalTime)
+{
+    const size_t recordSize = sizeof(PacketCaptureRecordHeader) + paddedLength(packet.size());
+    reserve(mBytesWritten + recordSize);
+
+    PacketCaptureRecordHeader record{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(arrivalTime.time_since_epoch()).count(),
+        static_cast<uint32_t>(packet.size()), 0};
+    std::memcpy(mMapping + mBytesWritten, &record, sizeof(record));
+    std::memcpy(mMapping + mBytesWritten + sizeof(record), packet.data(), packet.size());
+    mBytesWritten += recordSize;
+}
+
+/**
+ * @brief Maps the capture file and checks its header.
+ * @throws std::runtime_error If the file cannot be opened or mapped, or is not a capture file of a known version.
+ */
+PacketCaptureReader::PacketCaptureReader(const std::string& filePath) : mFilePath(filePath)
+{
+    mFileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (mFileDescriptor == -1)
+    {
+        throw std::runtime_error("Unable to open capture file " + filePath + ": " + strerror(errno) + "\n");
+    }
+
+    struct stat fileStatus;
+    if (fstat(mFileDescriptor, &fileStatus) == -1 ||
+        static_cast<size_t>(fileStatus.st_size) < sizeof(PacketCaptureFileHeader))
+    {
+        close(mFileDescriptor);
+        throw std::runtime_error("Capture file " + filePath + " is too short to be a capture\n");
+    }
+    mFileSize = static_cast<size_t>(fileStatus.st_size);
+
+    void* mapping = mmap(nullptr, mFileSize, PROT_READ, MAP_PRIVATE, mFileDescriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close(mFileDescriptor);
+        throw std::runtime_error("Unable to map capture file " + filePath + ": " + strerror(errno) + "\n");
+    }
+    mMapping = static_cast<const uint8_t*>(mapping);
+    madvise(mapping, mFileSize, MADV_SEQUENTIAL);
+
+    PacketCaptureFileHeader header;
+    std::memcpy(&header, mMapping, sizeof(header));
+    if (header.magic != magic || header.version != captureVersion)
+    {
+        munmap(mapping, mFileSize);
+        close(mFileDescriptor);
+        throw std::runtime_error("File " + filePath + " is not a supported packet capture\n");
+    }
+    rewind();
+}
+
+PacketCaptureReader::~PacketCaptureReader()
+{
+    munmap(const_cast<uint8_t*>(mMapping), mFileSize);
+    close(mFileDescriptor);
+}
+
+/**
+ * @brief Returns the next datagram of the capture.
+ * @param packet Receives a view of the payload, valid for the reader's lifetime.
+ * @param arrivalTime Receives the recorded arrival time.
+ * @return False once every record has been read.
+ * @throws std::runtime_error If the last record is cut short.
+ */
+bool PacketCaptureReader::next(PacketView& packet, TimePoint& arrivalTime)
+{
+    if (mOffset + sizeof(PacketCaptureRecordHeader) > mFileSize)
+    {
+        return false;
+    }
+
+    PacketCaptureRecordHeader record;
+    std::memcpy(&record, mMapping + mOffset, sizeof(record));
+    if (record.length == 0 && record.arrivalTimeNs == 0)
+    {
+        return false;  // zero-filled tail of a capture whose writer did not shut down
+    }
+
+    const size_t payloadOffset = mOffset + sizeof(record);
+    if (payloadOffset + record.length > mFileSize)
+    {
+        throw std::runtime_error("Capture file " + mFilePath + " ends in the middle of a packet\n");
+    }
+
+    packet = PacketView(mMapping + payloadOffset, record.length);
+    arrivalTime =
+        TimePoint(std::chrono::duration_cast<TimePoint::duration>(std::chrono::nanoseconds(record.arrivalTimeNs)));
+    mOffset = payloadOffset + paddedLength(record.length);
+    return true;
+}
+
+/**
+ * @brief Moves back to the first datagram of the capture.
+ */
+void PacketCaptureReader::rewind() { mOffset = sizeof(PacketCaptureFileHeader); }
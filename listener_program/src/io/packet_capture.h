@@ -0,0 +1,89 @@
+#pragma once
+#include "../pch.h"
+
+/**
+ * @brief On-disk layout of a raw packet capture.
+ *
+ * A capture starts with a PacketCaptureFileHeader, followed by one record per datagram: a PacketCaptureRecordHeader
+ * and the datagram payload, padded to a multiple of 8 bytes so the next record header stays aligned. Integers are
+ * stored in host byte order. Records are appended to a zero-filled, preallocated file, so a record header whose
+ * length and arrival time are both zero marks the end of a capture that was not closed cleanly.
+ */
+namespace PacketCaptureFormat
+{
+inline constexpr std::array<char, 8> magic = {'F', 'W', 'P', 'C', 'A', 'P', '0', '1'};
+inline constexpr size_t recordAlignment = 8;
+
+struct PacketCaptureFileHeader
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t reserved;
+};
+
+struct PacketCaptureRecordHeader
+{
+    int64_t arrivalTimeNs;  ///< Arrival time in nanoseconds since the system clock epoch.
+    uint32_t length;  ///< Payload length in bytes.
+    uint32_t reserved;
+};
+
+inline size_t paddedLength(size_t length) { return (length + recordAlignment - 1) & ~(recordAlignment - 1); }
+}  // namespace PacketCaptureFormat
+
+/**
+ * @class PacketCaptureWriter
+ * @brief Appends datagrams and their arrival times to a memory-mapped capture file.
+ *
+ * The file is grown and mapped in large chunks, so recording a packet is a memcpy into the mapping; the kernel writes
+ * the pages back in the background. The file is truncated to its used length when the writer is destroyed.
+ */
+class PacketCaptureWriter
+{
+   public:
+    explicit PacketCaptureWriter(const std::string& filePath);
+    ~PacketCaptureWriter();
+
+    PacketCaptureWriter(const PacketCaptureWriter&) = delete;
+    PacketCaptureWriter& operator=(const PacketCaptureWriter&) = delete;
+
+    void write(PacketView packet, TimePoint arrivalTime);
+
+    size_t bytesWritten() const { return mBytesWritten; }
+
+   private:
+    static constexpr size_t mChunkSize = 64 * 1024 * 1024;
+
+    void reserve(size_t requiredSize);
+
+    std::string mFilePath;
+    int mFileDescriptor = -1;
+    uint8_t* mMapping = nullptr;
+    size_t mMappedSize = 0;
+    size_t mBytesWritten = 0;
+};
+
+/**
+ * @class PacketCaptureReader
+ * @brief Reads the datagrams of a capture file in order, straight from a read-only memory mapping.
+ */
+class PacketCaptureReader
+{
+   public:
+    explicit PacketCaptureReader(const std::string& filePath);
+    ~PacketCaptureReader();
+
+    PacketCaptureReader(const PacketCaptureReader&) = delete;
+    PacketCaptureReader& operator=(const PacketCaptureReader&) = delete;
+
+    bool next(PacketView& packet, TimePoint& arrivalTime);
+
+    void rewind();
+
+   private:
+    std::string mFilePath;
+    int mFileDescriptor = -1;
+    const uint8_t* mMapping = nullptr;
+    size_t mFileSize = 0;
+    size_t mOffset = 0;  ///< Offset of the next record header.
+};
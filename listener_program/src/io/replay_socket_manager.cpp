@@ -0,0 +1,166 @@
+#include "replay_socket_manager.h"
+
+#include "../socket_variables.h"
+
+/**
+ * @brief Opens the capture named by socketVariables.replayFilePath.
+ * @throws std::runtime_error If the capture cannot be opened.
+ * @throws std::invalid_argument If the replay speed is negative.
+ */
+ReplaySocketManager::ReplaySocketManager(const SocketVariables& socketVariables)
+    : mReader(socketVariables.replayFilePath),
+      mSpeed(socketVariables.replaySpeed),
+      mPort(socketVariables.port),
+      mIp(socketVariables.ipAddress),
+      mBatchSize(std::max(1, socketVariables.receiveBatchSize))
+{
+    if (mSpeed < 0)
+    {
+        throw std::invalid_argument("replaySpeed must be 0 (unpaced) or positive");
+    }
+}
+
+/**
+ * @brief Re-anchors the pacing so a restart does not release a burst of overdue packets. The position is kept.
+ */
+void ReplaySocketManager::restartListener()
+{
+    std::cout << "Restarting replay listener:\n";
+    mPacingAnchor.reset();
+}
+
+/**
+ * @brief Reads the next datagram of the capture into mPendingPacket.
+ * @return False if the capture is exhausted.
+ */
+bool ReplaySocketManager::loadNextPacket()
+{
+    if (mFinished)
+    {
+        return false;
+    }
+
+    PendingPacket packet;
+    if (!mReader.next(packet.payload, packet.recordedTime))
+    {
+        reportReplayFinished();
+        return false;
+    }
+    mPendingPacket = packet;
+    return true;
+}
+
+/**
+ * @brief Time at which a datagram recorded at recordedTime should be released, given the replay speed.
+ */
+std::chrono::steady_clock::time_point ReplaySocketManager::dueTime(TimePoint recordedTime)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (mSpeed == 0)
+    {
+        return now;
+    }
+    if (!mPacingAnchor)
+    {
+        mPacingAnchor.emplace(recordedTime, now);
+    }
+
+    const auto& [anchorRecordedTime, anchorReplayTime] = *mPacingAnchor;
+    const std::chrono::duration<double, std::nano> recordedOffset = recordedTime - anchorRecordedTime;
+    if (recordedOffset.count() <= 0)
+    {
+        return anchorReplayTime;  // out-of-order arrival times in the capture are released immediately
+    }
+    return anchorReplayTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(recordedOffset / mSpeed);
+}
+
+/**
+ * @brief Prints how many packets were replayed and the rate they were consumed at.
+ */
+void ReplaySocketManager::reportReplayFinished()
+{
+    mFinished = true;
+    const std::chrono::duration<double> elapsed =
+        mReplayStart ? std::chrono::steady_clock::now() - *mReplayStart : std::chrono::duration<double>(0);
+    const double packetRate = elapsed.count() > 0 ? static_cast<double>(mPacketsReplayed) / elapsed.count() : 0;
+    std::cout << "Replay finished: " << mPacketsReplayed << " packets in " << elapsed.count() << " s ("
+              << packetRate << " packets/s)" << std::endl;
+}
+
+/**
+ * @brief Replays one datagram into getReceivedData(), blocking until it is due.
+ * @return Number of bytes delivered, or 0 once the capture is exhausted.
+ */
+int ReplaySocketManager::receiveData(
+    [[maybe_unused]] int flags, [[maybe_unused]] struct sockaddr* addr, [[maybe_unused]] socklen_t* addrlen)
+{
+    mDataBytes.resize(mReceiveBufferSize);
+    std::span<uint8_t> buffer(mDataBytes);
+    size_t length = 0;
+    int packetsReceived = receiveBatch(
+        std::span<const std::span<uint8_t>>(&buffer, 1), std::span<size_t>(&length, 1),
+        std::span<TimePoint>(&mLastArrivalTime, 1), 0);
+    mDataBytes.resize(packetsReceived == 1 ? length : 0);
+    return static_cast<int>(mDataBytes.size());
+}
+
+/**
+ * @brief Replays up to min(buffers.size(), getBatchSize()) datagrams.
+ *
+ * Blocks until the next datagram is due, then also delivers every following datagram that is already due, mirroring
+ * how a socket returns all datagrams queued by the kernel. Datagrams longer than their buffer are truncated.
+ *
+ * @param buffers Destination buffers, one per datagram.
+ * @param lengths Receives the number of bytes written into each buffer.
+ * @param arrivalTimes Receives the time each datagram was replayed.
+ * @param flags Unused.
+ * @return Number of datagrams delivered; 0 once the capture is exhausted.
+ */
+int ReplaySocketManager::receiveBatch(
+    std::span<const std::span<uint8_t>> buffers, std::span<size_t> lengths, std::span<TimePoint> arrivalTimes,
+    [[maybe_unused]] int flags)
+{
+    const int maxPackets = static_cast<int>(std::min<size_t>(buffers.size(), mBatchSize));
+
+    int packetsReceived = 0;
+    while (packetsReceived < maxPackets)
+    {
+        if (!mPendingPacket && !loadNextPacket())
+        {
+            break;
+        }
+
+        const auto due = dueTime(mPendingPacket->recordedTime);
+        if (due > std::chrono::steady_clock::now())
+        {
+            if (packetsReceived > 0)
+            {
+                break;  // hand over what is due now rather than holding it back for the next packet
+            }
+            std::this_thread::sleep_until(due);
+        }
+
+        const PacketView payload = mPendingPacket->payload;
+        const size_t length = std::min(payload.size(), buffers[packetsReceived].size());
+        std::memcpy(buffers[packetsReceived].data(), payload.data(), length);
+        lengths[packetsReceived] = length;
+        arrivalTimes[packetsReceived] = std::chrono::system_clock::now();
+        mPendingPacket.reset();
+        packetsReceived++;
+    }
+
+    if (packetsReceived > 0)
+    {
+        if (!mReplayStart)
+        {
+            mReplayStart = std::chrono::steady_clock::now();
+        }
+        mPacketsReplayed += packetsReceived;
+    }
+    else if (mFinished)
+    {
+        // Nothing left to replay: idle like a quiet socket instead of spinning the listener thread
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return packetsReceived;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "../pch.h"
+#include "isocket_manager.h"
+#include "packet_capture.h"
+
+class SocketVariables;
+
+/**
+ * @brief Socket manager that replays a packet capture instead of reading from a network socket.
+ *
+ * Datagrams are copied straight from the memory-mapped capture into the caller's buffers; no kernel socket is
+ * involved. With a replay speed of 1 each datagram is released at its recorded inter-arrival time, with a speed of N
+ * the stream is compressed N times, and with a speed of 0 datagrams are handed out as fast as the packet queue has
+ * room for them. Delivered datagrams are stamped with the time they were replayed, so latency statistics describe the
+ * listener rather than the original recording.
+ *
+ * Once the capture is exhausted the manager prints the achieved packet rate and then behaves like an idle socket.
+ * Restarting the listener keeps the replay position, as a live stream would continue after a restart.
+ */
+class ReplaySocketManager : public ISocketManager
+{
+   public:
+    explicit ReplaySocketManager(const SocketVariables& socketVariables);
+
+    void restartListener() override;
+
+    int getSocket() const override { return -1; }
+    int getPort() const override { return mPort; }
+    std::string getIp() const override { return mIp; }
+
+    int receiveData(int flags, struct sockaddr* addr, socklen_t* addrlen) override;
+
+    std::vector<uint8_t>& getReceivedData() override { return mDataBytes; }
+    void setReceiveBufferSize(size_t newSize) override
+    {
+        mReceiveBufferSize = newSize;
+        mDataBytes.resize(newSize);
+    }
+
+    int receiveBatch(
+        std::span<const std::span<uint8_t>> buffers, std::span<size_t> lengths, std::span<TimePoint> arrivalTimes,
+        int flags) override;
+
+    int getBatchSize() const override { return mBatchSize; }
+    bool appliesBackpressure() const override { return true; }
+    TimePoint lastArrivalTime() const override { return mLastArrivalTime; }
+    uint64_t kernelDrops() const override { return 0; }
+
+    uint64_t packetsReplayed() const { return mPacketsReplayed; }
+
+   private:
+    struct PendingPacket
+    {
+        PacketView payload;
+        TimePoint recordedTime;
+    };
+
+    bool loadNextPacket();
+    std::chrono::steady_clock::time_point dueTime(TimePoint recordedTime);
+    void reportReplayFinished();
+
+    PacketCaptureReader mReader;
+    const double mSpeed;  ///< Multiple of real time; 0 replays without pacing.
+    const int mPort;
+    const std::string mIp;
+    const int mBatchSize;
+    std::vector<uint8_t> mDataBytes;  ///< Last datagram delivered by receiveData.
+    TimePoint mLastArrivalTime;  ///< When the datagram in mDataBytes was replayed.
+    size_t mReceiveBufferSize = 0;  ///< Largest datagram receiveData delivers.
+
+    std::optional<PendingPacket> mPendingPacket;  ///< Next datagram, read from the capture but not yet delivered.
+    /// Recorded time of the first datagram since the last (re)start, and when it was replayed.
+    std::optional<std::pair<TimePoint, std::chrono::steady_clock::time_point>> mPacingAnchor;
+    std::optional<std::chrono::steady_clock::time_point> mReplayStart;
+    uint64_t mPacketsReplayed = 0;
+    bool mFinished = false;
+};
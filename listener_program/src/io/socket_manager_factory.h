@@ -0,0 +1,46 @@
+#pragma once
+#include "../pch.h"
+#include "../socket_variables.h"
+#include "capture_socket_manager.h"
+#include "io_uring_socket_manager.h"
+#include "replay_socket_manager.h"
+#include "udp_socket_manager.h"
+
+class SocketManagerFactory
+{
+   public:
+    static std::unique_ptr<ISocketManager> create(const SocketVariables& socketVariables)
+    {
+        std::unique_ptr<ISocketManager> socketManager = createBackend(socketVariables);
+        if (!socketVariables.captureFilePath.empty())
+        {
+            return std::make_unique<CaptureSocketManager>(std::move(socketManager), socketVariables.captureFilePath);
+        }
+        return socketManager;
+    }
+
+   private:
+    static std::unique_ptr<ISocketManager> createBackend(const SocketVariables& socketVariables)
+    {
+        if (socketVariables.socketBackend == "udp")
+        {
+            return std::make_unique<UdpSocketManager>(socketVariables);
+        }
+        else if (socketVariables.socketBackend == "io_uring")
+        {
+#ifdef HAVE_LIBURING
+            return std::make_unique<IoUringSocketManager>(socketVariables);
+#else
+            throw std::invalid_argument("socketBackend io_uring requested but this build has no liburing support");
+#endif
+        }
+        else if (socketVariables.socketBackend == "replay")
+        {
+            return std::make_unique<ReplaySocketManager>(socketVariables);
+        }
+        else
+        {
+            throw std::invalid_argument("Unknown socketBackend type: " + socketVariables.socketBackend);
+        }
+    }
+};
@@ -10,7 +10,14 @@ UdpSocketManager::UdpSocketManager(const SocketVariables& socketVariables)
     : mDatagramSocket(socket(AF_INET, SOCK_DGRAM, 0)),
       mUdpPort(socketVariables.port),
       mUdpIp(socketVariables.ipAddress),
-      mDataBytes()
+      mBatchSize(std::max(1, socketVariables.receiveBatchSize)),
+      mDataBytes(),
+      mBatchIovecs(mBatchSize)
+#ifdef __linux__
+      ,
+      mBatchHeaders(mBatchSize),
+      mBatchControl(mBatchSize)
+#endif
 {
     if (mUdpIp == "self")
     {
@@ -21,6 +28,17 @@ UdpSocketManager::UdpSocketManager(const SocketVariables& socketVariables)
     {
         throw std::runtime_error("Error creating socket\n");
     }
+    enableReceiveTimestamps();
+    enableDropCount();
+    setReceiveTimeout();
+
+#ifdef __linux__
+    for (int i = 0; i < mBatchSize; i++)
+    {
+        mBatchHeaders[i].msg_hdr.msg_iov = &mBatchIovecs[i];
+        mBatchHeaders[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
 }
 
 /**
@@ -38,12 +56,17 @@ void UdpSocketManager::restartListener()
         throw std::runtime_error("Failed to close socket\n");
     }
 
-    // Create a new socket
+    // Create a new socket; its drop counter starts from zero
     mDatagramSocket = socket(AF_INET, SOCK_DGRAM, 0);
     if (mDatagramSocket == -1)
     {
         throw std::runtime_error("Error creating socket\n");
     }
+    mLastDropCount = 0;
+    mKernelDrops = 0;
+    enableReceiveTimestamps();
+    enableDropCount();
+    setReceiveTimeout();
 
     struct sockaddr_in serverAddr;
     serverAddr.sin_family = AF_INET;
@@ -72,22 +95,199 @@ void UdpSocketManager::restartListener()
 }
 
 /**
- * @brief Receives data from the UDP socket.
+ * @brief Asks the kernel to attach a nanosecond arrival timestamp to every datagram received on the socket.
+ *
+ * The timestamps are read back by receiveBatch. Failure is not fatal: receiveBatch falls back to the time the
+ * datagram was read from the socket.
+ */
+void UdpSocketManager::enableReceiveTimestamps()
+{
+#ifdef SO_TIMESTAMPNS
+    int enable = 1;
+    if (setsockopt(mDatagramSocket, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) == -1)
+    {
+        std::cerr << "Kernel receive timestamps unavailable; using user-space arrival times\n";
+    }
+#endif
+}
+
+/**
+ * @brief Asks the kernel to attach the socket's count of dropped datagrams to every datagram received on it.
+ *
+ * The counts are read back by the receive calls and reported by kernelDrops(). Failure is not fatal: drops then go
+ * unreported.
+ */
+void UdpSocketManager::enableDropCount()
+{
+#ifdef SO_RXQ_OVFL
+    int enable = 1;
+    if (setsockopt(mDatagramSocket, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) == -1)
+    {
+        std::cerr << "Kernel drop counts unavailable; socket buffer overflows will not be reported\n";
+    }
+#endif
+}
+
+/**
+ * @brief Accumulates the kernel's drop count from a received datagram's SO_RXQ_OVFL control message.
+ * @param dropCount The socket's cumulative drop count, which wraps at 2^32.
+ */
+void UdpSocketManager::recordDropCount(uint32_t dropCount)
+{
+    mKernelDrops += static_cast<uint32_t>(dropCount - mLastDropCount);
+    mLastDropCount = dropCount;
+}
+
+/**
+ * @brief Reads the kernel arrival timestamp and drop count attached to a received datagram, if any.
+ * @param arrivalTime Overwritten with the kernel timestamp when one is attached.
+ */
+void UdpSocketManager::readControlMessages(struct msghdr& header, TimePoint& arrivalTime)
+{
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr; cmsg = CMSG_NXTHDR(&header, cmsg))
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET)
+        {
+            continue;
+        }
+#ifdef SCM_TIMESTAMPNS
+        if (cmsg->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            struct timespec kernelTime;
+            std::memcpy(&kernelTime, CMSG_DATA(cmsg), sizeof(kernelTime));
+            arrivalTime = TimePoint(std::chrono::duration_cast<TimePoint::duration>(
+                std::chrono::seconds(kernelTime.tv_sec) + std::chrono::nanoseconds(kernelTime.tv_nsec)));
+        }
+#endif
+#ifdef SO_RXQ_OVFL
+        if (cmsg->cmsg_type == SO_RXQ_OVFL)
+        {
+            uint32_t dropCount;
+            std::memcpy(&dropCount, CMSG_DATA(cmsg), sizeof(dropCount));
+            recordDropCount(dropCount);
+        }
+#endif
+    }
+}
+
+/**
+ * @brief Makes blocking receives give up after mReceiveTimeout, so they return to the listener loop periodically.
+ * @throws std::runtime_error If the timeout cannot be set.
+ */
+void UdpSocketManager::setReceiveTimeout()
+{
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = std::chrono::duration_cast<std::chrono::microseconds>(mReceiveTimeout).count();
+    if (setsockopt(mDatagramSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == -1)
+    {
+        throw std::runtime_error("Error setting socket receive timeout\n");
+    }
+}
+
+/**
+ * @brief Receives data from the UDP socket, keeping its kernel arrival time for lastArrivalTime().
  *
  * @param buffer Pointer to the buffer to receive data into.
  * @param length Length of the buffer.
- * @param flags Flags for the recvfrom call.
+ * @param flags Flags for the recvmsg call.
  * @param addr Pointer to the sockaddr structure that will be filled with the sender address.
  * @param addrlen Pointer to the size of the addr structure.
- * @return Number of bytes received, or -1 on error.
+ * @return Number of bytes received, 0 if nothing arrived within the receive timeout, or -1 on error.
  */
 int UdpSocketManager::receiveData(int flags, struct sockaddr* addr, socklen_t* addrlen)
 {
-    int bytesReceived = recvfrom(mDatagramSocket, mDataBytes.data(), mDataBytes.size(), flags, addr, addrlen);
+    struct iovec iov;
+    iov.iov_base = mDataBytes.data();
+    iov.iov_len = mDataBytes.size();
+    struct msghdr header{};
+    header.msg_name = addr;
+    header.msg_namelen = addrlen != nullptr ? *addrlen : 0;
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    header.msg_control = mSingleControl.buffer;
+    header.msg_controllen = sizeof(mSingleControl.buffer);
+
+    int bytesReceived = static_cast<int>(recvmsg(mDatagramSocket, &header, flags));
+    if (addrlen != nullptr)
+    {
+        *addrlen = header.msg_namelen;
+    }
+    if (bytesReceived == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+        return 0;
+    }
     if (bytesReceived > 0)
     {
+        mLastArrivalTime = std::chrono::system_clock::now();
+        readControlMessages(header, mLastArrivalTime);
         mDataBytes.assign(
             static_cast<uint8_t*>(mDataBytes.data()), static_cast<uint8_t*>(mDataBytes.data()) + bytesReceived);
     }
     return bytesReceived;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Receives up to getBatchSize() datagrams from the UDP socket with a single system call.
+ *
+ * Each datagram is written straight into the matching caller-provided buffer (typically a free slot of the shared
+ * packet ring), so no intermediate copy is made. Blocks until at least one datagram is available, or for at most the
+ * receive timeout, and then returns every datagram already queued by the kernel, up to min(buffers.size(),
+ * getBatchSize()). On platforms without recvmmsg the batch is assembled from one blocking recv followed by
+ * non-blocking ones.
+ *
+ * @param buffers Destination buffers, one per datagram.
+ * @param lengths Receives the number of bytes written into each buffer; must be at least as long as buffers.
+ * @param arrivalTimes Receives the kernel arrival time of each datagram (SO_TIMESTAMPNS), or the time it was read
+ * from the socket when no kernel timestamp is available; must be at least as long as buffers.
+ * @param flags Additional flags for the receive call.
+ * @return Number of datagrams received, 0 if none arrived within the receive timeout, or -1 on error.
+ */
+int UdpSocketManager::receiveBatch(
+    std::span<const std::span<uint8_t>> buffers, std::span<size_t> lengths, std::span<TimePoint> arrivalTimes,
+    int flags)
+{
+    const int maxPackets = static_cast<int>(std::min<size_t>(buffers.size(), mBatchSize));
+
+#ifdef __linux__
+    for (int i = 0; i < maxPackets; i++)
+    {
+        mBatchIovecs[i].iov_base = buffers[i].data();
+        mBatchIovecs[i].iov_len = buffers[i].size();
+        // The kernel shrinks msg_controllen to what it wrote, so it must be reset before every call
+        mBatchHeaders[i].msg_hdr.msg_control = mBatchControl[i].buffer;
+        mBatchHeaders[i].msg_hdr.msg_controllen = sizeof(mBatchControl[i].buffer);
+    }
+
+    int packetsReceived = recvmmsg(mDatagramSocket, mBatchHeaders.data(), maxPackets, flags | MSG_WAITFORONE, nullptr);
+    if (packetsReceived == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+        return 0;
+    }
+    const TimePoint readTime = std::chrono::system_clock::now();
+    for (int i = 0; i < packetsReceived; i++)
+    {
+        lengths[i] = mBatchHeaders[i].msg_len;
+        arrivalTimes[i] = readTime;
+        readControlMessages(mBatchHeaders[i].msg_hdr, arrivalTimes[i]);
+    }
+    return packetsReceived;
+#else
+    int packetsReceived = 0;
+    while (packetsReceived < maxPackets)
+    {
+        int recvFlags = (packetsReceived == 0) ? flags : (flags | MSG_DONTWAIT);
+        ssize_t bytesReceived =
+            recv(mDatagramSocket, buffers[packetsReceived].data(), buffers[packetsReceived].size(), recvFlags);
+        if (bytesReceived < 0)
+        {
+            const bool timedOut = errno == EAGAIN || errno == EWOULDBLOCK;
+            return (packetsReceived == 0 && !timedOut) ? -1 : packetsReceived;
+        }
+        lengths[packetsReceived] = static_cast<size_t>(bytesReceived);
+        arrivalTimes[packetsReceived] = std::chrono::system_clock::now();
+        packetsReceived++;
+    }
+    return packetsReceived;
+#endif
+}
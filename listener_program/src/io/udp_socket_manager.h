@@ -20,13 +20,53 @@ class UdpSocketManager : public ISocketManager
     int receiveData(int flags, struct sockaddr* addr, socklen_t* addrlen) override;
 
     std::vector<uint8_t>& getReceivedData() override { return mDataBytes; }
+    TimePoint lastArrivalTime() const override { return mLastArrivalTime; }
     void setReceiveBufferSize(size_t newSize) override { mDataBytes.resize(newSize); }
 
+    int receiveBatch(
+        std::span<const std::span<uint8_t>> buffers, std::span<size_t> lengths, std::span<TimePoint> arrivalTimes,
+        int flags) override;
+
+    int getBatchSize() const override { return mBatchSize; }
+    bool appliesBackpressure() const override { return false; }
+    uint64_t kernelDrops() const override { return mKernelDrops; }
+
+   protected:
+    /// Longest a receive blocks with nothing to read, so the listener still notices a stop on a quiet stream.
+    static constexpr std::chrono::milliseconds mReceiveTimeout{100};
+    /// Ancillary data space for one kernel receive timestamp and the socket's drop count.
+    static constexpr size_t mControlSize = CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(uint32_t));
+
+    void recordDropCount(uint32_t dropCount);
+
    private:
+    void enableReceiveTimestamps();
+    void enableDropCount();
+    void setReceiveTimeout();
+    void readControlMessages(struct msghdr& header, TimePoint& arrivalTime);
+
     int mDatagramSocket;  ///< UDP socket descriptor.
     int mUdpPort;  ///< Port number for the UDP connection.
     std::string mUdpIp;  ///< IP address of the data logger or simulator.
+    int mBatchSize;  ///< Maximum number of datagrams pulled per receiveBatch call.
+    uint32_t mLastDropCount = 0;  ///< The socket's wrapping SO_RXQ_OVFL counter, as last reported by the kernel.
+    uint64_t mKernelDrops = 0;  ///< Datagrams dropped by the kernel since the socket was created.
 
     // Store dataBytes as a member to allow easier mocking and testing.
     std::vector<uint8_t> mDataBytes;
-};
\ No newline at end of file
+    TimePoint mLastArrivalTime;  ///< Of the datagram in mDataBytes.
+
+    /// Ancillary data buffer of mControlSize bytes, aligned for cmsghdr.
+    struct ReceiveControl
+    {
+        alignas(struct cmsghdr) char buffer[mControlSize];
+    };
+    ReceiveControl mSingleControl;  ///< For receiveData.
+
+    // Preallocated scatter/gather descriptors for batched receives into caller-provided buffers.
+    std::vector<struct iovec> mBatchIovecs;
+#ifdef __linux__
+    std::vector<struct mmsghdr> mBatchHeaders;
+    std::vector<ReceiveControl> mBatchControl;
+#endif
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include "pch.h"
+
+/**
+ * @class LogBucketHistogram
+ * @brief Lock-free log-scale histogram of durations with percentile queries.
+ *
+ * Durations are counted in whole Duration ticks. Ticks below SubBucketsPerOctave get a bucket each; above that, each
+ * power of two is split into SubBucketsPerOctave equal buckets, found from the bit width of the sample instead of a
+ * logarithm. A reported percentile is therefore at most 1 / SubBucketsPerOctave above the true value, while recording
+ * stays a handful of relaxed atomic operations. Samples can be recorded from any number of threads and summarised from
+ * another; reset() starts a new rolling interval.
+ */
+template <typename Duration, int SubBucketsPerOctave = 4>
+class LogBucketHistogram
+{
+    static_assert(std::has_single_bit(static_cast<unsigned>(SubBucketsPerOctave)), "sub-buckets must be a power of 2");
+
+   public:
+    /** @brief Adds one sample. Negative durations (e.g. from clock adjustments) are counted as zero. */
+    void record(std::chrono::nanoseconds duration)
+    {
+        const uint64_t ticks =
+            static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<Duration>(duration).count()));
+        mBuckets[bucketIndex(ticks)].fetch_add(1, std::memory_order_relaxed);
+        mCount.fetch_add(1, std::memory_order_relaxed);
+        mTotalTicks.fetch_add(ticks, std::memory_order_relaxed);
+
+        uint64_t previousMax = mMaxTicks.load(std::memory_order_relaxed);
+        while (ticks > previousMax && !mMaxTicks.compare_exchange_weak(previousMax, ticks, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    uint64_t count() const { return mCount.load(std::memory_order_relaxed); }
+    Duration max() const { return Duration(mMaxTicks.load(std::memory_order_relaxed)); }
+
+    /** @brief Average of the recorded durations; zero if empty. */
+    Duration mean() const
+    {
+        const uint64_t totalCount = count();
+        return totalCount == 0 ? Duration(0) : Duration(mTotalTicks.load(std::memory_order_relaxed) / totalCount);
+    }
+
+    /**
+     * @brief Returns an upper bound on the given percentile of the recorded durations.
+     * @param fraction Percentile as a fraction in [0, 1], e.g. 0.99 for p99.
+     * @return The upper edge of the bucket containing the percentile, capped at the exact maximum; zero if empty.
+     */
+    Duration percentile(double fraction) const
+    {
+        const uint64_t totalCount = count();
+        if (totalCount == 0)
+        {
+            return Duration(0);
+        }
+
+        const uint64_t targetRank =
+            std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * totalCount)));
+        uint64_t cumulativeCount = 0;
+        for (int i = 0; i < mNumBuckets; i++)
+        {
+            cumulativeCount += mBuckets[i].load(std::memory_order_relaxed);
+            if (cumulativeCount >= targetRank)
+            {
+                return std::min(Duration(bucketUpperBound(i)), max());
+            }
+        }
+        return max();
+    }
+
+    /**
+     * @brief Formats the sample count, mean, p50, p99 and maximum, in microseconds, on one line for logging. Finer
+     * units are printed to a tenth of a microsecond.
+     */
+    std::string summary() const
+    {
+        auto toUs = [](Duration duration) { return std::chrono::duration<double, std::micro>(duration).count(); };
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(std::ratio_less_v<typename Duration::period, std::micro> ? 1 : 0)
+           << "n: " << count() << " mean: " << toUs(mean()) << " us p50: " << toUs(percentile(0.5))
+           << " us p99: " << toUs(percentile(0.99)) << " us max: " << toUs(max()) << " us";
+        return ss.str();
+    }
+
+    /** @brief Discards all samples so the histogram covers a fresh interval. */
+    void reset()
+    {
+        for (auto& bucket : mBuckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        mCount.store(0, std::memory_order_relaxed);
+        mTotalTicks.store(0, std::memory_order_relaxed);
+        mMaxTicks.store(0, std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr int mSubBucketBits = std::countr_zero(static_cast<unsigned>(SubBucketsPerOctave));
+    static constexpr int mNumBuckets = (64 - mSubBucketBits + 1) * SubBucketsPerOctave;
+
+    /** @brief Small durations get a bucket each; above, the top mSubBucketBits + 1 bits pick the bucket. */
+    static int bucketIndex(uint64_t ticks)
+    {
+        if (ticks < SubBucketsPerOctave)
+        {
+            return static_cast<int>(ticks);
+        }
+        const int shift = std::bit_width(ticks) - mSubBucketBits - 1;
+        return (shift + 1) * SubBucketsPerOctave + static_cast<int>((ticks >> shift) & (SubBucketsPerOctave - 1));
+    }
+
+    /** @brief Largest duration, in ticks, that falls into the given bucket. */
+    static uint64_t bucketUpperBound(int bucketIndex)
+    {
+        if (bucketIndex < SubBucketsPerOctave)
+        {
+            return static_cast<uint64_t>(bucketIndex);
+        }
+        const int shift = bucketIndex / SubBucketsPerOctave - 1;
+        const uint64_t subBucket = static_cast<uint64_t>(bucketIndex % SubBucketsPerOctave);
+        const uint64_t bucketStart = (SubBucketsPerOctave + subBucket) << shift;
+        return bucketStart + ((uint64_t{1} << shift) - 1);
+    }
+
+    std::array<std::atomic<uint64_t>, mNumBuckets> mBuckets{};
+    std::atomic<uint64_t> mCount = 0;
+    std::atomic<uint64_t> mTotalTicks = 0;
+    std::atomic<uint64_t> mMaxTicks = 0;
+};
+
+/// End-to-end and I/O latencies, which span microseconds to seconds.
+using LatencyHistogram = LogBucketHistogram<std::chrono::microseconds>;
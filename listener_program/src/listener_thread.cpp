@@ -1,10 +1,9 @@
 #include "io/isocket_manager.h"
 // #include "io/isocket_manager.h"
+#include "logger.h"
 #include "pch.h"
 #include "shared_data_manager.h"
-
-int packetCounter = 0;  // this should only be used inside the UDPListener
-                        // function, as it is not protected by a mutex
+#include "utils.h"
 
 /**
  * @brief Logs packet statistics at regular intervals and resets the packet
@@ -16,19 +15,27 @@ int packetCounter = 0;  // this should only be used inside the UDPListener
  * @param queueSize Current size of the shared queue.
  * @param processedPackets Number of processed packets.
  * @param detectionCount Number of detections recorded by the session.
+ * @param dequeueLatency Enqueue-to-dequeue latency of the windows taken by the pipeline during the interval.
+ * @param sharedDataManager Source of the stream loss counters.
  */
 void logPacketStatistics(
     int packetCounter, int printInterval, std::chrono::steady_clock::time_point& startPacketTime, int queueSize,
-    int processedPackets, int detectionCount)
+    int processedPackets, int detectionCount, const SharedDataManager::DequeueLatency& dequeueLatency,
+    const SharedDataManager& sharedDataManager)
 {
     auto endPacketTime = std::chrono::steady_clock::now();
     std::chrono::duration<double> durationPacketTime = endPacketTime - startPacketTime;
 
-    // Compose log message using fixed formatting
-    printf(
-        "Packets rec: %d duration: %.6f queue size: %d processed packets: %d "
-        "detections: %d\n",
-        packetCounter, durationPacketTime.count() / printInterval, queueSize, processedPackets, detectionCount);
+    LOG_INFO(
+        "listener", "Packets rec: " << packetCounter << " duration: " << std::fixed << std::setprecision(6)
+                                    << durationPacketTime.count() / printInterval << " queue size: " << queueSize
+                                    << " processed packets: " << processedPackets << " detections: " << detectionCount
+                                    << " window latency avg: " << dequeueLatency.average.count()
+                                    << " us max: " << dequeueLatency.max.count()
+                                    << " us lost: " << sharedDataManager.packetsLost.load()
+                                    << " discarded: " << sharedDataManager.packetsDiscarded.load()
+                                    << " kernel drops: " << sharedDataManager.packetsDroppedByKernel.load()
+                                    << " resyncs: " << sharedDataManager.resyncCounter.load());
 
     startPacketTime = std::chrono::steady_clock::now();
 }
@@ -40,44 +47,93 @@ void logPacketStatistics(
  * @param sharedDataManager Reference to a SharedDataManager object for managing shared data across threads
  * @param socketManager Reference to a SocketManager object that manages the UDP
  * socket.
+ * @param waitWhenQueueFull If true (the pipeline sheds load), a full queue is not an error: the listener sleeps
+ * until a slot frees up and the socket's kernel buffer absorbs the burst.
  * @throws std::runtime_error if there is an error receiving data from the
  * socket or if the buffer overflows.
  */
-void runListenerLoop(SharedDataManager& sharedDataManager, std::unique_ptr<ISocketManager>& socketManager)
+void runListenerLoop(
+    SharedDataManager& sharedDataManager, std::unique_ptr<ISocketManager>& socketManager, bool waitWhenQueueFull)
 {
     try
     {
         struct sockaddr_in addr;
         socklen_t addrLength = sizeof(addr);
         constexpr int printInterval = 500;
-        const int receiveSize = 2048;  // some max size
+        const int receiveSize = sharedDataManager.slotSize();  // largest datagram a ring slot can hold
 
         // We let the SocketManager handle resizing internally as it receives
         // data
         socketManager->setReceiveBufferSize(receiveSize);
 
+        // Preallocated views of the ring slots that the next batch is received into
+        std::vector<std::span<uint8_t>> freeSlots(socketManager->getBatchSize());
+        std::vector<size_t> packetLengths(socketManager->getBatchSize());
+        std::vector<TimePoint> arrivalTimes(socketManager->getBatchSize());
+
         auto startPacketTime = std::chrono::steady_clock::now();
+        uint64_t kernelDrops = 0;  // the socket's count starts from zero with each restart
 
-        while (!sharedDataManager.errorOccurred)
+        while (!sharedDataManager.errorOccurred && !isProgramStopRequested())
         {
-            // Receive data
-            int bytesReceived = socketManager->receiveData(0, (struct sockaddr*)&addr, &addrLength);
+            int packetsReceived = 0;
+            int queueSize = 0;
 
-            if (bytesReceived == -1) throw std::runtime_error("Error in receiveData: bytesReceived is -1");
+            // The source holds its packets (or the kernel buffers them) while the listener sleeps until the pipeline
+            // frees a slot; false means an error or a stop, which ends the loop
+            if ((socketManager->appliesBackpressure() || waitWhenQueueFull) && !sharedDataManager.waitForFreeSlot())
+            {
+                continue;
+            }
 
-            const std::vector<uint8_t>& dataBytes = socketManager->getReceivedData();
+            if (socketManager->getBatchSize() > 1)
+            {
+                // Receive every datagram already queued by the kernel straight into free ring slots
+                int numFreeSlots = sharedDataManager.acquireWriteSlots(freeSlots);
 
-            int queueSize = sharedDataManager.pushDataToBuffer(dataBytes);
+                if (numFreeSlots == 0) throw std::runtime_error("Buffer overflowing \n");
 
-            packetCounter += 1;
-            if (packetCounter % printInterval == 0)
+                packetsReceived = socketManager->receiveBatch(
+                    std::span(freeSlots).first(numFreeSlots), packetLengths, arrivalTimes, 0);
+
+                if (packetsReceived == -1) throw std::runtime_error("Error in receiveBatch: packetsReceived is -1");
+
+                queueSize = sharedDataManager.commitWriteSlots(
+                    std::span(packetLengths).first(packetsReceived), std::span(arrivalTimes).first(packetsReceived));
+            }
+            else
+            {
+                // Receive data
+                int bytesReceived = socketManager->receiveData(0, (struct sockaddr*)&addr, &addrLength);
+
+                if (bytesReceived == -1) throw std::runtime_error("Error in receiveData: bytesReceived is -1");
+
+                if (bytesReceived == 0) continue;  // e.g. a replay that has run out of packets
+
+                const std::vector<uint8_t>& dataBytes = socketManager->getReceivedData();
+
+                queueSize = sharedDataManager.pushDataToBuffer(dataBytes, socketManager->lastArrivalTime());
+                packetsReceived = 1;
+            }
+
+            sharedDataManager.metrics.raise(MetricGauge::QueueHighWaterMark, static_cast<uint64_t>(queueSize));
+            if (socketManager->kernelDrops() != kernelDrops)
+            {
+                const uint64_t newDrops = socketManager->kernelDrops() - kernelDrops;
+                sharedDataManager.packetsDroppedByKernel += static_cast<int>(newDrops);
+                sharedDataManager.metrics.add(MetricCounter::KernelDrops, newDrops);
+                kernelDrops += newDrops;
+            }
+            const int previousPacketCount = sharedDataManager.packetsReceived.fetch_add(packetsReceived);
+            const int packetCounter = previousPacketCount + packetsReceived;
+            if (packetCounter / printInterval != previousPacketCount / printInterval)
             {
                 logPacketStatistics(
                     packetCounter, printInterval, startPacketTime, queueSize, packetCounter - queueSize,
-                    sharedDataManager.detectionCounter);
+                    sharedDataManager.detectionCounter, sharedDataManager.takeDequeueLatency(), sharedDataManager);
             }
 
-            if (queueSize > 1000)
+            if (queueSize > 1000 && !socketManager->appliesBackpressure() && !waitWhenQueueFull)
             {
                 throw std::runtime_error("Buffer overflowing \n");
             }
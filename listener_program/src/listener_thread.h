@@ -4,4 +4,5 @@
 class SharedDataManager;
 class ISocketManager;
 
-void runListenerLoop(SharedDataManager& sess, std::unique_ptr<ISocketManager>& socketManager);
\ No newline at end of file
+void runListenerLoop(
+    SharedDataManager& sess, std::unique_ptr<ISocketManager>& socketManager, bool waitWhenQueueFull = false);
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "load_shedder.h"
+
+#include "logger.h"
+
+/**
+ * @param enterQueueDepths Queue depth at which each tier above Normal is entered, one per tier, non-decreasing.
+ * @param exitQueueDepths Queue depth below which each tier is left again; each must be below its enter depth.
+ * @param thresholdScale Factor applied to the time-domain threshold from OverloadTier::RaiseThresholds on.
+ * @throws std::invalid_argument If the depths do not describe one non-decreasing band per tier, or thresholdScale < 1.
+ */
+LoadShedder::LoadShedder(std::vector<int> enterQueueDepths, std::vector<int> exitQueueDepths, float thresholdScale)
+    : mEnterQueueDepths(std::move(enterQueueDepths)),
+      mExitQueueDepths(std::move(exitQueueDepths)),
+      mThresholdScale(thresholdScale)
+{
+    const size_t numOverloadTiers = numTiers - 1;
+    if (mEnterQueueDepths.size() != numOverloadTiers || mExitQueueDepths.size() != numOverloadTiers)
+    {
+        throw std::invalid_argument("Load shedding needs one enter and one exit queue depth per overload tier");
+    }
+    for (size_t i = 0; i < numOverloadTiers; i++)
+    {
+        if (mExitQueueDepths[i] >= mEnterQueueDepths[i] || (i > 0 && mEnterQueueDepths[i] < mEnterQueueDepths[i - 1]))
+        {
+            throw std::invalid_argument(
+                "Load shedding enter depths must be non-decreasing and each exit depth below its enter depth");
+        }
+    }
+    if (thresholdScale < 1.0f)
+    {
+        throw std::invalid_argument("loadSheddingThresholdScale must be at least 1");
+    }
+}
+
+/**
+ * @brief Moves to the tier the queue depth calls for, logging any change.
+ *
+ * The tier rises as far as the enter depths allow and falls one tier at a time while the depth is below the current
+ * tier's exit depth.
+ *
+ * @param queueDepth Packets currently waiting in the stream's queue.
+ * @return The tier to apply to the next window.
+ */
+OverloadTier LoadShedder::update(int queueDepth)
+{
+    const OverloadTier previousTier = mTier;
+    int tier = static_cast<int>(mTier);
+    while (tier < numTiers - 1 && queueDepth >= mEnterQueueDepths[tier])
+    {
+        tier++;
+    }
+    while (tier > 0 && queueDepth < mExitQueueDepths[tier - 1])
+    {
+        tier--;
+    }
+    mTier = static_cast<OverloadTier>(tier);
+
+    if (mTier != previousTier)
+    {
+        LOG_INFO(
+            "load shedder", "Queue depth " << queueDepth << ", " << tierName(previousTier) << " -> " << tierName(mTier));
+    }
+    return mTier;
+}
+
+uint64_t LoadShedder::totalShed() const
+{
+    uint64_t total = 0;
+    for (const std::atomic<uint64_t>& count : mShedCounts)
+    {
+        total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief One-line summary of the current tier and the shed decisions counted so far.
+ */
+std::string LoadShedder::summary() const
+{
+    std::stringstream summary;
+    summary << "tier: " << tierName(mTier)
+            << " classifications skipped: " << shedCount(ShedAction::ClassifierSkipped)
+            << " tracker updates skipped: " << shedCount(ShedAction::TrackerUpdateSkipped)
+            << " detections suppressed: " << shedCount(ShedAction::DetectionSuppressed)
+            << " windows dropped: " << shedCount(ShedAction::WindowDropped)
+            << " packets dropped by kernel: " << shedCount(ShedAction::PacketDroppedByKernel);
+    return summary.str();
+}
+
+std::string LoadShedder::tierName(OverloadTier tier)
+{
+    switch (tier)
+    {
+        case OverloadTier::Normal:
+            return "normal";
+        case OverloadTier::SkipClassifier:
+            return "skip classifier";
+        case OverloadTier::SkipTracker:
+            return "skip tracker";
+        case OverloadTier::RaiseThresholds:
+            return "raise thresholds";
+        case OverloadTier::DropWindows:
+            return "drop windows";
+    }
+    return "unknown";
+}
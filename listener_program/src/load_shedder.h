@@ -0,0 +1,74 @@
+#pragma once
+#include "pch.h"
+
+/**
+ * @brief Overload tiers, in increasing order of severity. Each tier also applies every measure of the tiers below it.
+ */
+enum class OverloadTier
+{
+    Normal = 0,
+    SkipClassifier,  ///< Accept detections without running the ONNX classifier.
+    SkipTracker,  ///< Stop feeding and clustering the tracker.
+    RaiseThresholds,  ///< Require the time-domain detection to exceed a multiple of its configured threshold.
+    DropWindows  ///< Release whole windows without processing them.
+};
+
+/**
+ * @brief The measures a LoadShedder can take on a window; used to count shed decisions.
+ */
+enum class ShedAction
+{
+    ClassifierSkipped = 0,
+    TrackerUpdateSkipped,
+    DetectionSuppressed,
+    WindowDropped,
+    PacketDroppedByKernel  ///< Datagrams the socket dropped while the listener waited for the pipeline.
+};
+
+/**
+ * @class LoadShedder
+ * @brief Chooses an overload tier from the depth of the packet queue, with hysteresis.
+ *
+ * Tier N (1-based) is entered once the queue holds at least enterQueueDepths[N-1] packets and left again only once it
+ * falls below exitQueueDepths[N-1], which must be lower, so the pipeline does not flap between tiers when the depth
+ * hovers around a boundary. Tier changes are logged when they happen; shed decisions are counted and summarised by
+ * the caller at its reporting interval. update() and reset() belong to the thread that decodes windows; shed decisions
+ * may be recorded from any pipeline stage.
+ */
+class LoadShedder
+{
+   public:
+    static constexpr int numTiers = static_cast<int>(OverloadTier::DropWindows) + 1;
+
+    LoadShedder(std::vector<int> enterQueueDepths, std::vector<int> exitQueueDepths, float thresholdScale);
+
+    OverloadTier update(int queueDepth);
+
+    OverloadTier tier() const { return mTier; }
+    bool atLeast(OverloadTier tier) const { return mTier >= tier; }
+
+    float thresholdScale() const { return atLeast(OverloadTier::RaiseThresholds) ? mThresholdScale : 1.0f; }
+
+    void recordShed(ShedAction action, uint64_t count = 1)
+    {
+        mShedCounts[static_cast<int>(action)].fetch_add(count, std::memory_order_relaxed);
+    }
+    uint64_t shedCount(ShedAction action) const
+    {
+        return mShedCounts[static_cast<int>(action)].load(std::memory_order_relaxed);
+    }
+    uint64_t totalShed() const;
+
+    std::string summary() const;
+
+    void reset() { mTier = OverloadTier::Normal; }
+
+    static std::string tierName(OverloadTier tier);
+
+   private:
+    const std::vector<int> mEnterQueueDepths;
+    const std::vector<int> mExitQueueDepths;
+    const float mThresholdScale;
+    OverloadTier mTier = OverloadTier::Normal;
+    std::array<std::atomic<uint64_t>, 5> mShedCounts{};  ///< Shed decisions per ShedAction since construction.
+};
@@ -0,0 +1,259 @@
+#include "logger.h"
+
+namespace
+{
+const char* levelName(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::Debug:
+            return "DEBUG";
+        case LogLevel::Info:
+            return "INFO";
+        case LogLevel::Warning:
+            return "WARNING";
+        case LogLevel::Error:
+            return "ERROR";
+        case LogLevel::Off:
+            break;
+    }
+    return "OFF";
+}
+
+/**
+ * @brief Appends timeUs as "YYYY-MM-DD HH:MM:SS.mmmmmm" in UTC.
+ */
+void appendTimestamp(std::string& line, int64_t timeUs)
+{
+    const std::time_t seconds = static_cast<std::time_t>(timeUs / 1000000);
+    std::tm utcTime;
+    gmtime_r(&seconds, &utcTime);
+    std::array<char, 32> buffer;
+    const size_t length = std::strftime(buffer.data(), buffer.size(), "%Y-%m-%d %H:%M:%S", &utcTime);
+    line.append(buffer.data(), length);
+    std::snprintf(buffer.data(), buffer.size(), ".%06lld", static_cast<long long>(timeUs % 1000000));
+    line += buffer.data();
+}
+}  // namespace
+
+/**
+ * @brief Lets the message through if fewer than maxPerSecond have passed this second; 0 disables the limit.
+ */
+bool LogRateLimiter::allow(uint32_t maxPerSecond)
+{
+    if (maxPerSecond == 0)
+    {
+        return true;
+    }
+    const int64_t second =
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t windowSecond = mWindowSecond.load(std::memory_order_relaxed);
+    if (second != windowSecond && mWindowSecond.compare_exchange_strong(windowSecond, second, std::memory_order_relaxed))
+    {
+        mCountInWindow.store(0, std::memory_order_relaxed);
+    }
+    if (mCountInWindow.fetch_add(1, std::memory_order_relaxed) < maxPerSecond)
+    {
+        return true;
+    }
+    mSuppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/**
+ * @param capacity Records that can wait for the writer; rounded up to a power of two.
+ */
+Logger::Logger(std::ostream& output, std::ostream& errorOutput, size_t capacity)
+    : mOutput(output), mErrorOutput(errorOutput), mSlots(std::bit_ceil(capacity)), mMask(mSlots.size() - 1)
+{
+    for (size_t i = 0; i < mSlots.size(); i++)
+    {
+        mSlots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mWriterThread = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger()
+{
+    shutdown();
+}
+
+/**
+ * @brief Sets the lowest level that is logged, and how many messages per second each call site may log (0 for no
+ * limit).
+ */
+void Logger::configure(LogLevel level, uint32_t maxPerSecondPerCallSite)
+{
+    mLevel.store(level, std::memory_order_relaxed);
+    mRateLimit.store(maxPerSecondPerCallSite, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Queues one message for the writer thread, or counts it as dropped if the queue is full. Never blocks.
+ *
+ * Ignored after shutdown().
+ * @param component A string literal naming the source, e.g. "pipeline".
+ * @param suppressed Messages the call site's rate limiter refused before this one.
+ */
+void Logger::log(LogLevel level, const char* component, std::string_view message, uint64_t suppressed)
+{
+    if (mStopping.load(std::memory_order_relaxed))
+    {
+        return;  // nothing would print it
+    }
+    uint64_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true)
+    {
+        slot = &mSlots[position & mMask];
+        const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence == position)
+        {
+            if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (sequence < position)
+        {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;  // the writer has not yet printed the record a lap behind
+        }
+        else
+        {
+            position = mEnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    Record& record = slot->record;
+    record.timeUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    record.suppressed = suppressed;
+    record.component = component;
+    record.level = level;
+    record.length = static_cast<uint16_t>(std::min(message.size(), mMaxMessageLength));
+    std::memcpy(record.text.data(), message.data(), record.length);
+    if (message.size() > mMaxMessageLength)
+    {
+        std::memcpy(record.text.data() + mMaxMessageLength - 3, "...", 3);
+    }
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    mPublishCount.fetch_add(1, std::memory_order_release);
+    mPublishCount.notify_one();
+}
+
+/**
+ * @brief Blocks until every message queued so far has been printed.
+ */
+void Logger::flush()
+{
+    const uint64_t target = mEnqueuePosition.load(std::memory_order_acquire);
+    while (mDequeuePosition.load(std::memory_order_acquire) < target)
+    {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Prints everything still queued, then stops the writer thread. Messages logged afterwards are ignored.
+ *
+ * Call it once every thread that logs has stopped: a message being queued while the writer stops may be lost.
+ */
+void Logger::shutdown()
+{
+    if (mStopping.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+    mPublishCount.fetch_add(1, std::memory_order_release);
+    mPublishCount.notify_one();
+    mWriterThread.join();
+}
+
+/**
+ * @brief Converts a logLevel setting ("debug", "info", "warning", "error" or "off").
+ * @throws std::invalid_argument For any other value.
+ */
+LogLevel Logger::parseLevel(const std::string& level)
+{
+    const std::map<std::string, LogLevel> levels = {
+        {"debug", LogLevel::Debug},
+        {"info", LogLevel::Info},
+        {"warning", LogLevel::Warning},
+        {"error", LogLevel::Error},
+        {"off", LogLevel::Off}};
+    auto it = levels.find(level);
+    if (it == levels.end())
+    {
+        throw std::invalid_argument("Unknown logLevel: " + level);
+    }
+    return it->second;
+}
+
+/**
+ * @brief Writer thread body: prints records in the order they were queued until shutdown.
+ */
+void Logger::run()
+{
+    uint64_t position = mDequeuePosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        const uint32_t publishCount = mPublishCount.load(std::memory_order_acquire);
+        bool printed = false;
+        while (true)
+        {
+            Slot& slot = mSlots[position & mMask];
+            if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+            {
+                break;
+            }
+            write(slot.record);
+            slot.sequence.store(position + mSlots.size(), std::memory_order_release);
+            position++;
+            printed = true;
+        }
+
+        const uint64_t dropped = mDropped.load(std::memory_order_relaxed);
+        if (dropped != mReportedDropped)
+        {
+            mErrorOutput << "Logger dropped " << dropped - mReportedDropped << " messages: queue full" << std::endl;
+            mReportedDropped = dropped;
+        }
+        if (printed)
+        {
+            mOutput.flush();
+            mErrorOutput.flush();
+        }
+        // Published only once the batch is out, so that flush() returning means the streams are no longer in use
+        mDequeuePosition.store(position, std::memory_order_release);
+
+        if (mStopping.load(std::memory_order_acquire) && mEnqueuePosition.load(std::memory_order_acquire) == position)
+        {
+            return;
+        }
+        mPublishCount.wait(publishCount, std::memory_order_acquire);
+    }
+}
+
+/**
+ * @brief Formats one record as a line and prints it on the stream for its level.
+ */
+void Logger::write(const Record& record)
+{
+    mLine.clear();
+    appendTimestamp(mLine, record.timeUs);
+    mLine += " ";
+    mLine += levelName(record.level);
+    mLine += " [";
+    mLine += record.component;
+    mLine += "] ";
+    mLine.append(record.text.data(), record.length);
+    if (record.suppressed > 0)
+    {
+        mLine += " (" + std::to_string(record.suppressed) + " similar messages suppressed)";
+    }
+    mLine += "\n";
+    (record.level >= LogLevel::Warning ? mErrorOutput : mOutput) << mLine;
+}
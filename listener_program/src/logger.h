@@ -0,0 +1,153 @@
+#pragma once
+#include "pch.h"
+
+enum class LogLevel : uint8_t
+{
+    Debug,  ///< Per-detection diagnostics: AzEl, noise verdicts, IMU rotations, cluster details.
+    Info,  ///< Startup, periodic statistics and state changes.
+    Warning,
+    Error,
+    Off
+};
+
+/**
+ * @class LogRateLimiter
+ * @brief Lets at most a given number of messages per second through one call site, counting the rest.
+ *
+ * Each LOG_* call site owns one, so a message that fires for every detection cannot flood the console, while rare
+ * messages elsewhere are unaffected. The window is a whole second of steady_clock time.
+ */
+class LogRateLimiter
+{
+   public:
+    bool allow(uint32_t maxPerSecond);
+
+    /** @brief Messages refused since the last call, to be reported with the next message let through. */
+    uint64_t takeSuppressed() { return mSuppressed.exchange(0, std::memory_order_relaxed); }
+
+   private:
+    std::atomic<int64_t> mWindowSecond = -1;
+    std::atomic<uint32_t> mCountInWindow = 0;
+    std::atomic<uint64_t> mSuppressed = 0;
+};
+
+/**
+ * @class Logger
+ * @brief Asynchronous leveled logger: callers queue a record and a writer thread formats and prints it.
+ *
+ * Records go into a bounded lock-free multi-producer queue of fixed-size slots (each slot carries a sequence number,
+ * so producers claim slots with one compare-and-swap and never wait for each other or for the console). If the queue
+ * is full the message is dropped and counted; the hot path never blocks on a slow terminal or SSH session. Messages
+ * below the configured level cost one relaxed load, so at the default level (Info) the per-detection Debug messages
+ * emit nothing. Lines look like "2024-05-01 12:00:00.123456 INFO [pipeline] message", with Warning and Error going to
+ * the error stream.
+ *
+ * Use the LOG_* macros, which check the level before formatting and rate-limit each call site.
+ */
+class Logger
+{
+   public:
+    Logger(std::ostream& output, std::ostream& errorOutput, size_t capacity = 512);
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief The process-wide logger, printing to std::cout and std::cerr.
+     *
+     * It is never destroyed, since threads may still log while statics are torn down; a program calls shutdown()
+     * once its logging threads have stopped.
+     */
+    static Logger& instance()
+    {
+        static Logger* logger = new Logger(std::cout, std::cerr);
+        return *logger;
+    }
+
+    void configure(LogLevel level, uint32_t maxPerSecondPerCallSite);
+
+    bool isEnabled(LogLevel level) const { return level >= mLevel.load(std::memory_order_relaxed); }
+    uint32_t rateLimit() const { return mRateLimit.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+    void log(LogLevel level, const char* component, std::string_view message, uint64_t suppressed = 0);
+
+    void flush();
+    void shutdown();
+
+    static LogLevel parseLevel(const std::string& level);
+
+    /** @brief A cleared per-thread stream for LOG_* to format messages into without allocating each time. */
+    static std::ostringstream& threadStream()
+    {
+        thread_local std::ostringstream stream;
+        stream.str("");
+        stream.clear();
+        return stream;
+    }
+
+   private:
+    static constexpr size_t mMaxMessageLength = 448;
+    static constexpr size_t mCacheLineSize = 64;
+
+    struct Record
+    {
+        int64_t timeUs;
+        uint64_t suppressed;
+        const char* component;  ///< A string literal, so only the pointer is copied.
+        LogLevel level;
+        uint16_t length;
+        std::array<char, mMaxMessageLength> text;
+    };
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;  ///< Position the slot is free for, or that position + 1 once written.
+        Record record;
+    };
+
+    void run();
+    void write(const Record& record);
+
+    std::ostream& mOutput;
+    std::ostream& mErrorOutput;
+    std::vector<Slot> mSlots;
+    const uint64_t mMask;  ///< Capacity - 1; capacity is a power of two.
+
+    std::atomic<LogLevel> mLevel = LogLevel::Info;
+    std::atomic<uint32_t> mRateLimit = 10;
+    alignas(mCacheLineSize) std::atomic<uint64_t> mEnqueuePosition = 0;  ///< Next slot producers claim.
+    alignas(mCacheLineSize) std::atomic<uint64_t> mDequeuePosition = 0;  ///< Next slot the writer prints.
+    alignas(mCacheLineSize) std::atomic<uint32_t> mPublishCount = 0;  ///< Bumped per record; the writer waits on it.
+    std::atomic<uint64_t> mDropped = 0;
+    uint64_t mReportedDropped = 0;  ///< Writer only.
+    std::string mLine;  ///< Writer only; reused across records.
+    std::atomic<bool> mStopping = false;
+
+    std::thread mWriterThread;  ///< Declared last so that everything it uses exists before it starts.
+};
+
+/**
+ * @brief Logs message, a chain of operator<< operands, at level if that level is enabled and the call site is within
+ * its rate limit; e.g. LOG_DEBUG("pipeline", "AzEl: " << azimuthAndElevation).
+ */
+#define LOG_AT(level, component, message)                                                                          \
+    do                                                                                                             \
+    {                                                                                                              \
+        if (Logger::instance().isEnabled(level))                                                                   \
+        {                                                                                                          \
+            static LogRateLimiter logRateLimiter;                                                                  \
+            if (logRateLimiter.allow(Logger::instance().rateLimit()))                                              \
+            {                                                                                                      \
+                std::ostringstream& logStream = Logger::threadStream();                                            \
+                logStream << message;                                                                              \
+                Logger::instance().log(level, component, logStream.view(), logRateLimiter.takeSuppressed());      \
+            }                                                                                                      \
+        }                                                                                                          \
+    } while (false)
+
+#define LOG_DEBUG(component, message) LOG_AT(LogLevel::Debug, component, message)
+#define LOG_INFO(component, message) LOG_AT(LogLevel::Info, component, message)
+#define LOG_WARNING(component, message) LOG_AT(LogLevel::Warning, component, message)
+#define LOG_ERROR(component, message) LOG_AT(LogLevel::Error, component, message)
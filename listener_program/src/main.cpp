@@ -1,7 +1,7 @@
-#include "io/udp_socket_manager.h"
-#include "listener_thread.h"
-#include "pipeline.h"
-#include "shared_data_manager.h"
+#include "io/metrics_exporter.h"
+#include "logger.h"
+#include "shared_pipeline_resources.h"
+#include "stream_runner.h"
 #include "utils.h"
 
 int main(int argc, char* argv[])
@@ -14,29 +14,57 @@ int main(int argc, char* argv[])
 
     printMode();
 
-    auto [socketVariables, pipelineVars] = parseJsonConfig(std::string(argv[1]));
+    auto streamConfigs = parseStreamConfigs(std::string(argv[1]));
+    const std::chrono::seconds programRuntime(std::stoi(argv[2]));
 
-    std::unique_ptr<ISocketManager> socketManager = std::make_unique<UdpSocketManager>(socketVariables);
-
-    while (true)
+    // Logging is process-wide, so like the metrics it takes its settings from the first stream
+    const PipelineVariables& logSettings = std::get<1>(streamConfigs.front());
+    if (logSettings.logRateLimit < 0)
     {
-        socketManager->restartListener();
-
-        SharedDataManager sharedDataManager;
-        OutputManager outputManager(
-            std::chrono::seconds(std::stoi(argv[2])), pipelineVars.integrationTesting, pipelineVars.loggingDirectory);
-
-        Pipeline pipeline(outputManager, sharedDataManager, pipelineVars);
+        throw std::invalid_argument("logRateLimit cannot be negative");
+    }
+    Logger::instance().configure(
+        Logger::parseLevel(logSettings.logLevel), static_cast<uint32_t>(logSettings.logRateLimit));
 
-        // Create threads for listening for incoming data packets and processing data
-        std::thread producerThread(runListenerLoop, std::ref(sharedDataManager), std::ref(socketManager));
-        std::thread consumerThread(&Pipeline::process, &pipeline);
+    // Built once: filters, FFT plans, the ONNX model and the tracker survive listener restarts, and read-only
+    // resources are shared between streams. Streams are built one at a time since FFTW planning is not thread-safe.
+    SharedPipelineResources sharedResources;
+    std::vector<std::unique_ptr<StreamRunner>> streams;
+    for (const auto& [socketVariables, pipelineVars] : streamConfigs)
+    {
+        streams.push_back(
+            std::make_unique<StreamRunner>(socketVariables, pipelineVars, programRuntime, sharedResources));
+    }
 
-        // Wait for threads to finish
-        producerThread.join();
-        consumerThread.join();
+    // The exporter serves every stream, so it takes its settings from the first one, which inherits the top level's
+    std::unique_ptr<MetricsExporter> metricsExporter;
+    const PipelineVariables& metricsSettings = std::get<1>(streamConfigs.front());
+    if (!metricsSettings.metricsFile.empty() || metricsSettings.metricsPort != 0)
+    {
+        metricsExporter = std::make_unique<MetricsExporter>(
+            metricsSettings.metricsFile, metricsSettings.metricsPort,
+            std::chrono::seconds(metricsSettings.metricsIntervalSeconds));
+        for (size_t i = 0; i < streams.size(); i++)
+        {
+            metricsExporter->addStream(
+                "port" + std::to_string(std::get<0>(streamConfigs[i]).port), streams[i]->sharedDataManager());
+        }
+        metricsExporter->start();
+    }
 
-        std::cout << "Restarting threads..." << std::endl;
+    std::vector<std::thread> streamThreads;
+    for (auto& stream : streams)
+    {
+        streamThreads.emplace_back(&StreamRunner::run, stream.get());
     }
+    for (auto& streamThread : streamThreads)
+    {
+        streamThread.join();
+    }
+
+    // Every stream has drained its detections; the exporter writes its final metrics while the runners still exist
+    metricsExporter.reset();
+    streams.clear();
+    Logger::instance().shutdown();
     return 0;
 }
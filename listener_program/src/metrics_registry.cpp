@@ -0,0 +1,45 @@
+#include "metrics_registry.h"
+
+/**
+ * @brief The counter's exported name, without the freewilli_ prefix and _total suffix.
+ */
+const char* MetricsRegistry::name(MetricCounter counter)
+{
+    switch (counter)
+    {
+        case MetricCounter::WindowsProcessed:
+            return "windows_processed";
+        case MetricCounter::TimeDomainDetections:
+            return "time_domain_detections";
+        case MetricCounter::FrequencyDomainDetections:
+            return "frequency_domain_detections";
+        case MetricCounter::ClassifierRejections:
+            return "classifier_rejections";
+        case MetricCounter::PacketGaps:
+            return "packet_gaps";
+        case MetricCounter::Flushes:
+            return "flushes";
+        case MetricCounter::KernelDrops:
+            return "kernel_drops";
+        case MetricCounter::Count:
+            break;
+    }
+    return "unknown";
+}
+
+/**
+ * @brief The gauge's exported name, without the freewilli_ prefix.
+ */
+const char* MetricsRegistry::name(MetricGauge gauge)
+{
+    switch (gauge)
+    {
+        case MetricGauge::QueueHighWaterMark:
+            return "queue_depth_high_water_mark";
+        case MetricGauge::TrackerFilters:
+            return "tracker_filters";
+        case MetricGauge::Count:
+            break;
+    }
+    return "unknown";
+}
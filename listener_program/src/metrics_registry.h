@@ -0,0 +1,89 @@
+#pragma once
+#include "latency_histogram.h"
+#include "pch.h"
+
+/**
+ * @brief Monotonic per-stream event counts exported by MetricsExporter.
+ */
+enum class MetricCounter : uint8_t
+{
+    WindowsProcessed,  ///< Windows the decode stage analysed, i.e. neither still filling nor dropped by load shedding.
+    TimeDomainDetections,  ///< Windows that passed the time-domain detector.
+    FrequencyDomainDetections,  ///< Windows that passed the frequency-domain detector.
+    ClassifierRejections,  ///< Windows the classifier labelled as noise.
+    PacketGaps,  ///< Runs of missing packets zero-filled by resync; a run across windows counts in each window.
+    Flushes,  ///< Batches of detections written to disk.
+    KernelDrops,  ///< Datagrams the kernel dropped because the socket's receive buffer was full.
+    Count
+};
+
+/**
+ * @brief Per-stream values that go up and down, exported by MetricsExporter.
+ */
+enum class MetricGauge : uint8_t
+{
+    QueueHighWaterMark,  ///< Deepest the packet queue has been since startup.
+    TrackerFilters,  ///< Kalman filters the tracker currently maintains.
+    Count
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief The counters and gauges of one stream, for the hot path to update and MetricsExporter to read.
+ *
+ * Every value sits on its own cache line and is updated with relaxed atomics, so the listener, the pipeline stages
+ * and the writer thread can each bump their own counters without contending, and the exporter can read them at any
+ * time without stopping anyone. Values are cumulative over the life of the process; stream restarts keep them.
+ */
+class MetricsRegistry
+{
+   public:
+    void add(MetricCounter counter, uint64_t amount = 1)
+    {
+        mCounters[static_cast<size_t>(counter)].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void set(MetricGauge gauge, uint64_t value)
+    {
+        mGauges[static_cast<size_t>(gauge)].value.store(value, std::memory_order_relaxed);
+    }
+
+    /** @brief Raises the gauge to value if that is higher, for high-water marks. */
+    void raise(MetricGauge gauge, uint64_t value)
+    {
+        std::atomic<uint64_t>& current = mGauges[static_cast<size_t>(gauge)].value;
+        uint64_t previous = current.load(std::memory_order_relaxed);
+        while (value > previous && !current.compare_exchange_weak(previous, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    uint64_t value(MetricCounter counter) const
+    {
+        return mCounters[static_cast<size_t>(counter)].value.load(std::memory_order_relaxed);
+    }
+
+    uint64_t value(MetricGauge gauge) const
+    {
+        return mGauges[static_cast<size_t>(gauge)].value.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Time the writer thread takes to write one batch of detections. */
+    LatencyHistogram& flushDuration() { return mFlushDuration; }
+    const LatencyHistogram& flushDuration() const { return mFlushDuration; }
+
+    static const char* name(MetricCounter counter);
+    static const char* name(MetricGauge gauge);
+
+   private:
+    static constexpr size_t mCacheLineSize = 64;
+
+    struct alignas(mCacheLineSize) PaddedValue
+    {
+        std::atomic<uint64_t> value = 0;
+    };
+
+    std::array<PaddedValue, static_cast<size_t>(MetricCounter::Count)> mCounters{};
+    std::array<PaddedValue, static_cast<size_t>(MetricGauge::Count)> mGauges{};
+    alignas(mCacheLineSize) LatencyHistogram mFlushDuration;
+};
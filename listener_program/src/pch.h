@@ -1,14 +1,25 @@
 #pragma once
 // Standard C++ Library Headers
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
+#include <charconv>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <mutex>
+#include <numeric>
 #include <optional>
 #include <queue>
 #include <random>
@@ -19,20 +30,29 @@
 #include <string>
 #include <thread>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 // System Headers
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <fftw3.h>
 #include <netinet/in.h>
 #include <onnxruntime_cxx_api.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 #include <eigen3/Eigen/Dense>
 #include <nlohmann/json.hpp>  // Use a JSON library to load JSON data
 
 using TimePoint = std::chrono::system_clock::time_point;
+using PacketView = std::span<const uint8_t>;  // read-only view of one received datagram
 
 #ifdef __ARM_NEON
 #include <arm_neon.h>  // Include NEON intrinsics
@@ -1,37 +1,169 @@
 #include "pipeline.h"
 
+#include "logger.h"
 #include "pch.h"
 #include "utils.h"
 
+namespace
+{
+/**
+ * @brief Resolves the configured window hop; 0 selects non-overlapping windows.
+ * @throws std::invalid_argument If the hop is negative or longer than the window.
+ */
+int windowHopPackets(int configuredHop, int windowPackets)
+{
+    if (configuredHop < 0 || configuredHop > windowPackets)
+    {
+        throw std::invalid_argument(
+            "windowHopPackets must be between 1 and " + std::to_string(windowPackets) + ", or 0 for no overlap");
+    }
+    return configuredHop == 0 ? windowPackets : configuredHop;
+}
+
+/**
+ * @brief Resolves the cores of the stage threads; empty when the stages run serially on the pipeline thread.
+ * @throws std::invalid_argument If staged and stageCores does not give one core (or -1) per stage.
+ */
+std::vector<int> stageCores(const PipelineVariables& pipelineVariables, size_t numStages)
+{
+    if (!pipelineVariables.enableStagedPipeline)
+    {
+        return {};
+    }
+    if (pipelineVariables.stageCores.size() != numStages)
+    {
+        throw std::invalid_argument(
+            "stageCores needs one core (or -1) for each of the " + std::to_string(numStages) +
+            " spectral, classify, localise and output stages");
+    }
+    return pipelineVariables.stageCores;
+}
+
+/**
+ * @brief Resolves the cores of the window workers, one per worker; workers without a listed core are left unpinned.
+ * @throws std::invalid_argument If windowWorkers is negative, combined with the staged pipeline, or given fewer
+ * workers than workerCores lists.
+ */
+std::vector<int> workerCores(const PipelineVariables& pipelineVariables)
+{
+    const int numWorkers = pipelineVariables.windowWorkers;
+    if (numWorkers < 0)
+    {
+        throw std::invalid_argument("windowWorkers must not be negative");
+    }
+    if (numWorkers > 0 && pipelineVariables.enableStagedPipeline)
+    {
+        throw std::invalid_argument("windowWorkers and enableStagedPipeline cannot be combined");
+    }
+    if (pipelineVariables.workerCores.size() > static_cast<size_t>(numWorkers))
+    {
+        throw std::invalid_argument("workerCores lists more cores than there are windowWorkers");
+    }
+    std::vector<int> cores = pipelineVariables.workerCores;
+    cores.resize(numWorkers, -1);
+    return cores;
+}
+
+/// Prints a matrix on one line as "[a, b, c; d, e, f; ...]", for log messages.
+const Eigen::IOFormat singleLineMatrixFormat(Eigen::StreamPrecision, Eigen::DontAlignCols, ", ", "; ", "", "", "[", "]");
+}  // namespace
+
+const std::array<Pipeline::Stage, 4> Pipeline::mStages = {{
+    {"spectral", &Pipeline::filterWindow},
+    {"classify", &Pipeline::classifyWindow},
+    {"localise", &Pipeline::localiseWindow},
+    {"output", &Pipeline::outputWindow},
+}};
+
 /**
  * @brief Constructs a Pipeline object and initializes necessary components.
  *
  * @param sharedSess Reference to a SharedDataManager object for managing shared
  * resources.
  * @param pipelineVariables Configuration parameters for the pipeline.
+ * @param sharedResources Source of read-only state (ONNX model, filter spectrum) shared with other streams' pipelines.
  */
 Pipeline::Pipeline(
-    OutputManager& outputManager, SharedDataManager& sharedDataManager, const PipelineVariables& pipelineVariables)
+    OutputManager& outputManager, SharedDataManager& sharedDataManager, const PipelineVariables& pipelineVariables,
+    SharedPipelineResources& sharedResources)
     : mFirmwareConfig(FirmwareFactory::create(pipelineVariables.firmware)),
       mOutputManager(outputManager),
       mSharedDataManager(sharedDataManager),
-      mSpeedOfSound(pipelineVariables.speedOfSound),
-      mReceiverPositionsPath(pipelineVariables.receiverPositionsPath),
-      mFilter(IFrequencyDomainStrategyFactory::create(
-          pipelineVariables.frequencyDomainStrategy, pipelineVariables.filterWeightsPath, mChannelData,
-          mFirmwareConfig->numChannels())),
       mTimeDomainDetector(ITimeDomainDetectorFactory::create(
           pipelineVariables.timeDomainDetector, pipelineVariables.timeDomainThreshold)),
-      mFrequencyDomainDetector(IFrequencyDomainDetectorFactory::create(
-          pipelineVariables.frequencyDomainDetector, pipelineVariables.energyDetectionThreshold)),
-      mTracker(ITracker::create(pipelineVariables)),
-      mOnnxModel(IONNXModel::create(pipelineVariables)),
-      mChannelData(Eigen::MatrixXf::Zero(mFirmwareConfig->numChannels(), mFirmwareConfig->channelSize())),
-      mComputeTDOAs(
-          mFilter->getPaddedLength(), mFilter->getFrequencyDomainData().rows(), mFirmwareConfig->numChannels(),
-          mFirmwareConfig->sampleRate())
+      mTracker(ITracker::create(pipelineVariables, outputManager.livePublisher())),
+      mWindowHopPackets(windowHopPackets(pipelineVariables.windowHopPackets, mFirmwareConfig->numPacketsToDetect())),
+      mChannelRing(*mFirmwareConfig, mFirmwareConfig->numPacketsToDetect()),
+      mStageCores(stageCores(pipelineVariables, mStages.size())),
+      mWorkerCores(workerCores(pipelineVariables)),
+      mJobsInFlight(std::max<size_t>(16, 4 * mWorkerCores.size()))
+{
+    Eigen::MatrixXf hydrophonePositions = getHydrophoneRelativePositions(pipelineVariables.receiverPositionsPath);
+    auto [precomputedP, basisMatrixU, rankOfHydrophoneMatrix] = hydrophoneMatrixDecomposition(hydrophonePositions);
 
+    // precompute the leastsquares matrix. Use for efficient DOA estiation
+    mCachedLeastSquaresResult = precomputedP * basisMatrixU.transpose() * pipelineVariables.speedOfSound;
+    mRankOfHydrophoneMatrix = rankOfHydrophoneMatrix;
+
+    dataBytes.resize(mWindowHopPackets);
+    dataTimes.resize(mWindowHopPackets);
+
+    // Shedding pauses the listener and lets the kernel drop datagrams, so it needs gaps to be bridged, not thrown on
+    if (pipelineVariables.enableStreamResync || pipelineVariables.enableLoadShedding)
+    {
+        // Bridge gaps of up to one window; anything longer re-anchors the stream rather than emitting empty windows
+        mStreamResync = std::make_unique<StreamResync>(
+            mFirmwareConfig->microIncre(), mWindowHopPackets, mFirmwareConfig->numPacketsToDetect());
+    }
+
+    mTimeDomainThreshold = pipelineVariables.timeDomainThreshold;
+    if (pipelineVariables.enableLoadShedding)
+    {
+        mLoadShedder = std::make_unique<LoadShedder>(
+            pipelineVariables.loadSheddingEnterQueueDepths, pipelineVariables.loadSheddingExitQueueDepths,
+            pipelineVariables.loadSheddingThresholdScale);
+    }
+
+    std::shared_ptr<ONNXModel> onnxModel = sharedResources.onnxModel(pipelineVariables);
+    if (pipelineVariables.enableAsyncClassifier && onnxModel)
+    {
+        mAsyncClassifier = std::make_unique<AsyncClassifier>(
+            [onnxModel](std::vector<float>& features) { return onnxModel->runInference(features); },
+            mClassifierQueueCapacity, std::chrono::milliseconds(pipelineVariables.classifierDeadlineMs),
+            pipelineVariables.classifierCore);
+    }
+
+    // Each worker plans its own FFTs; planning is not thread-safe, so it is all done here
+    const size_t numAnalyzers = std::max<size_t>(1, mWorkerCores.size());
+    for (size_t i = 0; i < numAnalyzers; i++)
+    {
+        mAnalyzers.push_back(std::make_unique<WindowAnalyzer>(
+            pipelineVariables, *mFirmwareConfig, sharedResources, mCachedLeastSquaresResult, mRankOfHydrophoneMatrix,
+            mSharedDataManager.metrics, mLoadShedder.get(), mAsyncClassifier.get()));
+    }
+}
+
+/**
+ * @brief Discards per-stream state so the pipeline can process a restarted stream.
+ *
+ * Filters, FFT plans, the ONNX model, the hydrophone decomposition and the tracker are stream-independent and are
+ * kept, so a listener restart does not pay for rebuilding them. Must only be called while process() is not running.
+ */
+void Pipeline::resetStream()
 {
+    std::fill(dataBytes.begin(), dataBytes.end(), PacketView());
+    mQueuedPackets.clear();
+    mQueuedTimes.clear();
+    mChannelRing.reset();
+    mDetectionLatency.reset();
+    if (mStreamResync)
+    {
+        mStreamResync->reset();
+    }
+    if (mLoadShedder)
+    {
+        mLoadShedder->reset();
+    }
 }
 
 /**
@@ -40,6 +172,7 @@ Pipeline::Pipeline(
  */
 void Pipeline::process()
 {
+    startThreads();
     try
     {
         dataProcessor();
@@ -48,143 +181,616 @@ void Pipeline::process()
     {
         handleProcessingError(e);
     }
+    stopThreads();
 }
 
 /**
  * @brief Processes data segments from the shared buffer.
  *
- * Applies filters, performs analysis, and manages data processing pipeline
- * operations.
+ * Decodes each hop on this thread and hands it to the remaining stages, either by running them in turn or by queueing
+ * it for the stage threads or window workers.
  */
 void Pipeline::dataProcessor()
 {
-    Eigen::MatrixXf hydrophonePositions = getHydrophoneRelativePositions(mReceiverPositionsPath);
-    auto [precomputedP, basisMatrixU, rankOfHydrophoneMatrix] = hydrophoneMatrixDecomposition(hydrophonePositions);
-
-    // precompute the leastsquares matrix. Use for efficient DOA estiation
-    Eigen::MatrixXf cachedLeastSquaresResult = precomputedP * basisMatrixU.transpose() * mSpeedOfSound;
-
     bool previousTimeSet = false;
     auto previousTime = TimePoint::min();
-    dataBytes.resize(mFirmwareConfig->numPacketsToDetect());
 
     // call function once outside of the loop below to initialize files.
-    initializeOutputFiles(previousTimeSet, previousTime);
+    if (!initializeOutputFiles(previousTimeSet, previousTime))
+    {
+        return;
+    }
+    mLastLatencyReport = std::chrono::steady_clock::now();
 
-    while (!mSharedDataManager.errorOccurred)
+    const bool serial = mStageCores.empty() && mWorkerCores.empty();
+    std::unique_ptr<WindowJob> job;
+    while (!mSharedDataManager.errorOccurred && !isProgramStopRequested())
     {
-        obtainAndProcessByteData(previousTimeSet, previousTime);
-        mOutputManager.terminateProgramIfNecessary();
+        if (!obtainAndProcessByteData(previousTimeSet, previousTime))
+        {
+            return;  // the listener failed or the program is stopping
+        }
+        reportStatisticsIfNecessary();
 
-        mOutputManager.flushBufferIfNecessary();
+        if (serial)
+        {
+            decodeWindow(mSerialJob);
+            for (const Stage& stage : mStages)
+            {
+                (this->*stage.process)(mSerialJob);
+            }
+            continue;
+        }
 
-        if (mTracker)
+        // Waits while every job is in flight; fails only once the threads have been shut down
+        if (!mFreeJobs->pop(job))
         {
-            mTracker->scheduleCluster();
+            return;
         }
-        if (!mTimeDomainDetector->detect(mChannelData.row(0)))
+        decodeWindow(*job);
+        job->sequence = mNextSequence++;
+        if (!dispatch(job))
         {
-            continue;
+            return;
         }
+    }
+}
 
-        // std::cout << "apply addr channelData: " << mChannelData.data() <<
-        // std::endl;
-        mFilter->apply();
-        Eigen::MatrixXcf savedFFTs = mFilter->getFrequencyDomainData();
+/**
+ * @brief Starts the stage threads, or the window workers and the reassembly thread, with fresh queues and jobs.
+ * Does nothing when the stages run serially.
+ */
+void Pipeline::startThreads()
+{
+    if (mStageCores.empty() && mWorkerCores.empty())
+    {
+        return;
+    }
+    mNextSequence = 0;
+    mFreeJobs = std::make_unique<JobQueue>(mJobsInFlight);
+    for (size_t i = 0; i < mJobsInFlight; i++)
+    {
+        auto job = std::make_unique<WindowJob>();
+        mFreeJobs->tryPush(job);
+    }
+
+    if (!mStageCores.empty())
+    {
+        for (std::unique_ptr<JobQueue>& queue : mStageQueues)
+        {
+            queue = std::make_unique<JobQueue>(mJobsInFlight);
+        }
+        for (size_t i = 0; i < mStages.size(); i++)
+        {
+            mThreads.emplace_back(&Pipeline::runStage, this, i);
+            pinThreadToCore(mThreads.back(), mStageCores[i]);
+        }
+        return;
+    }
 
-        // std::cout << "creat addr mSavedFFTs: " << savedFFTs.data() <<
-        // std::endl;
-        Eigen::MatrixXcf beforeFilter = mFilter->mBeforeFilter;
+    mWorkerInputs.clear();
+    mWorkerOutputs.clear();
+    for (size_t i = 0; i < mWorkerCores.size(); i++)
+    {
+        mWorkerInputs.push_back(std::make_unique<JobQueue>(mJobsInFlight));
+        mWorkerOutputs.push_back(std::make_unique<JobQueue>(mJobsInFlight));
+    }
+    for (size_t i = 0; i < mWorkerCores.size(); i++)
+    {
+        mThreads.emplace_back(&Pipeline::runWorker, this, i);
+        pinThreadToCore(mThreads.back(), mWorkerCores[i]);
+    }
+    mThreads.emplace_back(&Pipeline::runReassembly, this);
+}
 
-        if (!mFrequencyDomainDetector->detect(savedFFTs.col(0)))
+/**
+ * @brief Drains the jobs still in flight through the remaining stages, then joins the threads.
+ *
+ * Queues are closed and threads joined in stage order: a closed queue still hands out the jobs queued before it, so
+ * each thread finishes what its predecessors left it before its own output is closed, and the last windows of a
+ * session are written out rather than discarded. Called after decode has stopped queueing jobs.
+ */
+void Pipeline::stopThreads()
+{
+    if (mThreads.empty())
+    {
+        return;
+    }
+    if (!mStageCores.empty())
+    {
+        for (size_t i = 0; i < mThreads.size(); i++)
         {
-            continue;
+            mStageQueues[i]->close();
+            mThreads[i].join();
         }
+    }
+    else
+    {
+        for (size_t i = 0; i < mWorkerInputs.size(); i++)
+        {
+            mWorkerInputs[i]->close();
+            mThreads[i].join();
+        }
+        for (const std::unique_ptr<JobQueue>& finished : mWorkerOutputs)
+        {
+            finished->close();
+        }
+        mJobsFinished.fetch_add(1, std::memory_order_release);
+        mJobsFinished.notify_all();
+        mThreads.back().join();
+    }
+    mFreeJobs->close();
+    mThreads.clear();
+}
 
-        if (mOnnxModel)
+void Pipeline::closeQueues()
+{
+    auto closeQueue = [](const std::unique_ptr<JobQueue>& queue)
+    {
+        if (queue)
         {
-            // std::vector<float> input_tensor_values = getExampleClick();
-            Eigen::VectorXf spectraToInference = beforeFilter.array().abs();
+            queue->close();
+        }
+    };
+    closeQueue(mFreeJobs);
+    std::for_each(mStageQueues.begin(), mStageQueues.end(), closeQueue);
+    std::for_each(mWorkerInputs.begin(), mWorkerInputs.end(), closeQueue);
+    std::for_each(mWorkerOutputs.begin(), mWorkerOutputs.end(), closeQueue);
+    mJobsFinished.fetch_add(1, std::memory_order_release);
+    mJobsFinished.notify_all();
+}
 
-            // std::cout << "Inference spectra: " << std::endl;
-            // std::cout << spectraToInference.tail(500).head(5).transpose() << std::endl;
-            // std::cout << spectraToInference.tail(500).tail(5).transpose() << std::endl;
+/**
+ * @brief Hands a decoded job to the first stage, or to the window worker with the fewest jobs waiting.
+ * @return False once the threads have been shut down.
+ */
+bool Pipeline::dispatch(std::unique_ptr<WindowJob>& job)
+{
+    if (!mStageCores.empty())
+    {
+        return mStageQueues.front()->push(job);
+    }
+    // Scan from the worker after the last one used, so idle workers share the load instead of the first taking all
+    const size_t numWorkers = mWorkerInputs.size();
+    size_t chosen = job->sequence % numWorkers;
+    for (size_t offset = 1; offset < numWorkers; offset++)
+    {
+        const size_t worker = (job->sequence + offset) % numWorkers;
+        if (mWorkerInputs[worker]->size() < mWorkerInputs[chosen]->size())
+        {
+            chosen = worker;
+        }
+    }
+    return mWorkerInputs[chosen]->push(job);
+}
 
-            Eigen::VectorXf spectraToInferenceFinal = spectraToInference.tail(500);
-            std::vector<float> spectraVector(
-                spectraToInferenceFinal.data(), spectraToInferenceFinal.data() + spectraToInferenceFinal.size());
-            std::vector<float> output = mOnnxModel->runInference(spectraVector);
-            // std::cout << "Classification: \n";
-            // for (const auto& val : output)
-            //{
-            //     std::cout << val << " ";
-            // }
-            // std::cout << std::endl;
-            if (output[1] < output[0])
+/**
+ * @brief Stage thread body: applies one stage to each job from its input queue and passes the job on, until the
+ * input is closed and drained.
+ */
+void Pipeline::runStage(size_t stageIndex)
+{
+    const Stage& stage = mStages[stageIndex];
+    JobQueue& input = *mStageQueues[stageIndex];
+    JobQueue& output = (stageIndex + 1 < mStageQueues.size()) ? *mStageQueues[stageIndex + 1] : *mFreeJobs;
+    try
+    {
+        std::unique_ptr<WindowJob> job;
+        while (input.pop(job))
+        {
+            (this->*stage.process)(*job);
+            if (!output.push(job))
             {
-                std::cout << "Noise detected: \n";
-                continue;
+                return;
             }
         }
-        mSharedDataManager.detectionCounter++;
-        auto beforeGCC = std::chrono::steady_clock::now();
-        auto tdoasAndXCorrAmps = mComputeTDOAs.process(savedFFTs);
-        auto afterGCC = std::chrono::steady_clock::now();
-        std::chrono::duration<double> duration = afterGCC - beforeGCC;
-        std::cout << "GCC time: " << duration.count() << std::endl;
-
-        Eigen::VectorXf tdoaVector = std::get<0>(tdoasAndXCorrAmps);
-        Eigen::VectorXf directionOfArrival =
-            computeDoaFromTdoa(cachedLeastSquaresResult, tdoaVector, rankOfHydrophoneMatrix);
-        Eigen::VectorXf azimuthAndElevation = convertDoaToElAz(directionOfArrival);
-        std::cout << "AzEl: " << azimuthAndElevation << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        handleThreadError(std::string(stage.name) + " stage", e);
+    }
+}
 
-        mOutputManager.appendToBuffer(
-            mTimeDomainDetector->getLastDetection(), directionOfArrival[0], directionOfArrival[1],
-            directionOfArrival[2], tdoaVector, std::get<1>(tdoasAndXCorrAmps), dataTimes[0]);
+/**
+ * @brief Window worker body: runs spectral, classify and localise on each job with the worker's own analyzer.
+ */
+void Pipeline::runWorker(size_t workerIndex)
+{
+    WindowAnalyzer& analyzer = *mAnalyzers[workerIndex];
+    JobQueue& input = *mWorkerInputs[workerIndex];
+    JobQueue& output = *mWorkerOutputs[workerIndex];
+    try
+    {
+        std::unique_ptr<WindowJob> job;
+        while (input.pop(job))
+        {
+            analyzer.analyse(*job);
+            if (!output.push(job))
+            {
+                return;
+            }
+            mJobsFinished.fetch_add(1, std::memory_order_release);
+            mJobsFinished.notify_one();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        handleThreadError("window worker " + std::to_string(workerIndex), e);
+    }
+}
 
-        if (mTracker)  // check
+/**
+ * @brief Reassembly thread body: collects finished jobs from every worker and runs the output stage on them in
+ * sequence order, which is the order of the windows' timestamps.
+ */
+void Pipeline::runReassembly()
+{
+    ReorderBuffer<std::unique_ptr<WindowJob>> reorderBuffer(mJobsInFlight);
+    try
+    {
+        std::unique_ptr<WindowJob> job;
+        while (true)
         {
-            [[maybe_unused]] int label = -1;
-            mTracker->updateTrackerBuffer(directionOfArrival);
-            if (mTracker->mIsTrackerInitialized)
+            // Read before polling, so a job finished after the poll makes the wait below return at once
+            const uint32_t jobsFinished = mJobsFinished.load(std::memory_order_acquire);
+            // Outputs are closed only once their workers have stopped, so after this poll nothing more can arrive
+            const bool workersStopped = std::all_of(
+                mWorkerOutputs.begin(), mWorkerOutputs.end(),
+                [](const std::unique_ptr<JobQueue>& finished) { return finished->isClosed(); });
+            bool collected = false;
+            for (const std::unique_ptr<JobQueue>& finished : mWorkerOutputs)
             {
-                label = mTracker->updateKalmanFiltersContinuous(
-                    directionOfArrival, dataTimes[0]);  // NOLINT(clang-analyzer-deadcode.DeadStores)
-                // mOutputManager.saveSpectraForTraining("training_data_fill.csv", label, beforeFilter);
+                while (finished->tryPop(job))
+                {
+                    const uint64_t sequence = job->sequence;
+                    reorderBuffer.insert(sequence, std::move(job));
+                    collected = true;
+                }
+            }
+            while (reorderBuffer.popNext(job))
+            {
+                outputWindow(*job);
+                if (!mFreeJobs->push(job))
+                {
+                    return;
+                }
+            }
+            if (workersStopped)
+            {
+                return;
+            }
+            if (!collected)
+            {
+                mJobsFinished.wait(jobsFinished, std::memory_order_acquire);
             }
         }
+    }
+    catch (const std::exception& e)
+    {
+        handleThreadError("reassembly thread", e);
+    }
+}
+
+/**
+ * @brief Reports an error on a stage, worker or reassembly thread, flags the session and shuts the queues down so
+ * that no thread waits forever on the one that failed.
+ */
+void Pipeline::handleThreadError(const std::string& threadName, const std::exception& e)
+{
+    std::cerr << "Error occurred in " << threadName << ":\n" << e.what() << std::endl;
+    mSharedDataManager.errorOccurred = true;
+    closeQueues();
+}
+
+/**
+ * @brief Decode stage: picks the load shedding tier and runs the time-domain detector on the window now in the ring.
+ *
+ * Everything later stages need from the ring or the detectors is copied into the job, because the next hop overwrites
+ * it while they are still working.
+ */
+void Pipeline::decodeWindow(WindowJob& job)
+{
+    job.isCandidate = false;
+    job.scheduleCluster = false;
+    job.tier = OverloadTier::Normal;
+    job.classification = {};
 
-        if (mFirmwareConfig->getImuManager())
+    if (!mChannelRing.isFull())
+    {
+        return;  // still filling the first window after a (re)start
+    }
+    if (mLoadShedder)
+    {
+        job.tier = mLoadShedder->update(mSharedDataManager.queueSize());
+    }
+    if (job.tier == OverloadTier::DropWindows)
+    {
+        mLoadShedder->recordShed(ShedAction::WindowDropped);
+        return;
+    }
+    mSharedDataManager.metrics.add(MetricCounter::WindowsProcessed);
+    job.scheduleCluster = mTracker && job.tier < OverloadTier::SkipTracker;
+
+    const ChannelRingBuffer::Window window = mChannelRing.window();
+    bool detected;
+    {
+        TRACE_STAGE(TimeDomainDetector);
+        detected = mTimeDomainDetector->detect(window.row(0).transpose());
+    }
+    if (!detected || !isPeakInWindowCenter(mTimeDomainDetector->getLastDetectionIndex()))
+    {
+        return;
+    }
+    if (job.tier >= OverloadTier::RaiseThresholds &&
+        mTimeDomainDetector->getLastDetection() < mTimeDomainThreshold * mLoadShedder->thresholdScale())
+    {
+        mLoadShedder->recordShed(ShedAction::DetectionSuppressed);
+        return;
+    }
+
+    job.isCandidate = true;
+    mSharedDataManager.metrics.add(MetricCounter::TimeDomainDetections);
+    job.samples = window;
+    job.startTime = mChannelRing.windowStartTime();
+    job.arrivalTime = mWindowArrivalTime;
+    job.peakAmplitude = mTimeDomainDetector->getLastDetection();
+    job.rotation.reset();
+    if (mFirmwareConfig->getImuManager())
+    {
+        job.rotation = mFirmwareConfig->getImuManager()->getRotationMatrix();
+    }
+}
+
+/**
+ * @brief Output stage: housekeeping for every hop, then logging and tracking of detections.
+ *
+ * Owns the OutputManager and the tracker for as long as process() runs, so neither needs to be thread-safe.
+ */
+void Pipeline::outputWindow(WindowJob& job)
+{
+    mOutputManager.stopProgramIfNecessary();
+    mOutputManager.flushBufferIfNecessary();
+    if (job.scheduleCluster)
+    {
+        mTracker->scheduleCluster();
+    }
+    if (!job.isCandidate || !awaitClassification(job))
+    {
+        return;
+    }
+
+    mSharedDataManager.detectionCounter++;
+    const Eigen::VectorXf& directionOfArrival = job.directionOfArrival;
+    auto detectionLatency = std::chrono::system_clock::now() - job.arrivalTime;
+    mDetectionLatency.record(detectionLatency);
+    mOutputManager.appendToBuffer(
+        job.peakAmplitude, directionOfArrival[0], directionOfArrival[1], directionOfArrival[2], job.tdoas,
+        job.xCorrAmps, job.startTime, std::chrono::duration_cast<std::chrono::microseconds>(detectionLatency));
+
+    if (mTracker && job.tier >= OverloadTier::SkipTracker)
+    {
+        mLoadShedder->recordShed(ShedAction::TrackerUpdateSkipped);
+    }
+    else if (mTracker)  // check
+    {
+        TRACE_STAGE(Tracker);
+        [[maybe_unused]] int label = -1;
+        mTracker->updateTrackerBuffer(directionOfArrival);
+        if (mTracker->mIsTrackerInitialized)
         {
-            std::cout << mFirmwareConfig->getImuManager()->getRotationMatrix();
-            std::cout << std::endl;
+            label = mTracker->updateKalmanFiltersContinuous(
+                directionOfArrival, job.startTime);  // NOLINT(clang-analyzer-deadcode.DeadStores)
+            // mOutputManager.saveSpectraForTraining("training_data_fill.csv", label, job.unfilteredSpectra);
         }
+        mSharedDataManager.metrics.set(MetricGauge::TrackerFilters, mTracker->numFilters());
+    }
+
+    if (job.rotation)
+    {
+        LOG_DEBUG("pipeline", "IMU rotation: " << job.rotation->format(singleLineMatrixFormat));
     }
 }
-void Pipeline::initializeOutputFiles(bool& previousTimeSet, TimePoint& previousTime)
+
+bool Pipeline::initializeOutputFiles(bool& previousTimeSet, TimePoint& previousTime)
 {
-    obtainAndProcessByteData(previousTimeSet, previousTime);
+    if (!obtainAndProcessByteData(previousTimeSet, previousTime))
+    {
+        return false;
+    }
     mOutputManager.initializeOutputFile(dataTimes[0], mFirmwareConfig->numChannels());
     if (mTracker)
     {
         mTracker->initializeOutputFile(dataTimes[0]);
     }
+    return true;
 }
 
-void Pipeline::obtainAndProcessByteData(bool& previousTimeSet, TimePoint& previousTime)
+/**
+ * @brief Waits, up to its deadline, for the verdict of a window submitted to the asynchronous classifier.
+ * @return False if the window was classified as noise; true if it was not, or if no verdict is available in time.
+ */
+bool Pipeline::awaitClassification(WindowJob& job)
 {
-    mSharedDataManager.waitForData(dataBytes, mFirmwareConfig->numPacketsToDetect());
+    if (!mAsyncClassifier)
+    {
+        return true;
+    }
+    std::optional<std::vector<float>> output = mAsyncClassifier->await(job.classification);
+    if (output && ONNXModel::isNoise(*output))
+    {
+        LOG_DEBUG("classifier", "Noise detected");
+        mSharedDataManager.metrics.add(MetricCounter::ClassifierRejections);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Blocks until the packets of the next hop arrive, then validates them and decodes them into the channel ring.
+ * @return False if the session errored while waiting, in which case no data was decoded.
+ */
+bool Pipeline::obtainAndProcessByteData(bool& previousTimeSet, TimePoint& previousTime)
+{
+    if (mStreamResync)
+    {
+        return obtainAndResyncByteData();
+    }
 
-    dataTimes = mFirmwareConfig->generateTimestamp(dataBytes);
+    if (!mSharedDataManager.waitForData(dataBytes, mWindowHopPackets))
+    {
+        return false;
+    }
+    TRACE_STAGE(Decode);
+
+    mFirmwareConfig->generateTimestamp(dataBytes, dataTimes);
 
     mFirmwareConfig->throwIfDataErrors(dataBytes, previousTimeSet, previousTime, dataTimes);
 
-    // auto before2l = std::chrono::steady_clock::now();
-    mFirmwareConfig->insertDataIntoChannelMatrix(mChannelData, dataBytes);
-    // auto after2l = std::chrono::steady_clock::now();
-    // std::chrono::duration<double> duration2l = after2l - before2l;
-    //  std::cout << "append : " << duration2l.count() << std::endl;
+    mChannelRing.push(dataBytes, dataTimes);
+
+    // The window could be processed as soon as its last packet arrived, so latency is measured from there
+    mWindowArrivalTime = mSharedDataManager.arrivalTime(mWindowHopPackets - 1);
+
+    // The packets are fully decoded, so their ring slots can be reused by the listener
+    mSharedDataManager.releaseData(mWindowHopPackets);
+    return true;
+}
+
+/**
+ * @brief Resync-mode counterpart of obtainAndProcessByteData that bridges gaps in the stream instead of throwing.
+ *
+ * Missing packets are zero-filled in the channel matrix and counted, duplicate or late packets are dropped, and a
+ * discontinuity re-anchors the stream on the next packet. Packets with the wrong size still throw, since they
+ * indicate a firmware mismatch or corruption that only a restart can address.
+ *
+ * @return False if the session errored while waiting, in which case no data was decoded.
+ */
+bool Pipeline::obtainAndResyncByteData()
+{
+    const int windowSize = mWindowHopPackets;  // the resync plans one hop of positions at a time
+    int numPacketsToPeek = windowSize;
+
+    while (true)
+    {
+        mQueuedPackets.resize(numPacketsToPeek);
+        mQueuedTimes.resize(numPacketsToPeek);
+        if (!mSharedDataManager.waitForData(mQueuedPackets, numPacketsToPeek))
+        {
+            return false;
+        }
+        TRACE_STAGE(Decode);
+
+        for (const PacketView& packet : mQueuedPackets)
+        {
+            if (packet.size() != mFirmwareConfig->packetSize())
+            {
+                std::stringstream errorMsg;
+                errorMsg << "Error: Incorrect number of bytes in packet. Expected: " << mFirmwareConfig->packetSize()
+                         << ", Received: " << packet.size() << std::endl;
+                throw std::runtime_error(errorMsg.str());
+            }
+        }
+        mFirmwareConfig->generateTimestamp(mQueuedPackets, mQueuedTimes);
+
+        const WindowPlan& plan = mStreamResync->planWindow(mQueuedTimes);
+        if (plan.resynced)
+        {
+            mSharedDataManager.resyncCounter++;
+            mSharedDataManager.packetsDiscarded += plan.packetsDiscarded;
+            mSharedDataManager.releaseData(plan.packetsConsumed);
+            numPacketsToPeek = windowSize;
+            continue;
+        }
+        if (!plan.complete)
+        {
+            // Dropped duplicates left the window short; look further ahead, but not indefinitely
+            if (++numPacketsToPeek > 2 * windowSize)
+            {
+                throw std::runtime_error("Error: Unable to resynchronise packet stream\n");
+            }
+            continue;
+        }
+
+        for (int position = 0; position < windowSize; position++)
+        {
+            const int packet = plan.packetForPosition[position];
+            dataBytes[position] = (packet < 0) ? PacketView() : mQueuedPackets[packet];
+            dataTimes[position] = plan.positionTimes[position];
+            if (packet < 0 && (position == 0 || plan.packetForPosition[position - 1] >= 0))
+            {
+                mSharedDataManager.metrics.add(MetricCounter::PacketGaps);
+            }
+        }
+        mSharedDataManager.packetsLost += plan.packetsMissing;
+        mSharedDataManager.packetsDiscarded += plan.packetsDiscarded;
+
+        mChannelRing.push(dataBytes, dataTimes);
+
+        mWindowArrivalTime = mSharedDataManager.arrivalTime(std::max(plan.packetsConsumed - 1, 0));
+        mSharedDataManager.releaseData(plan.packetsConsumed);
+        return true;
+    }
+}
+
+/**
+ * @brief True if a peak at peakIndex (in samples from the window start) lies in the window's central hop.
+ *
+ * Successive windows' central hops tile the stream, so with overlapping windows a click is reported once, by the
+ * window in which it is closest to the middle, instead of by every window it appears in. Without overlap the central
+ * hop is the whole window.
+ */
+bool Pipeline::isPeakInWindowCenter(int peakIndex) const
+{
+    const int samplesPerPacket = mFirmwareConfig->channelSize() / mFirmwareConfig->numPacketsToDetect();
+    const int hopSamples = mWindowHopPackets * samplesPerPacket;
+    const int centerStart = (mFirmwareConfig->channelSize() - hopSamples) / 2;
+    return peakIndex >= centerStart && peakIndex < centerStart + hopSamples;
+}
+
+/**
+ * @brief Once per report interval, prints the packet-arrival-to-output latency distribution (then starts a new one)
+ * and, if anything was shed since the last report or load is still being shed, the load shedding summary. The
+ * asynchronous classifier's queue depth and misses, and the live output's sent and dropped messages, are printed
+ * whenever these are enabled, and the stage timings in tracing builds.
+ */
+void Pipeline::reportStatisticsIfNecessary()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now - mLastLatencyReport < mLatencyReportInterval)
+    {
+        return;
+    }
+    if (mDetectionLatency.count() > 0)
+    {
+        LOG_INFO("pipeline", "Detection latency " << mDetectionLatency.summary());
+        mDetectionLatency.reset();
+    }
+    if (mLoadShedder)
+    {
+        // The listener counts the datagrams the kernel dropped while it waited out a full queue
+        const auto kernelDrops = static_cast<uint64_t>(mSharedDataManager.packetsDroppedByKernel.load());
+        mLoadShedder->recordShed(
+            ShedAction::PacketDroppedByKernel,
+            kernelDrops - mLoadShedder->shedCount(ShedAction::PacketDroppedByKernel));
+    }
+    if (mLoadShedder &&
+        (mLoadShedder->totalShed() != mLastReportedShedCount || mLoadShedder->tier() != OverloadTier::Normal))
+    {
+        LOG_INFO("pipeline", "Load shedding " << mLoadShedder->summary());
+        mLastReportedShedCount = mLoadShedder->totalShed();
+    }
+    if (mAsyncClassifier)
+    {
+        LOG_INFO("pipeline", "Async classifier " << mAsyncClassifier->summary());
+    }
+    if (LivePublisher* livePublisher = mOutputManager.livePublisher())
+    {
+        LOG_INFO("pipeline", "Live output " << livePublisher->summary());
+    }
+#ifdef FREEWILLI_TRACING
+    StageTracer::instance().reportIfNecessary(mLatencyReportInterval);
+#endif
+    mLastLatencyReport = now;
 }
 
 /**
@@ -7,42 +7,124 @@
 #include "algorithms/gcc_phat.h"
 #include "algorithms/hydrophone_position_processing.h"
 #include "algorithms/time_domain_detectors_factory.h"
+#include "channel_ring_buffer.h"
 #include "firmware/firmware_factory.h"
 #include "firmware/firmware_interface.h"
 #include "io/output_manager.h"
 #include "io/udp_socket_manager.h"
+#include "latency_histogram.h"
+#include "load_shedder.h"
+#include "reorder_buffer.h"
 #include "shared_data_manager.h"
+#include "shared_pipeline_resources.h"
+#include "spsc_queue.h"
+#include "stage_tracer.h"
+#include "stream_resync.h"
 #include "tracker/tracker.h"
+#include "window_analyzer.h"
+#include "window_job.h"
 
 class PipelineVariables;
 
+/**
+ * @class Pipeline
+ * @brief Turns one stream's packets into detections, localisations and tracks.
+ *
+ * Each hop of packets passes through five stages: decode (packet validation, the channel ring, load shedding and the
+ * time-domain detector), spectral (FFT filtering and the frequency-domain detector), classify (ONNX), localise
+ * (GCC-PHAT and DOA) and output (detection log, tracker and housekeeping). By default all five run one after the other
+ * on the pipeline thread. With enableStagedPipeline, decode stays on the pipeline thread and the other four each get a
+ * thread, connected in a chain of bounded lock-free queues through which every hop travels as a WindowJob; the output
+ * stage hands finished jobs back to decode. Each queue is first in, first out, so the tracker and the output log see
+ * windows in stream order, and once every job is in flight decode waits, pushing backlog into the packet queue where
+ * load shedding can see it.
+ *
+ * With windowWorkers instead, spectral, classify and localise run together on each of N worker threads, each with its
+ * own WindowAnalyzer, and decode hands every window to the least busy worker. Workers finish out of order, so a
+ * reassembly thread puts their jobs back into sequence with a ReorderBuffer before running the output stage, which
+ * stays single-threaded.
+ */
 class Pipeline
 {
    public:
-    Pipeline(OutputManager& outputManager, SharedDataManager& sharedSess, const PipelineVariables& pipelineVariables);
+    Pipeline(
+        OutputManager& outputManager, SharedDataManager& sharedSess, const PipelineVariables& pipelineVariables,
+        SharedPipelineResources& sharedResources);
 
     void process();
 
+    void resetStream();
+
    private:
     // Private member variables
     OutputManager& mOutputManager;
     SharedDataManager& mSharedDataManager;
 
-    const float mSpeedOfSound;
-    std::string mReceiverPositionsPath;
-    std::vector<std::vector<uint8_t>> dataBytes;
+    Eigen::MatrixXf mCachedLeastSquaresResult;  ///< Precomputed least-squares matrix for DOA estimation.
+    int mRankOfHydrophoneMatrix = 0;
+    std::vector<PacketView> dataBytes;  ///< Views into the shared packet ring for the packets of the current hop.
     std::vector<TimePoint> dataTimes;
+    std::vector<PacketView> mQueuedPackets;  ///< Packets at the head of the ring, before gap resolution (resync mode).
+    std::vector<TimePoint> mQueuedTimes;  ///< Timestamps of mQueuedPackets.
+    TimePoint mWindowArrivalTime;  ///< Socket arrival time of the last packet of the current window.
+
+    LatencyHistogram mDetectionLatency;  ///< Packet arrival to detection output, over the current report interval.
+    std::chrono::steady_clock::time_point mLastLatencyReport;
+    static constexpr std::chrono::seconds mLatencyReportInterval{10};
 
     std::unique_ptr<const IFirmware> mFirmwareConfig = nullptr;
-    Eigen::MatrixXf mChannelData;
-    std::unique_ptr<IFrequencyDomainStrategy> mFilter = nullptr;
+    const int mWindowHopPackets;  ///< Packets the analysis window advances by; numPacketsToDetect() if windows abut.
+    ChannelRingBuffer mChannelRing;  ///< Decoded samples of the current window.
     std::unique_ptr<ITimeDomainDetector> mTimeDomainDetector = nullptr;
-    std::unique_ptr<IFrequencyDomainDetector> mFrequencyDomainDetector = nullptr;
-    std::unique_ptr<ONNXModel> mOnnxModel = nullptr;
     std::unique_ptr<Tracker> mTracker = nullptr;
-    GCC_PHAT mComputeTDOAs;
+    std::unique_ptr<StreamResync> mStreamResync = nullptr;  ///< Set when gaps are bridged instead of thrown on.
+    std::unique_ptr<LoadShedder> mLoadShedder = nullptr;  ///< Set when overload is shed instead of aborting.
+    uint64_t mLastReportedShedCount = 0;
+    float mTimeDomainThreshold = 0;
+    std::unique_ptr<AsyncClassifier> mAsyncClassifier = nullptr;  ///< Set when classifying off the analysing threads.
+    static constexpr size_t mClassifierQueueCapacity = 64;
+    std::vector<std::unique_ptr<WindowAnalyzer>> mAnalyzers;  ///< One per worker; a single one unless parallel.
+
+    using JobQueue = SpscQueue<std::unique_ptr<WindowJob>>;
+    using StageFunction = void (Pipeline::*)(WindowJob&);
+    struct Stage
+    {
+        const char* name;
+        StageFunction process;
+    };
+    static const std::array<Stage, 4> mStages;  ///< The stages after decode, in order.
+
+    const std::vector<int> mStageCores;  ///< Core per stage in mStages when staged; empty otherwise.
+    const std::vector<int> mWorkerCores;  ///< Core per window worker when parallel; empty otherwise.
+    const size_t mJobsInFlight;  ///< Jobs, and so capacity of each queue, when staged or parallel.
+    WindowJob mSerialJob;  ///< The only job when the stages run serially.
+    uint64_t mNextSequence = 0;  ///< Sequence number of the next job decode hands out.
+    std::unique_ptr<JobQueue> mFreeJobs;  ///< Returns jobs from the output stage to decode.
+    std::array<std::unique_ptr<JobQueue>, 4> mStageQueues;  ///< Queue i feeds mStages[i] when staged.
+    std::vector<std::unique_ptr<JobQueue>> mWorkerInputs;  ///< Windows waiting for each worker when parallel.
+    std::vector<std::unique_ptr<JobQueue>> mWorkerOutputs;  ///< Windows each worker has finished.
+    std::atomic<uint32_t> mJobsFinished = 0;  ///< Bumped whenever a worker finishes a job; reassembly waits on it.
+    std::vector<std::thread> mThreads;  ///< Stage threads, or workers and the reassembly thread.
+
     void dataProcessor();
-    void initializeOutputFiles(bool& previousTimeSet, TimePoint& previousTime);
-    void obtainAndProcessByteData(bool& previousTimeSet, TimePoint& previousTime);
+    void startThreads();
+    void stopThreads();
+    void closeQueues();
+    bool dispatch(std::unique_ptr<WindowJob>& job);
+    void runStage(size_t stageIndex);
+    void runWorker(size_t workerIndex);
+    void runReassembly();
+    void handleThreadError(const std::string& threadName, const std::exception& e);
+    void decodeWindow(WindowJob& job);
+    void filterWindow(WindowJob& job) { mAnalyzers.front()->filter(job); }
+    void classifyWindow(WindowJob& job) { mAnalyzers.front()->classify(job); }
+    void localiseWindow(WindowJob& job) { mAnalyzers.front()->localise(job); }
+    void outputWindow(WindowJob& job);
+    bool awaitClassification(WindowJob& job);
+    bool initializeOutputFiles(bool& previousTimeSet, TimePoint& previousTime);
+    bool obtainAndProcessByteData(bool& previousTimeSet, TimePoint& previousTime);
+    bool obtainAndResyncByteData();
     void handleProcessingError(const std::exception& e);
+    void reportStatisticsIfNecessary();
+    bool isPeakInWindowCenter(int peakIndex) const;
 };
\ No newline at end of file
@@ -12,9 +12,32 @@ struct PipelineVariables
 
     bool integrationTesting = false;
     bool enableTracking = false;
+    bool enableStreamResync = false;
+    bool enableLoadShedding = false;
+    bool enableStagedPipeline = false;
+    bool enableAsyncClassifier = false;
+
+    int windowHopPackets = 0;  ///< Packets between the starts of successive detection windows, 0 for no overlap.
+    int processingCore = -1;  ///< CPU core for the pipeline thread, -1 to leave it unpinned.
+    std::vector<int> stageCores = {-1, -1, -1, -1};  ///< CPU core per spectral/classify/localise/output stage thread.
+    int windowWorkers = 0;  ///< Threads analysing whole windows in parallel, 0 to analyse them on the pipeline thread.
+    std::vector<int> workerCores = {};  ///< CPU core per window worker; workers beyond the list are left unpinned.
+    int classifierCore = -1;  ///< CPU core for the asynchronous classifier thread, -1 to leave it unpinned.
+    int classifierDeadlineMs = 100;  ///< How long output waits for an asynchronous verdict before keeping a detection.
+    int metricsPort = 0;  ///< Local port serving the metrics over HTTP, 0 for none.
+    int metricsIntervalSeconds = 10;
+    int logRateLimit = 10;  ///< Messages per second each log statement may print, 0 for no limit.
+
+    std::vector<int> loadSheddingEnterQueueDepths = {300, 500, 700, 850};  ///< Queue depth entering each overload tier.
+    std::vector<int> loadSheddingExitQueueDepths = {150, 350, 550, 700};  ///< Queue depth leaving each overload tier.
+    float loadSheddingThresholdScale = 2.0f;  ///< Time-domain threshold multiplier while thresholds are raised.
 
     std::string firmware = "";
     std::string loggingDirectory = "";
+    std::string detectionLogFormat = "csv";  ///< "csv", "binary" or "both".
+    std::string liveOutputAddress = "";  ///< "udp:<ip>:<port>" or "unix:<path>" to publish detections to, if set.
+    std::string metricsFile = "";  ///< Prometheus text file rewritten every metricsIntervalSeconds, if set.
+    std::string logLevel = "info";  ///< "debug", "info", "warning", "error" or "off".
     std::string timeDomainDetector = "";
     std::string frequencyDomainDetector = "";
     std::string frequencyDomainStrategy = "";
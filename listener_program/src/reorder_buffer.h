@@ -0,0 +1,68 @@
+#pragma once
+#include "pch.h"
+
+/**
+ * @class ReorderBuffer
+ * @brief Puts values that finish out of order back into sequence order.
+ *
+ * Values are numbered 0, 1, 2, ... when issued and may be inserted in any order; popNext only returns the value with
+ * the next sequence number once it is present. At most capacity values may be outstanding, i.e. issued but not yet
+ * popped, so the buffer is a fixed ring of slots indexed by sequence number and never allocates after construction.
+ */
+template <typename T>
+class ReorderBuffer
+{
+   public:
+    explicit ReorderBuffer(size_t capacity) : mSlots(capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("ReorderBuffer capacity must be positive");
+        }
+    }
+
+    /**
+     * @throws std::out_of_range If the sequence number was already popped or is capacity or more ahead of the next.
+     * @throws std::logic_error If a value with the same sequence number is already buffered.
+     */
+    void insert(uint64_t sequence, T value)
+    {
+        if (sequence < mNextSequence || sequence - mNextSequence >= mSlots.size())
+        {
+            throw std::out_of_range("Sequence number " + std::to_string(sequence) + " outside the reorder window\n");
+        }
+        std::optional<T>& slot = mSlots[sequence % mSlots.size()];
+        if (slot)
+        {
+            throw std::logic_error("Sequence number " + std::to_string(sequence) + " inserted twice\n");
+        }
+        slot = std::move(value);
+        mBuffered++;
+    }
+
+    /**
+     * @brief Moves the value with the next sequence number into value, if it has arrived.
+     */
+    bool popNext(T& value)
+    {
+        std::optional<T>& slot = mSlots[mNextSequence % mSlots.size()];
+        if (!slot)
+        {
+            return false;
+        }
+        value = std::move(*slot);
+        slot.reset();
+        mNextSequence++;
+        mBuffered--;
+        return true;
+    }
+
+    uint64_t nextSequence() const { return mNextSequence; }
+
+    size_t size() const { return mBuffered; }  ///< Values inserted but not yet popped.
+
+   private:
+    std::vector<std::optional<T>> mSlots;
+    uint64_t mNextSequence = 0;
+    size_t mBuffered = 0;
+};
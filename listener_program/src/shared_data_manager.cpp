@@ -1,53 +1,365 @@
 #include "shared_data_manager.h"
 
+#include "utils.h"
+
 using namespace std::chrono_literals;
+
+/**
+ * @brief Allocates the packet ring up front so that no allocation happens while streaming.
+ * @param slotSize Bytes reserved for each packet; datagrams longer than this are truncated by the socket.
+ * @param numSlots Number of packets the ring can hold before the producer runs out of free slots.
+ */
+SharedDataManager::SharedDataManager(int slotSize, int numSlots)
+    : mSlotSize(slotSize),
+      mNumSlots(numSlots),
+      mSlotStorage(static_cast<size_t>(slotSize) * numSlots),
+      mSlotLengths(numSlots, 0),
+      mSlotArrivalTimes(numSlots),
+      mSlotEnqueueTimes(numSlots)
+{
+}
+
+/**
+ * @brief Empties the ring and clears the error flag so the same manager can serve a restarted stream.
+ *
+ * The slot storage is kept, so a restart does not reallocate it. Cumulative counters (received, lost and discarded
+ * packets, detections, resyncs) are left untouched. Must only be called while neither the listener nor the pipeline
+ * thread is running.
+ */
+void SharedDataManager::reset()
+{
+    mWriteIndex.store(0, std::memory_order_relaxed);
+    mReadIndex.store(0, std::memory_order_relaxed);
+    mCachedReadIndex = 0;
+    mCachedWriteIndex = 0;
+    mWakeTargetIndex.store(0, std::memory_order_relaxed);
+    mProducerWaiting.store(false, std::memory_order_relaxed);
+    takeDequeueLatency();
+    errorOccurred.store(false, std::memory_order_release);
+    mStreamFinished.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Marks the end of a finite stream, such as a recording processed offline. Producer thread only, after the
+ * last commit.
+ *
+ * Once fewer packets remain than the consumer asks for, waitForData returns false instead of waiting for more.
+ */
+void SharedDataManager::finishStream()
+{
+    mStreamFinished.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mWakeLock);
+    }
+    mDataReady.notify_one();
+}
+
+/**
+ * @brief Returns the number of packets committed but not yet released. Safe to call from either thread.
+ */
+int SharedDataManager::queueSize() const
+{
+    const uint64_t readIndex = mReadIndex.load(std::memory_order_acquire);
+    const uint64_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+    return static_cast<int>(writeIndex - readIndex);
+}
+
+/**
+ * @brief Producer-side count of free slots, refreshing the cached read index only when the ring looks full.
+ * @param writeIndex The producer's current write index.
+ */
+uint64_t SharedDataManager::freeSlotCount(uint64_t writeIndex)
+{
+    uint64_t freeSlots = mNumSlots - (writeIndex - mCachedReadIndex);
+    if (freeSlots == 0)
+    {
+        mCachedReadIndex = mReadIndex.load(std::memory_order_acquire);
+        freeSlots = mNumSlots - (writeIndex - mCachedReadIndex);
+    }
+    return freeSlots;
+}
+
 /**
- * @brief Push data into the shared buffer in a thread-safe manner.
+ * @brief Publishes newly committed packets and wakes the consumer if they complete the window it is waiting for.
+ * @param writeIndex The producer's new write index.
+ */
+void SharedDataManager::publishWriteIndex(uint64_t writeIndex)
+{
+    mWriteIndex.store(writeIndex, std::memory_order_release);
+
+    // Pairs with the fence in waitForData: either the consumer sees the new index, or we see its wake target
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const uint64_t wakeTarget = mWakeTargetIndex.load(std::memory_order_relaxed);
+    if (wakeTarget != 0 && writeIndex >= wakeTarget)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mWakeLock);
+        }
+        mDataReady.notify_one();
+    }
+}
+
+/**
+ * @brief Copy a single packet into the next free slot. Producer thread only.
+ *
+ * This is the fallback used by the single-packet receive path; batched receives write into slots directly via
+ * acquireWriteSlots and commitWriteSlots.
+ *
  * @param data Reference to a vector of bytes representing the incoming data.
- * @return The size of the data buffer after pushing.
+ * @param arrivalTime When the packet arrived at the socket.
+ * @return The number of queued packets after pushing.
+ * @throws std::runtime_error If the ring has no free slot or the packet exceeds the slot size.
  */
-int SharedDataManager::pushDataToBuffer(const std::vector<uint8_t>& data)
+int SharedDataManager::pushDataToBuffer(const std::vector<uint8_t>& data, TimePoint arrivalTime)
 {
-    std::lock_guard<std::mutex> lock(dataBufferLock);
-    dataBuffer.push(data);
-    return static_cast<int>(dataBuffer.size());
+    if (data.size() > static_cast<size_t>(mSlotSize))
+    {
+        throw std::runtime_error("Packet larger than buffer slot size\n");
+    }
+
+    const uint64_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+    if (freeSlotCount(writeIndex) == 0)
+    {
+        throw std::runtime_error("Buffer overflowing \n");
+    }
+
+    std::memcpy(slotData(writeIndex), data.data(), data.size());
+    mSlotLengths[writeIndex % mNumSlots] = data.size();
+    mSlotArrivalTimes[writeIndex % mNumSlots] = arrivalTime;
+    mSlotEnqueueTimes[writeIndex % mNumSlots] = std::chrono::steady_clock::now();
+    publishWriteIndex(writeIndex + 1);
+
+    mCachedReadIndex = mReadIndex.load(std::memory_order_acquire);
+    return static_cast<int>(writeIndex + 1 - mCachedReadIndex);
+}
+
+/**
+ * @brief Hands out free slots for the producer to receive into. Producer thread only.
+ *
+ * The returned slots stay owned by the producer until they are published with commitWriteSlots.
+ *
+ * @param slots Destination for up to slots.size() writable slot buffers, each slotSize() bytes long.
+ * @return The number of slots written to the front of slots (0 if the ring is full).
+ */
+int SharedDataManager::acquireWriteSlots(std::span<std::span<uint8_t>> slots)
+{
+    const uint64_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+    uint64_t freeSlots = mNumSlots - (writeIndex - mCachedReadIndex);
+    if (freeSlots < slots.size())
+    {
+        // A partial batch is still useful, but refresh first in case the consumer has caught up
+        mCachedReadIndex = mReadIndex.load(std::memory_order_acquire);
+        freeSlots = mNumSlots - (writeIndex - mCachedReadIndex);
+    }
+    const int numSlots = static_cast<int>(std::min<uint64_t>(freeSlots, slots.size()));
+
+    for (int i = 0; i < numSlots; i++)
+    {
+        slots[i] = std::span<uint8_t>(slotData(writeIndex + i), mSlotSize);
+    }
+    return numSlots;
 }
 
 /**
- * @brief Waits until the required number of packets are available and retrieves them.
- * @param dataBytes Destination vector for the retrieved packets.
+ * @brief Publishes the first lengths.size() slots previously handed out by acquireWriteSlots. Producer thread only.
+ * @param lengths Number of valid bytes written into each slot, in acquisition order.
+ * @param arrivalTimes When each packet arrived at the socket; if empty, the commit time is used for all of them.
+ * @return The number of queued packets after committing.
+ */
+int SharedDataManager::commitWriteSlots(std::span<const size_t> lengths, std::span<const TimePoint> arrivalTimes)
+{
+    const uint64_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+    const auto enqueueTime = std::chrono::steady_clock::now();
+    const TimePoint commitTime = arrivalTimes.empty() ? std::chrono::system_clock::now() : TimePoint();
+    for (size_t i = 0; i < lengths.size(); i++)
+    {
+        mSlotLengths[(writeIndex + i) % mNumSlots] = std::min(lengths[i], static_cast<size_t>(mSlotSize));
+        mSlotArrivalTimes[(writeIndex + i) % mNumSlots] = arrivalTimes.empty() ? commitTime : arrivalTimes[i];
+        mSlotEnqueueTimes[(writeIndex + i) % mNumSlots] = enqueueTime;
+    }
+    publishWriteIndex(writeIndex + lengths.size());
+
+    // Refresh so the reported depth (used for statistics and the overflow check) is current
+    mCachedReadIndex = mReadIndex.load(std::memory_order_acquire);
+    return static_cast<int>(writeIndex + lengths.size() - mCachedReadIndex);
+}
+
+/**
+ * @brief Blocks until the ring has a free slot. Producer thread only.
+ *
+ * The calling thread sleeps until the consumer releases a packet, so a listener that must not drop packets waits
+ * without occupying a core. The wait is re-armed every errorCheckInterval so that errorOccurred and a program stop are
+ * still honoured if the consumer stops.
+ *
+ * @param errorCheckInterval Longest time to sleep between checks of errorOccurred.
+ * @return True once a slot is free, false if errorOccurred was set or the program asked to stop while waiting.
+ */
+bool SharedDataManager::waitForFreeSlot(std::chrono::milliseconds errorCheckInterval)
+{
+    const uint64_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+    while (freeSlotCount(writeIndex) == 0)
+    {
+        if (errorOccurred || isProgramStopRequested())
+        {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(mWakeLock);
+        mProducerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        mSlotFreed.wait_for(
+            lock, errorCheckInterval,
+            [this, writeIndex]()
+            { return writeIndex - mReadIndex.load(std::memory_order_acquire) < static_cast<uint64_t>(mNumSlots); });
+        mProducerWaiting.store(false, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+/**
+ * @brief Exposes the oldest numPacksToGet packets without releasing them, if available. Consumer thread only.
+ *
+ * The views point into the ring and remain valid until the packets are handed back with releaseData.
+ *
+ * @param data Destination for the packet views; must already hold numPacksToGet elements.
+ * @param numPacksToGet Number of packets to view.
+ * @return True if enough packets were available, otherwise false.
+ */
+bool SharedDataManager::peekData(std::vector<PacketView>& data, int numPacksToGet)
+{
+    const uint64_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+    if (mCachedWriteIndex - readIndex < static_cast<uint64_t>(numPacksToGet))
+    {
+        mCachedWriteIndex = mWriteIndex.load(std::memory_order_acquire);
+        if (mCachedWriteIndex - readIndex < static_cast<uint64_t>(numPacksToGet))
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < numPacksToGet; i++)
+    {
+        data[i] = PacketView(slotData(readIndex + i), mSlotLengths[(readIndex + i) % mNumSlots]);
+    }
+    return true;
+}
+
+/**
+ * @brief Blocks until the required number of packets are available and exposes them as read-only views.
+ *
+ * The calling thread sleeps on a condition variable and is woken by the producer as soon as the commit that completes
+ * the window is published. The wait is re-armed every errorCheckInterval so that errorOccurred and a program stop
+ * are still honoured if the producer stops.
+ *
+ * @param dataBytes Destination for the packet views; must already hold numPacksToGet elements.
  * @param numPacksToGet Number of packets to fetch from the buffer.
- * @return None (blocks until data is available).
+ * @param errorCheckInterval Longest time to sleep between checks of errorOccurred.
+ * @return True once the packets are available, false if errorOccurred was set or the program asked to stop while
+ * waiting, or the stream was finished with fewer packets left.
  */
-void SharedDataManager::waitForData(std::vector<std::vector<uint8_t>>& dataBytes, int numPacksToGet)
+bool SharedDataManager::waitForData(
+    std::vector<PacketView>& dataBytes, int numPacksToGet, std::chrono::milliseconds errorCheckInterval)
 {
-    while (true)
+    const uint64_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+    const uint64_t targetIndex = readIndex + numPacksToGet;
+
+    while (!peekData(dataBytes, numPacksToGet))
     {
-        if (popDataFromBuffer(dataBytes, numPacksToGet))
+        if (errorOccurred || isProgramStopRequested())
+        {
+            return false;
+        }
+        if (mStreamFinished.load(std::memory_order_acquire))
         {
-            return;
+            // The last commit happened before the stream was finished, so one more look sees every packet
+            if (!peekData(dataBytes, numPacksToGet))
+            {
+                return false;
+            }
+            break;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+
+        std::unique_lock<std::mutex> lock(mWakeLock);
+        mWakeTargetIndex.store(targetIndex, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        mDataReady.wait_for(
+            lock, errorCheckInterval,
+            [this, targetIndex]()
+            {
+                return mWriteIndex.load(std::memory_order_acquire) >= targetIndex ||
+                       mStreamFinished.load(std::memory_order_acquire);
+            });
+        mWakeTargetIndex.store(0, std::memory_order_relaxed);
+    }
+
+    recordDequeueLatency(targetIndex - 1);
+    return true;
+}
+
+/**
+ * @brief Accumulates the time the window completed by lastPacketIndex spent queued before the consumer obtained it.
+ * @param lastPacketIndex Ring index of the last packet in the window.
+ */
+void SharedDataManager::recordDequeueLatency(uint64_t lastPacketIndex)
+{
+    const auto latency = std::chrono::steady_clock::now() - mSlotEnqueueTimes[lastPacketIndex % mNumSlots];
+    const uint64_t latencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+
+    mLatencySumNs.fetch_add(latencyNs, std::memory_order_relaxed);
+    mLatencyCount.fetch_add(1, std::memory_order_relaxed);
+    uint64_t previousMax = mLatencyMaxNs.load(std::memory_order_relaxed);
+    while (latencyNs > previousMax &&
+           !mLatencyMaxNs.compare_exchange_weak(previousMax, latencyNs, std::memory_order_relaxed))
+    {
     }
 }
 
 /**
- * @brief Pops up to numPacksToGet packets from the shared buffer in a thread-safe manner.
- * @param data Destination vector for the popped packets.
- * @param numPacksToGet Number of packets to pop.
- * @return True if enough packets were popped, otherwise false.
+ * @brief Returns when a packet of the current window arrived at the socket. Consumer thread only.
+ * @param packetOffset Position of the packet relative to the oldest unreleased packet.
  */
-bool SharedDataManager::popDataFromBuffer(std::vector<std::vector<uint8_t>>& data, int numPacksToGet)
+TimePoint SharedDataManager::arrivalTime(int packetOffset) const
 {
-    std::lock_guard<std::mutex> lock(dataBufferLock);
-    if (dataBuffer.size() >= numPacksToGet)
+    const uint64_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+    return mSlotArrivalTimes[(readIndex + packetOffset) % mNumSlots];
+}
+
+/**
+ * @brief Returns the oldest numPackets packets to the producer once decoded. Consumer thread only.
+ * @param numPackets Number of packets to release; clamped to the number of queued packets.
+ */
+void SharedDataManager::releaseData(int numPackets)
+{
+    const uint64_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+    const uint64_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+    mReadIndex.store(readIndex + std::min<uint64_t>(numPackets, writeIndex - readIndex), std::memory_order_release);
+
+    // Pairs with the fence in waitForFreeSlot: either the producer sees the new index, or we see it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mProducerWaiting.load(std::memory_order_relaxed))
     {
-        for (int i = 0; i < numPacksToGet; i++)
         {
-            data[i] = dataBuffer.front();
-            dataBuffer.pop();
+            std::lock_guard<std::mutex> lock(mWakeLock);
         }
-        return true;
+        mSlotFreed.notify_one();
+    }
+}
+
+/**
+ * @brief Returns the enqueue-to-dequeue latency accumulated since the previous call and starts a new interval.
+ */
+SharedDataManager::DequeueLatency SharedDataManager::takeDequeueLatency()
+{
+    const uint64_t sumNs = mLatencySumNs.exchange(0, std::memory_order_relaxed);
+    const uint64_t maxNs = mLatencyMaxNs.exchange(0, std::memory_order_relaxed);
+    const uint64_t count = mLatencyCount.exchange(0, std::memory_order_relaxed);
+
+    DequeueLatency latency;
+    latency.numWindows = count;
+    if (count > 0)
+    {
+        latency.average = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(sumNs / count));
+        latency.max = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(maxNs));
     }
-    return false;
+    return latency;
 }
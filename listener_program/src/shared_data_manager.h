@@ -1,24 +1,110 @@
-
 #pragma once
+#include "metrics_registry.h"
 #include "pch.h"
 
 /**
  * @class SharedDataManager
  * @brief A thread-safe class that manages resources shared across threads.
+ *
+ * Incoming packets are stored in a fixed-capacity ring of preallocated slots. The listener thread receives directly
+ * into free slots and commits them; the pipeline thread reads windows of committed slots as spans and releases them
+ * once decoded, so no packet is copied or heap-allocated in steady state.
+ *
+ * The ring is a single-producer/single-consumer queue: only the listener thread may call the producer methods
+ * (pushDataToBuffer, acquireWriteSlots, commitWriteSlots, waitForFreeSlot) and only the pipeline thread may call the
+ * consumer methods (peekData, waitForData, releaseData). Each side owns one index and publishes it with a release
+ * store, so every method except the two waits is wait-free.
+ *
+ * A consumer blocked in waitForData advertises how many packets it needs; the producer only takes the wake-up mutex
+ * when a commit satisfies that request, so the hot path stays lock-free while the consumer wakes as soon as its
+ * window is complete. Likewise a producer blocked in waitForFreeSlot is woken by the release that frees a slot.
  */
 class SharedDataManager
 {
    private:
-    std::mutex dataBufferLock;
-    std::queue<std::vector<uint8_t>> dataBuffer;  ///< Holds incoming data packets (thread-safe via mutex).
+    static constexpr size_t mCacheLineSize = 64;
+
+    const int mSlotSize;  ///< Bytes reserved per packet slot (largest datagram that can be stored).
+    const int mNumSlots;  ///< Number of packet slots in the ring.
+    std::vector<uint8_t> mSlotStorage;  ///< Contiguous backing storage for all slots.
+    std::vector<size_t> mSlotLengths;  ///< Number of valid bytes in each slot.
+
+    // Indices only ever grow; kept on separate cache lines so producer and consumer do not false-share.
+    alignas(mCacheLineSize) std::atomic<uint64_t> mWriteIndex = 0;  ///< Total packets committed by the producer.
+    uint64_t mCachedReadIndex = 0;  ///< Producer's last observed mReadIndex.
+    alignas(mCacheLineSize) std::atomic<uint64_t> mReadIndex = 0;  ///< Total packets released by the consumer.
+    uint64_t mCachedWriteIndex = 0;  ///< Consumer's last observed mWriteIndex.
+
+    std::vector<TimePoint> mSlotArrivalTimes;  ///< When each packet arrived at the socket (kernel timestamp if known).
+    std::vector<std::chrono::steady_clock::time_point> mSlotEnqueueTimes;  ///< When each slot was committed.
+    std::atomic<uint64_t> mLatencySumNs = 0;  ///< Sum of enqueue-to-dequeue latencies since the last report.
+    std::atomic<uint64_t> mLatencyMaxNs = 0;  ///< Largest enqueue-to-dequeue latency since the last report.
+    std::atomic<uint64_t> mLatencyCount = 0;  ///< Number of windows measured since the last report.
+
+    alignas(mCacheLineSize) std::atomic<uint64_t> mWakeTargetIndex = 0;  ///< Write index the waiting consumer needs.
+    std::atomic<bool> mProducerWaiting = false;  ///< The producer is blocked in waitForFreeSlot.
+    std::atomic<bool> mStreamFinished = false;  ///< No packets will follow the ones already committed.
+    std::mutex mWakeLock;
+    std::condition_variable mDataReady;
+    std::condition_variable mSlotFreed;
+
+    uint8_t* slotData(uint64_t packetIndex) { return mSlotStorage.data() + (packetIndex % mNumSlots) * mSlotSize; }
 
-    bool popDataFromBuffer(std::vector<std::vector<uint8_t>>& data, int numPacksToGet);
+    uint64_t freeSlotCount(uint64_t writeIndex);
+
+    void publishWriteIndex(uint64_t writeIndex);
+
+    void recordDequeueLatency(uint64_t lastPacketIndex);
 
    public:
-    std::atomic<bool> errorOccurred = false;  ///< Indicates an error has occurred in processing or I/O operations.
+    /**
+     * @brief Enqueue-to-dequeue latency of detection windows, measured from the commit of a window's last packet to
+     * the moment the consumer obtained the window.
+     */
+    struct DequeueLatency
+    {
+        std::chrono::microseconds average{0};
+        std::chrono::microseconds max{0};
+        uint64_t numWindows = 0;
+    };
+
+    explicit SharedDataManager(int slotSize = 2048, int numSlots = 1024);
+
+    void reset();
+
+    alignas(mCacheLineSize) std::atomic<bool> errorOccurred =
+        false;  ///< Indicates an error has occurred in processing or I/O operations.
     std::atomic<int> detectionCounter = 0;  ///< Tracks the number of successful detections.
+    std::atomic<int> packetsReceived = 0;  ///< Packets received by the listener across restarts.
+    std::atomic<int> packetsLost = 0;  ///< Packets missing from the stream and zero-filled by the pipeline.
+    std::atomic<int> packetsDiscarded = 0;  ///< Received packets dropped by the pipeline (duplicates, late, resync).
+    std::atomic<int> resyncCounter = 0;  ///< Times the pipeline lost timestamp lock and re-anchored the stream.
+    std::atomic<int> packetsDroppedByKernel = 0;  ///< Datagrams the socket dropped before the listener read them.
+    MetricsRegistry metrics;  ///< The stream's exported counters; unlike the ring, kept across reset().
+
+    int slotSize() const { return mSlotSize; }
+
+    int queueSize() const;
+
+    int pushDataToBuffer(const std::vector<uint8_t>& data, TimePoint arrivalTime = std::chrono::system_clock::now());
+
+    int acquireWriteSlots(std::span<std::span<uint8_t>> slots);
+
+    int commitWriteSlots(std::span<const size_t> lengths, std::span<const TimePoint> arrivalTimes = {});
+
+    bool waitForFreeSlot(std::chrono::milliseconds errorCheckInterval = std::chrono::milliseconds(100));
+
+    void finishStream();
+
+    bool peekData(std::vector<PacketView>& data, int numPacksToGet);
+
+    bool waitForData(
+        std::vector<PacketView>& dataBytes, int numPacksToGet,
+        std::chrono::milliseconds errorCheckInterval = std::chrono::milliseconds(100));
+
+    TimePoint arrivalTime(int packetOffset) const;
 
-    int pushDataToBuffer(const std::vector<uint8_t>& data);
+    void releaseData(int numPackets);
 
-    void waitForData(std::vector<std::vector<uint8_t>>& dataBytes, int numPacksToGet);
-};
\ No newline at end of file
+    DequeueLatency takeDequeueLatency();
+};
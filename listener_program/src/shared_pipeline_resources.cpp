@@ -0,0 +1,42 @@
+#include "shared_pipeline_resources.h"
+
+/**
+ * @brief Returns the ONNX model configured in pipelineVariables, loading it only the first time it is requested.
+ * @return The shared model, or nullptr if no model path is configured.
+ */
+std::shared_ptr<ONNXModel> SharedPipelineResources::onnxModel(const PipelineVariables& pipelineVariables)
+{
+    if (pipelineVariables.onnxModelPath.empty())
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mResourceLock);
+    auto& model = mOnnxModels[{pipelineVariables.onnxModelPath, pipelineVariables.onnxModelNormalizationPath}];
+    if (!model)
+    {
+        model = IONNXModel::create(pipelineVariables);
+    }
+    return model;
+}
+
+/**
+ * @brief Returns the spectrum of the configured FIR filter for channels of channelSize samples, computing it once.
+ * @return The shared spectrum, or nullptr if the pipeline does not use the "Filter" frequency domain strategy.
+ */
+std::shared_ptr<const FilterSpectrum> SharedPipelineResources::filterSpectrum(
+    const PipelineVariables& pipelineVariables, int channelSize)
+{
+    if (pipelineVariables.frequencyDomainStrategy != "Filter")
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mResourceLock);
+    auto& spectrum = mFilterSpectra[{pipelineVariables.filterWeightsPath, channelSize}];
+    if (!spectrum)
+    {
+        spectrum = FilterSpectrum::load(pipelineVariables.filterWeightsPath, channelSize);
+    }
+    return spectrum;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "pch.h"
+#include "ML/onnx_model.h"
+#include "algorithms/fir_filter.h"
+#include "pipeline_variables.h"
+
+/**
+ * @class SharedPipelineResources
+ * @brief Read-only state that the pipelines of several input streams can share.
+ *
+ * Each resource is built on first request and handed out to every later pipeline with the same settings, so running
+ * several streams in one process loads the ONNX session and computes each filter spectrum only once. ONNX Runtime
+ * sessions may be run concurrently, and filter spectra are never written after construction.
+ */
+class SharedPipelineResources
+{
+   public:
+    std::shared_ptr<ONNXModel> onnxModel(const PipelineVariables& pipelineVariables);
+
+    std::shared_ptr<const FilterSpectrum> filterSpectrum(const PipelineVariables& pipelineVariables, int channelSize);
+
+   private:
+    std::mutex mResourceLock;
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<ONNXModel>> mOnnxModels;
+    std::map<std::pair<std::string, int>, std::shared_ptr<const FilterSpectrum>> mFilterSpectra;
+};
@@ -5,4 +5,10 @@ struct SocketVariables
 {
     std::string ipAddress = "";
     int port = -1;
+    int receiveBatchSize = 32;
+    std::string socketBackend = "udp";
+    int listenerCore = -1;  ///< CPU core for the listener thread, -1 to leave it unpinned.
+    std::string captureFilePath = "";  ///< If set, every received datagram is recorded to this file.
+    std::string replayFilePath = "";  ///< Capture replayed by the "replay" backend.
+    double replaySpeed = 1.0;  ///< Replay pacing as a multiple of real time; 0 replays as fast as possible.
 };
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+#include "pch.h"
+
+/**
+ * @class SpscQueue
+ * @brief Bounded lock-free first-in first-out queue between exactly one producer thread and one consumer thread.
+ *
+ * Values are moved into preallocated slots, so a queue of unique_ptrs hands objects between threads without copying
+ * or allocating. As in SharedDataManager, each side owns one ever-growing index, kept on its own cache line and
+ * published with a release store. The blocking push and pop wait on an atomic counter that is only notified when the
+ * other side moves, so an idle stage sleeps in the kernel instead of spinning. close() wakes both sides for shutdown;
+ * the consumer still receives the values queued before it, so a closed queue drains rather than discarding work.
+ */
+template <typename T>
+class SpscQueue
+{
+   public:
+    explicit SpscQueue(size_t capacity) : mSlots(capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("SpscQueue capacity must be positive");
+        }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Producer only. Moves value into the queue unless it is full or closed.
+     * @return False, leaving value untouched, if the value could not be queued.
+     */
+    bool tryPush(T& value)
+    {
+        const uint64_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+        if (mClosed.load(std::memory_order_acquire) ||
+            writeIndex - mReadIndex.load(std::memory_order_acquire) == mSlots.size())
+        {
+            return false;
+        }
+        mSlots[writeIndex % mSlots.size()] = std::move(value);
+        mWriteIndex.store(writeIndex + 1, std::memory_order_release);
+        mPushCount.fetch_add(1, std::memory_order_release);
+        mPushCount.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Producer only. Moves value into the queue, waiting while it is full.
+     * @return False if the queue was closed before the value could be queued.
+     */
+    bool push(T& value)
+    {
+        while (true)
+        {
+            const uint32_t popCount = mPopCount.load(std::memory_order_acquire);
+            if (tryPush(value))
+            {
+                return true;
+            }
+            if (mClosed.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            mPopCount.wait(popCount, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Consumer only. Moves the oldest value into value unless the queue is empty. Values queued before close()
+     * are still returned.
+     */
+    bool tryPop(T& value)
+    {
+        const uint64_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+        if (readIndex == mWriteIndex.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        value = std::move(mSlots[readIndex % mSlots.size()]);
+        mReadIndex.store(readIndex + 1, std::memory_order_release);
+        mPopCount.fetch_add(1, std::memory_order_release);
+        mPopCount.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Consumer only. Moves the oldest value into value, waiting while the queue is empty.
+     * @return False once the queue is closed and empty; values queued before close() are returned first.
+     */
+    bool pop(T& value)
+    {
+        while (true)
+        {
+            const uint32_t pushCount = mPushCount.load(std::memory_order_acquire);
+            if (tryPop(value))
+            {
+                return true;
+            }
+            if (mClosed.load(std::memory_order_acquire))
+            {
+                return tryPop(value);  // a value pushed just before close() may have landed after the first attempt
+            }
+            mPushCount.wait(pushCount, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Makes every current and future push fail, and pop fail once the queue is empty, waking a blocked
+     * producer and consumer. Any thread.
+     */
+    void close()
+    {
+        mClosed.store(true, std::memory_order_release);
+        mPushCount.fetch_add(1, std::memory_order_release);
+        mPushCount.notify_all();
+        mPopCount.fetch_add(1, std::memory_order_release);
+        mPopCount.notify_all();
+    }
+
+    bool isClosed() const { return mClosed.load(std::memory_order_acquire); }
+
+    size_t capacity() const { return mSlots.size(); }
+
+    size_t size() const
+    {
+        // Read index first: it never passes the write index, so the difference cannot underflow
+        const uint64_t readIndex = mReadIndex.load(std::memory_order_acquire);
+        return mWriteIndex.load(std::memory_order_acquire) - readIndex;
+    }
+
+   private:
+    static constexpr size_t mCacheLineSize = 64;
+
+    std::vector<T> mSlots;
+
+    alignas(mCacheLineSize) std::atomic<uint64_t> mWriteIndex = 0;  ///< Total values pushed by the producer.
+    std::atomic<uint32_t> mPushCount = 0;  ///< Bumped after each push (and on close); the consumer waits on it.
+    alignas(mCacheLineSize) std::atomic<uint64_t> mReadIndex = 0;  ///< Total values popped by the consumer.
+    std::atomic<uint32_t> mPopCount = 0;  ///< Bumped after each pop (and on close); the producer waits on it.
+    alignas(mCacheLineSize) std::atomic<bool> mClosed = false;
+};
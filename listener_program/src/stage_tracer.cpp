@@ -0,0 +1,93 @@
+#include "stage_tracer.h"
+
+#include "logger.h"
+
+const char* StageTracer::stageName(TraceStage stage)
+{
+    switch (stage)
+    {
+        case TraceStage::Decode:
+            return "decode";
+        case TraceStage::Filter:
+            return "filter";
+        case TraceStage::TimeDomainDetector:
+            return "time-domain detector";
+        case TraceStage::FrequencyDomainDetector:
+            return "frequency-domain detector";
+        case TraceStage::Classifier:
+            return "classifier";
+        case TraceStage::GccPhat:
+            return "GCC-PHAT";
+        case TraceStage::Doa:
+            return "DOA";
+        case TraceStage::Tracker:
+            return "tracker";
+        case TraceStage::Flush:
+            return "flush";
+        case TraceStage::Count:
+            break;
+    }
+    return "unknown";
+}
+
+/**
+ * @brief One line per stage that recorded samples since the last reset.
+ */
+std::string StageTracer::summary() const
+{
+    std::stringstream ss;
+    for (size_t i = 0; i < mHistograms.size(); i++)
+    {
+        if (mHistograms[i].count() > 0)
+        {
+            ss << "    " << stageName(static_cast<TraceStage>(i)) << " " << mHistograms[i].summary() << "\n";
+        }
+    }
+    return ss.str();
+}
+
+/**
+ * @brief Prints the stage timings and starts a new interval, if interval has passed since the last report.
+ *
+ * Safe to call from every pipeline: only the caller that claims the interval prints.
+ */
+void StageTracer::reportIfNecessary(std::chrono::seconds interval)
+{
+    const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch())
+                              .count();
+    int64_t lastReportNs = mLastReportNs.load(std::memory_order_relaxed);
+    if (lastReportNs != 0 && nowNs - lastReportNs < std::chrono::nanoseconds(interval).count())
+    {
+        return;
+    }
+    if (!mLastReportNs.compare_exchange_strong(lastReportNs, nowNs, std::memory_order_relaxed))
+    {
+        return;  // another pipeline is reporting this interval
+    }
+    // One message per stage, bypassing the per-call-site rate limit: the interval already limits the rate
+    if (Logger::instance().isEnabled(LogLevel::Info))
+    {
+        for (size_t i = 0; i < mHistograms.size(); i++)
+        {
+            if (mHistograms[i].count() > 0)
+            {
+                Logger::instance().log(
+                    LogLevel::Info, "tracer",
+                    std::string("Stage ") + stageName(static_cast<TraceStage>(i)) + " " + mHistograms[i].summary());
+            }
+        }
+    }
+    reset();
+}
+
+/**
+ * @brief Discards the samples of every stage.
+ */
+void StageTracer::reset()
+{
+    for (auto& histogram : mHistograms)
+    {
+        histogram.reset();
+    }
+}
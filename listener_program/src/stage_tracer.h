@@ -0,0 +1,90 @@
+#pragma once
+#include "latency_histogram.h"
+#include "pch.h"
+
+/**
+ * @brief The pipeline stages whose processing time is traced.
+ */
+enum class TraceStage : uint8_t
+{
+    Decode,  ///< Timestamping, validating and decoding a hop of packets into the channel ring.
+    Filter,  ///< FFT, frequency-domain filter and inverse FFT of a window.
+    TimeDomainDetector,
+    FrequencyDomainDetector,
+    Classifier,  ///< ONNX inference, on whichever thread runs it.
+    GccPhat,
+    Doa,
+    Tracker,  ///< Tracker buffer and Kalman filter update for one detection.
+    Flush,  ///< Formatting and writing one batch of detections, on the writer thread.
+    Count
+};
+
+/// Stage durations, at nanosecond resolution since some stages take well under a microsecond.
+using StageHistogram = LogBucketHistogram<std::chrono::nanoseconds>;
+
+/**
+ * @class StageTracer
+ * @brief Process-wide per-stage duration histograms, fed by ScopedStageTimer and printed at the report interval.
+ *
+ * Stages are timed only in builds configured with -DENABLE_TRACING=ON, which defines FREEWILLI_TRACING; otherwise
+ * TRACE_STAGE expands to nothing and the hot path carries no timing code at all. All streams of a process share the
+ * tracer, and whichever pipeline first reaches the report interval prints and resets it.
+ */
+class StageTracer
+{
+   public:
+    static StageTracer& instance()
+    {
+        static StageTracer tracer;
+        return tracer;
+    }
+
+    void record(TraceStage stage, std::chrono::nanoseconds duration)
+    {
+        mHistograms[static_cast<size_t>(stage)].record(duration);
+    }
+
+    const StageHistogram& histogram(TraceStage stage) const { return mHistograms[static_cast<size_t>(stage)]; }
+
+    static const char* stageName(TraceStage stage);
+
+    std::string summary() const;
+
+    void reportIfNecessary(std::chrono::seconds interval);
+
+    void reset();
+
+   private:
+    std::array<StageHistogram, static_cast<size_t>(TraceStage::Count)> mHistograms;
+    std::atomic<int64_t> mLastReportNs = 0;  ///< steady_clock time of the last report; zero before the first.
+};
+
+/**
+ * @class ScopedStageTimer
+ * @brief Records the time from its construction to its destruction as one sample of a stage. Use TRACE_STAGE.
+ */
+class ScopedStageTimer
+{
+   public:
+    explicit ScopedStageTimer(TraceStage stage) : mStage(stage), mStart(std::chrono::steady_clock::now()) {}
+    ~ScopedStageTimer() { StageTracer::instance().record(mStage, std::chrono::steady_clock::now() - mStart); }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+   private:
+    TraceStage mStage;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+#define TRACE_STAGE_CONCAT_(a, b) a##b
+#define TRACE_STAGE_CONCAT(a, b) TRACE_STAGE_CONCAT_(a, b)
+
+/**
+ * @brief Times the rest of the enclosing scope as one sample of TraceStage::stage, in tracing builds only.
+ */
+#ifdef FREEWILLI_TRACING
+#define TRACE_STAGE(stage) ScopedStageTimer TRACE_STAGE_CONCAT(stageTimer, __LINE__)(TraceStage::stage)
+#else
+#define TRACE_STAGE(stage) static_cast<void>(0)
+#endif
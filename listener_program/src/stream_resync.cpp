@@ -0,0 +1,94 @@
+#include "stream_resync.h"
+
+/**
+ * @param microIncrement Microseconds between consecutive packets.
+ * @param windowSize Number of packet positions in a detection window.
+ * @param maxGapPackets Longest run of missing packets that is zero-filled rather than treated as a loss of lock.
+ */
+StreamResync::StreamResync(int microIncrement, int windowSize, int maxGapPackets)
+    : mMicroIncrement(microIncrement), mWindowSize(windowSize), mMaxGapPackets(maxGapPackets)
+{
+    mPlan.packetForPosition.resize(windowSize);
+    mPlan.positionTimes.resize(windowSize);
+}
+
+/**
+ * @brief Assigns the queued packets to window positions, bridging small gaps in their timestamps.
+ *
+ * Only the first packets needed to fill the window are consumed; packets after a bridged gap stay queued for the next
+ * window. The returned reference is valid until the next call.
+ *
+ * @param packetTimes Timestamps of the packets at the head of the queue (at least windowSize of them).
+ * @return The window plan. If resynced is set, packetsConsumed packets should be released and the call repeated; if
+ * the plan is otherwise incomplete, the call should be repeated with more packets.
+ */
+const WindowPlan& StreamResync::planWindow(std::span<const TimePoint> packetTimes)
+{
+    mPlan.packetsConsumed = 0;
+    mPlan.packetsMissing = 0;
+    mPlan.packetsDiscarded = 0;
+    mPlan.complete = false;
+    mPlan.resynced = false;
+    const std::optional<TimePoint> initialExpectedTime = mExpectedTime;
+
+    int position = 0;
+    size_t packet = 0;
+    while (position < mWindowSize && packet < packetTimes.size())
+    {
+        if (!mExpectedTime)
+        {
+            mExpectedTime = packetTimes[packet];  // lock onto the first packet seen
+        }
+
+        const auto offset = std::chrono::duration_cast<std::chrono::microseconds>(packetTimes[packet] - *mExpectedTime);
+        const auto gapPackets = offset / mMicroIncrement;
+        const bool aligned = (offset % mMicroIncrement).count() == 0;
+
+        if (offset.count() == 0)
+        {
+            mPlan.packetForPosition[position] = static_cast<int>(packet);
+            mPlan.positionTimes[position] = packetTimes[packet];
+            position++;
+            packet++;
+            *mExpectedTime += mMicroIncrement;
+        }
+        else if (aligned && gapPackets > 0 && gapPackets <= mMaxGapPackets)
+        {
+            // Lost packets: mark the positions missing, then revisit this packet at its own position
+            mPlan.packetForPosition[position] = -1;
+            mPlan.positionTimes[position] = *mExpectedTime;
+            mPlan.packetsMissing++;
+            position++;
+            *mExpectedTime += mMicroIncrement;
+        }
+        else if (aligned && gapPackets < 0 && -gapPackets <= mMaxGapPackets)
+        {
+            // Duplicate or late packet whose position has already been filled
+            mPlan.packetsDiscarded++;
+            packet++;
+        }
+        else
+        {
+            // Discontinuity: drop everything before this packet and re-anchor the stream on it
+            mExpectedTime.reset();
+            mPlan.packetsDiscarded += static_cast<int>(packet);
+            mPlan.packetsConsumed = static_cast<int>(packet);
+            mPlan.packetsMissing = 0;
+            mPlan.resynced = true;
+            return mPlan;
+        }
+    }
+
+    if (position < mWindowSize)
+    {
+        // Too many packets were discarded to fill the window; undo so the caller can retry with more packets
+        mExpectedTime = initialExpectedTime;
+        mPlan.packetsMissing = 0;
+        mPlan.packetsDiscarded = 0;
+        return mPlan;
+    }
+
+    mPlan.packetsConsumed = static_cast<int>(packet);
+    mPlan.complete = true;
+    return mPlan;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "pch.h"
+
+/**
+ * @brief How a window of detection positions is assembled from the packets currently at the head of the queue.
+ */
+struct WindowPlan
+{
+    std::vector<int> packetForPosition;  ///< Queue offset of the packet for each window position, -1 if missing.
+    std::vector<TimePoint> positionTimes;  ///< Timestamp of each window position (expected time if missing).
+    int packetsConsumed = 0;  ///< Packets at the head of the queue that can be released after this plan.
+    int packetsMissing = 0;  ///< Window positions zero-filled because their packet never arrived.
+    int packetsDiscarded = 0;  ///< Consumed packets that were not placed (duplicates, late or pre-resync packets).
+    bool complete = false;  ///< True if every window position was assigned.
+    bool resynced = false;  ///< True if the stream lost lock; release packetsConsumed and plan again.
+};
+
+/**
+ * @class StreamResync
+ * @brief Tracks packet timestamps and turns gaps in the stream into zero-filled window positions.
+ *
+ * Each packet should be exactly microIncrement after its predecessor. A gap that is a whole number of packets and no
+ * longer than maxGapPackets is bridged by marking the missing positions; a late or duplicate packet is discarded.
+ * Anything else (a misaligned timestamp, a jump larger than maxGapPackets or far backwards) loses lock: the stream is
+ * re-anchored at the offending packet and the window is rebuilt from there. If discarded packets leave the window
+ * short, the plan is incomplete and nothing is consumed, so the caller can retry with more packets.
+ */
+class StreamResync
+{
+   public:
+    StreamResync(int microIncrement, int windowSize, int maxGapPackets);
+
+    const WindowPlan& planWindow(std::span<const TimePoint> packetTimes);
+
+    void reset() { mExpectedTime.reset(); }
+
+   private:
+    const std::chrono::microseconds mMicroIncrement;
+    const int mWindowSize;
+    const int mMaxGapPackets;
+    std::optional<TimePoint> mExpectedTime;  ///< Timestamp the next packet should carry, unset until locked.
+    WindowPlan mPlan;  ///< Reused between calls to avoid reallocating.
+};
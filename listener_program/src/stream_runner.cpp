@@ -0,0 +1,61 @@
+#include "stream_runner.h"
+
+#include "io/socket_manager_factory.h"
+#include "listener_thread.h"
+#include "utils.h"
+
+/**
+ * @brief Opens the stream's socket and builds its packet ring, output manager and pipeline.
+ *
+ * Pipeline construction creates FFTW plans, and FFTW's planner is not thread-safe, so runners must be constructed
+ * one at a time.
+ */
+StreamRunner::StreamRunner(
+    const SocketVariables& socketVariables, const PipelineVariables& pipelineVariables,
+    std::chrono::seconds programRuntime, SharedPipelineResources& sharedResources)
+    : mSocketManager(SocketManagerFactory::create(socketVariables)),
+      mOutputManager(
+          programRuntime, pipelineVariables.integrationTesting, pipelineVariables.loggingDirectory,
+          pipelineVariables.detectionLogFormat, pipelineVariables.liveOutputAddress, &mSharedDataManager.metrics),
+      mPipeline(mOutputManager, mSharedDataManager, pipelineVariables, sharedResources),
+      mListenerCore(socketVariables.listenerCore),
+      mProcessingCore(pipelineVariables.processingCore),
+      mShedLoad(pipelineVariables.enableLoadShedding)
+{
+}
+
+/**
+ * @brief Runs the listener and pipeline threads, restarting them whenever either one stops on an error, and returns
+ * once both have stopped after requestProgramStop and the buffered detections are written.
+ * @throws std::runtime_error If the detection file cannot be written.
+ *
+ * Only the socket, the packet ring and the stream position are reset between runs.
+ */
+void StreamRunner::run()
+{
+    while (!isProgramStopRequested())
+    {
+        mSocketManager->restartListener();
+        mSharedDataManager.reset();
+        mPipeline.resetStream();
+
+        // Create threads for listening for incoming data packets and processing data
+        std::thread producerThread(
+            runListenerLoop, std::ref(mSharedDataManager), std::ref(mSocketManager), mShedLoad);
+        std::thread consumerThread(&Pipeline::process, &mPipeline);
+        pinThreadToCore(producerThread, mListenerCore);
+        pinThreadToCore(consumerThread, mProcessingCore);
+
+        // Wait for threads to finish
+        producerThread.join();
+        consumerThread.join();
+
+        if (!isProgramStopRequested())
+        {
+            std::cout << "Restarting threads..." << std::endl;
+        }
+    }
+
+    // Written out here rather than on destruction so that the final metrics include the last flush
+    mOutputManager.drain();
+}
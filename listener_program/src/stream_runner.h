@@ -0,0 +1,41 @@
+#pragma once
+#include "pch.h"
+#include "io/isocket_manager.h"
+#include "io/output_manager.h"
+#include "pipeline.h"
+#include "pipeline_variables.h"
+#include "shared_data_manager.h"
+#include "shared_pipeline_resources.h"
+#include "socket_variables.h"
+
+/**
+ * @class StreamRunner
+ * @brief Owns everything one input stream needs: its socket, packet ring, output manager and pipeline.
+ *
+ * run() keeps the stream's listener and pipeline threads alive, restarting both after an error while keeping the
+ * pipeline's stream-independent state, until the program is asked to stop. Several runners can run side by side, one
+ * per configured stream; destroying a runner drains its buffered detections to disk.
+ */
+class StreamRunner
+{
+   public:
+    StreamRunner(
+        const SocketVariables& socketVariables, const PipelineVariables& pipelineVariables,
+        std::chrono::seconds programRuntime, SharedPipelineResources& sharedResources);
+
+    StreamRunner(const StreamRunner&) = delete;
+    StreamRunner& operator=(const StreamRunner&) = delete;
+
+    void run();
+
+    const SharedDataManager& sharedDataManager() const { return mSharedDataManager; }
+
+   private:
+    std::unique_ptr<ISocketManager> mSocketManager;
+    SharedDataManager mSharedDataManager;
+    OutputManager mOutputManager;
+    Pipeline mPipeline;
+    const int mListenerCore;
+    const int mProcessingCore;
+    const bool mShedLoad;  ///< The pipeline sheds load, so the listener waits out a full queue instead of aborting.
+};
@@ -1,12 +1,14 @@
 #include "tracker.h"
 
 #include "../algorithms/kalman_filter.h"
+#include "../logger.h"
 #include "tracker_utils.h"
 
 // Tracker class implementation
 Tracker::Tracker(
     double eps, int minSamples, int missedUpdateThreshold, const std::string& outputFile,
-    const std::string& outputDirectory, std::chrono::seconds clusteringFrequency, std::chrono::seconds clusteringWindow)
+    const std::string& outputDirectory, std::chrono::seconds clusteringFrequency, std::chrono::seconds clusteringWindow,
+    LivePublisher* livePublisher)
     : mEps(eps),
       mMinSamples(minSamples),
       mMissedUpdateThreshold(missedUpdateThreshold),
@@ -16,13 +18,14 @@ Tracker::Tracker(
       mOutputDirectory(outputDirectory),
       mClusterFrequency(clusteringFrequency),
       mClusterWindow(clusteringWindow),
-      mNoClusterWindow(mClusterFrequency - mClusterWindow)
+      mNoClusterWindow(mClusterFrequency - mClusterWindow),
+      mLivePublisher(livePublisher)
 {
-    std::cout << "Initializing tracker: \n";
-    std::cout << "    output directory: " << mOutputDirectory << std::endl;
-    std::cout << "    clustering frequency: " << mClusterFrequency.count() << std::endl;
-    std::cout << "    clustering window: " << mClusterWindow.count() << std::endl;
-    std::cout << "    no clustering window: " << mNoClusterWindow.count() << std::endl;
+    LOG_INFO(
+        "tracker", "Initializing tracker: output directory: " << mOutputDirectory << " clustering frequency: "
+                                                              << mClusterFrequency.count() << " clustering window: "
+                                                              << mClusterWindow.count() << " no clustering window: "
+                                                              << mNoClusterWindow.count());
 }
 
 /**
@@ -235,6 +238,10 @@ int Tracker::updateKalmanFiltersContinuous(const Eigen::VectorXf& observation, c
 
         // Log the update
         mKalmanLog.emplace_back(timenum, mClusterAssignments[bestMatch], elevation, azimuth);
+        if (mLivePublisher)
+        {
+            mLivePublisher->publishTrackUpdate(mClusterAssignments[bestMatch], timepoint, elevation, azimuth);
+        }
 
         // Check if it's time to flush the log to the file
         auto timeSinceLastWrite =
@@ -363,12 +370,12 @@ void Tracker::scheduleCluster()
         mLastClusterTime = currentTime;
 
         // Process the last 30 seconds of collected data
-        std::cout << "Cluster size: " << mObservationBuffer.size() << std::endl;
+        LOG_DEBUG("tracker", "Cluster size: " << mObservationBuffer.size());
         auto startTime = std::chrono::steady_clock::now();
         processBuffer();
         auto endTime = std::chrono::steady_clock::now();
         std::chrono::duration<double> clusterDuration = endTime - startTime;
-        std::cout << "Cluster time: " << clusterDuration.count() << " seconds" << std::endl;
+        LOG_DEBUG("tracker", "Cluster time: " << clusterDuration.count() << " seconds");
 
         mIsTrackerInitialized = true;
 
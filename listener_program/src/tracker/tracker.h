@@ -1,6 +1,7 @@
 #pragma once
 #include "../../libs/dbscan/dbscan.hpp"
 #include "../algorithms/kalman_filter.h"
+#include "../io/live_publisher.h"
 #include "../pch.h"
 #include "../utils.h"
 using namespace std::chrono_literals;
@@ -26,7 +27,8 @@ class Tracker
     Tracker(
         double eps = 3, int min_samples = 15, int missed_update_threshold = 4, const std::string& outputFile = "",
         const std::string& outputDirectory = std::filesystem::current_path().string(),
-        std::chrono::seconds clusteringFrequency = 60s, std::chrono::seconds clusteringWindow = 30s);
+        std::chrono::seconds clusteringFrequency = 60s, std::chrono::seconds clusteringWindow = 30s,
+        LivePublisher* livePublisher = nullptr);
 
     int updateKalmanFiltersContinuous(const Eigen::VectorXf& observation, const TimePoint& timepoint);
 
@@ -34,6 +36,8 @@ class Tracker
 
     void updateTrackerBuffer(const Eigen::VectorXf& directionOfArrival);
 
+    size_t numFilters() const { return mKalmanFilters.size(); }
+
     bool mIsTrackerInitialized = false;
 
     void initializeOutputFile(const TimePoint& timestamp);
@@ -83,18 +87,19 @@ class Tracker
     std::vector<KalmanFilter> mKalmanFilters;
     std::vector<int> mClusterAssignments;
     std::vector<int> mMissedUpdates;
+    LivePublisher* mLivePublisher;  ///< Publishes each track update as it is logged; null when live output is disabled.
 };
 
 class ITracker
 {
    public:
-    static std::unique_ptr<Tracker> create(PipelineVariables pipelineVariables)
+    static std::unique_ptr<Tracker> create(PipelineVariables pipelineVariables, LivePublisher* livePublisher = nullptr)
     {
         if (pipelineVariables.enableTracking)
         {
             return std::make_unique<Tracker>(
                 0.04f, 15, 4, "", pipelineVariables.loggingDirectory, pipelineVariables.clusterFrequencyInSeconds,
-                pipelineVariables.clusterWindowInSeconds);
+                pipelineVariables.clusterWindowInSeconds, livePublisher);
         }
         return nullptr;
     }
@@ -1,12 +1,13 @@
 #include "tracker_utils.h"
 
 #include "../algorithms/kalman_filter.h"
+#include "../logger.h"
 #include "../pch.h"
 
 /**
- * @brief Prints details about cluster centers, distance matrix, associations, and unassigned clusters.
+ * @brief Logs, at debug level, details about cluster centers, distance matrix, associations, and unassigned clusters.
  *
- * This function outputs the cluster centers, the distance matrix, associations of objects with clusters,
+ * This function logs the cluster centers, the distance matrix, associations of objects with clusters,
  * and any clusters that remain unassigned. Additionally, it logs initialization messages for unassigned clusters.
  *
  * @param clusterCenters A vector of 3D Eigen vectors representing the cluster centers.
@@ -18,32 +19,35 @@ auto printInfo(
     const std::vector<Eigen::Vector3f>& clusterCenters, const Eigen::MatrixXf& distanceMatrix,
     const std::vector<int>& associations, const std::vector<int>& unassignedClusters) -> void
 {
-    std::cout << "Cluster Centers:" << std::endl;
+    if (!Logger::instance().isEnabled(LogLevel::Debug))
+    {
+        return;
+    }
+    const Eigen::IOFormat singleLine(Eigen::StreamPrecision, Eigen::DontAlignCols, " ", "; ", "", "", "[", "]");
+    std::ostringstream centers;
     for (const auto& center : clusterCenters)
     {
-        std::cout << center.transpose() << std::endl;
+        centers << center.transpose().format(singleLine) << " ";
     }
+    LOG_DEBUG("tracker", "Cluster Centers: " << centers.str());
+    LOG_DEBUG("tracker", "Distance Matrix: " << distanceMatrix.format(singleLine));
 
-    std::cout << "Distance Matrix:" << std::endl;
-    std::cout << distanceMatrix << std::endl;
-
-    std::cout << "Associations: ";
+    std::ostringstream assignments;
+    assignments << "Associations: ";
     for (const auto& assoc : associations)
     {
-        std::cout << assoc << " ";
+        assignments << assoc << " ";
     }
-    std::cout << std::endl;
-
-    std::cout << "Unassigned Clusters: ";
+    assignments << "Unassigned Clusters: ";
     for (const auto& cluster : unassignedClusters)
     {
-        std::cout << cluster << " ";
+        assignments << cluster << " ";
     }
-    std::cout << std::endl;
+    LOG_DEBUG("tracker", assignments.str());
 
     for (const auto& cluster : unassignedClusters)
     {
-        std::cout << "Initializing new filter for cluster: " << cluster << std::endl;
+        LOG_DEBUG("tracker", "Initializing new filter for cluster: " << cluster);
     }
 }
 
@@ -2,10 +2,9 @@
 
 #include "pch.h"
 
-/**
- * @brief Parses the JSON configuration file to initialize socket and pipeline variables.
- */
-auto parseJsonConfig(const std::string& jsonFilePath) -> std::tuple<SocketVariables, PipelineVariables>
+namespace
+{
+nlohmann::json readJsonFile(const std::string& jsonFilePath)
 {
     std::ifstream inputFile(jsonFilePath);
     if (!inputFile.is_open())
@@ -15,19 +14,40 @@ auto parseJsonConfig(const std::string& jsonFilePath) -> std::tuple<SocketVariab
 
     nlohmann::json jsonConfig;
     inputFile >> jsonConfig;
+    return jsonConfig;
+}
 
+/**
+ * @brief Reads the socket and pipeline variables of one stream from a parsed configuration object.
+ */
+auto parseStreamObject(const nlohmann::json& jsonConfig) -> std::tuple<SocketVariables, PipelineVariables>
+{
     SocketVariables socketVariables;
     PipelineVariables pipelineVariables;
 
     // SocketVariables parameters
     socketVariables.ipAddress = jsonConfig.at("networkIPAddress").get<std::string>();
     socketVariables.port = jsonConfig.at("networkPort").get<int>();
+    socketVariables.receiveBatchSize = jsonConfig.value("receiveBatchSize", socketVariables.receiveBatchSize);
+    socketVariables.socketBackend = jsonConfig.value("socketBackend", socketVariables.socketBackend);
+    socketVariables.listenerCore = jsonConfig.value("listenerCore", socketVariables.listenerCore);
+    socketVariables.captureFilePath = jsonConfig.value("captureFile", socketVariables.captureFilePath);
+    socketVariables.replayFilePath = jsonConfig.value("replayFile", socketVariables.replayFilePath);
+    socketVariables.replaySpeed = jsonConfig.value("replaySpeed", socketVariables.replaySpeed);
 
     // PipelineVariables parameters
     pipelineVariables.integrationTesting = jsonConfig.at("enableIntegrationTesting").get<bool>();
     pipelineVariables.firmware = jsonConfig.at("firmware").get<std::string>();
     pipelineVariables.speedOfSound = jsonConfig.at("speedOfSound_mps").get<float>();
     pipelineVariables.loggingDirectory = jsonConfig.at("logDirectory").get<std::string>();
+    pipelineVariables.detectionLogFormat = jsonConfig.value("detectionLogFormat", pipelineVariables.detectionLogFormat);
+    pipelineVariables.liveOutputAddress = jsonConfig.value("liveOutputAddress", pipelineVariables.liveOutputAddress);
+    pipelineVariables.metricsFile = jsonConfig.value("metricsFile", pipelineVariables.metricsFile);
+    pipelineVariables.metricsPort = jsonConfig.value("metricsPort", pipelineVariables.metricsPort);
+    pipelineVariables.metricsIntervalSeconds =
+        jsonConfig.value("metricsIntervalSeconds", pipelineVariables.metricsIntervalSeconds);
+    pipelineVariables.logLevel = jsonConfig.value("logLevel", pipelineVariables.logLevel);
+    pipelineVariables.logRateLimit = jsonConfig.value("logRateLimit", pipelineVariables.logRateLimit);
     pipelineVariables.timeDomainDetector = jsonConfig.at("timeDomainDetector").get<std::string>();
     pipelineVariables.timeDomainThreshold = jsonConfig.at("timeDomainThreshold").get<float>();
     pipelineVariables.frequencyDomainStrategy = jsonConfig.at("frequencyDomainStrategy").get<std::string>();
@@ -42,12 +62,125 @@ auto parseJsonConfig(const std::string& jsonFilePath) -> std::tuple<SocketVariab
         std::chrono::seconds(jsonConfig.at("clusteringWindowSeconds").get<int>());
     pipelineVariables.onnxModelPath = jsonConfig.at("onnxModelPath").get<std::string>();
     pipelineVariables.onnxModelNormalizationPath = jsonConfig.at("onnxNormalizationParams").get<std::string>();
+    pipelineVariables.enableStreamResync = jsonConfig.value("enableStreamResync", pipelineVariables.enableStreamResync);
+    pipelineVariables.processingCore = jsonConfig.value("processingCore", pipelineVariables.processingCore);
+    pipelineVariables.windowHopPackets = jsonConfig.value("windowHopPackets", pipelineVariables.windowHopPackets);
+    pipelineVariables.enableLoadShedding = jsonConfig.value("enableLoadShedding", pipelineVariables.enableLoadShedding);
+    pipelineVariables.loadSheddingEnterQueueDepths =
+        jsonConfig.value("loadSheddingEnterQueueDepths", pipelineVariables.loadSheddingEnterQueueDepths);
+    pipelineVariables.loadSheddingExitQueueDepths =
+        jsonConfig.value("loadSheddingExitQueueDepths", pipelineVariables.loadSheddingExitQueueDepths);
+    pipelineVariables.loadSheddingThresholdScale =
+        jsonConfig.value("loadSheddingThresholdScale", pipelineVariables.loadSheddingThresholdScale);
+    pipelineVariables.enableStagedPipeline =
+        jsonConfig.value("enableStagedPipeline", pipelineVariables.enableStagedPipeline);
+    pipelineVariables.stageCores = jsonConfig.value("stageCores", pipelineVariables.stageCores);
+    pipelineVariables.windowWorkers = jsonConfig.value("windowWorkers", pipelineVariables.windowWorkers);
+    pipelineVariables.workerCores = jsonConfig.value("workerCores", pipelineVariables.workerCores);
+    pipelineVariables.enableAsyncClassifier =
+        jsonConfig.value("enableAsyncClassifier", pipelineVariables.enableAsyncClassifier);
+    pipelineVariables.classifierCore = jsonConfig.value("classifierCore", pipelineVariables.classifierCore);
+    pipelineVariables.classifierDeadlineMs =
+        jsonConfig.value("classifierDeadlineMs", pipelineVariables.classifierDeadlineMs);
 
     return std::make_tuple(socketVariables, pipelineVariables);
 }
+}  // namespace
 
 /**
- * @brief Prints whether the program is running in Debug or Release mode.
+ * @brief Parses the JSON configuration file to initialize socket and pipeline variables.
+ */
+auto parseJsonConfig(const std::string& jsonFilePath) -> std::tuple<SocketVariables, PipelineVariables>
+{
+    return parseStreamObject(readJsonFile(jsonFilePath));
+}
+
+/**
+ * @brief Parses the JSON configuration file into one set of socket and pipeline variables per input stream.
+ *
+ * A configuration without a "streams" array describes a single stream, exactly as parseJsonConfig reads it. Otherwise
+ * each element of "streams" is merged over the top-level keys, so a stream only needs the keys that differ (typically
+ * networkIPAddress, networkPort, firmware and receiverPositionsFile). When several streams share the top-level
+ * logDirectory, each stream's output files are prefixed with its port so they cannot collide.
+ *
+ * @throws std::runtime_error If the file cannot be opened or "streams" is not a non-empty array.
+ */
+auto parseStreamConfigs(const std::string& jsonFilePath) -> std::vector<std::tuple<SocketVariables, PipelineVariables>>
+{
+    const nlohmann::json jsonConfig = readJsonFile(jsonFilePath);
+    if (!jsonConfig.contains("streams"))
+    {
+        return {parseStreamObject(jsonConfig)};
+    }
+
+    const nlohmann::json& streams = jsonConfig.at("streams");
+    if (!streams.is_array() || streams.empty())
+    {
+        throw std::runtime_error("\"streams\" must be a non-empty array in " + jsonFilePath + "\n");
+    }
+
+    nlohmann::json sharedConfig = jsonConfig;
+    sharedConfig.erase("streams");
+
+    std::vector<std::tuple<SocketVariables, PipelineVariables>> streamConfigs;
+    for (const nlohmann::json& stream : streams)
+    {
+        nlohmann::json streamConfig = sharedConfig;
+        streamConfig.update(stream);
+
+        auto [socketVariables, pipelineVariables] = parseStreamObject(streamConfig);
+        if (streams.size() > 1 && !stream.contains("logDirectory"))
+        {
+            pipelineVariables.loggingDirectory += "port" + std::to_string(socketVariables.port) + "_";
+        }
+        streamConfigs.emplace_back(socketVariables, pipelineVariables);
+    }
+    return streamConfigs;
+}
+
+/**
+ * @brief Restricts a running thread to a single CPU core.
+ *
+ * Pinning is best effort: a failure is reported and the thread keeps running unpinned.
+ *
+ * @param thread The thread to pin.
+ * @param core Index of the core to run on; a negative value leaves the thread unpinned.
+ */
+void pinThreadToCore(std::thread& thread, int core)
+{
+    if (core < 0)
+    {
+        return;
+    }
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core, &cpuSet);
+    int result = pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+    if (result != 0)
+    {
+        std::cerr << "Unable to pin thread to core " << core << ": " << strerror(result) << std::endl;
+    }
+#else
+    std::cerr << "Thread pinning is not supported on this platform; core " << core << " ignored" << std::endl;
+#endif
+}
+
+namespace
+{
+std::atomic<bool> programStopRequested = false;
+}  // namespace
+
+/**
+ * @brief Asks every stream to wind down: listener and pipeline threads poll the flag and stop, then each
+ * StreamRunner::run drains its detections to disk and returns, for main to join.
+ */
+void requestProgramStop() { programStopRequested.store(true, std::memory_order_release); }
+
+bool isProgramStopRequested() { return programStopRequested.load(std::memory_order_acquire); }
+
+/**
+ * @brief Prints whether the program is running in Debug or Release mode, and whether stage tracing is compiled in.
  */
 void printMode()
 {
@@ -56,6 +189,9 @@ void printMode()
 #else
     std::cout << "Running Release Mode" << std::endl;
 #endif
+#ifdef FREEWILLI_TRACING
+    std::cout << "Stage tracing enabled" << std::endl;
+#endif
 }
 
 /**
@@ -5,6 +5,14 @@
 
 auto parseJsonConfig(const std::string& jsonFilePath) -> std::tuple<SocketVariables, PipelineVariables>;
 
+auto parseStreamConfigs(const std::string& jsonFilePath) -> std::vector<std::tuple<SocketVariables, PipelineVariables>>;
+
+void pinThreadToCore(std::thread& thread, int core);
+
 void printMode();
 
+void requestProgramStop();
+
+bool isProgramStopRequested();
+
 std::string convertTimePointToString(const TimePoint& timePoint);
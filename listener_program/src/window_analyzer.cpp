@@ -0,0 +1,147 @@
+#include "window_analyzer.h"
+
+#include "algorithms/doa_utils.h"
+#include "logger.h"
+#include "stage_tracer.h"
+
+namespace
+{
+/**
+ * @brief The classifier's input: magnitudes of the top 500 bins of the reference channel's unfiltered spectrum.
+ */
+std::vector<float> classifierInput(const WindowJob& job)
+{
+    // std::vector<float> input_tensor_values = getExampleClick();
+    Eigen::VectorXf spectraToInference = job.unfilteredSpectra.array().abs();
+
+    // std::cout << "Inference spectra: " << std::endl;
+    // std::cout << spectraToInference.tail(500).head(5).transpose() << std::endl;
+    // std::cout << spectraToInference.tail(500).tail(5).transpose() << std::endl;
+
+    Eigen::VectorXf spectraToInferenceFinal = spectraToInference.tail(500);
+    return std::vector<float>(
+        spectraToInferenceFinal.data(), spectraToInferenceFinal.data() + spectraToInferenceFinal.size());
+}
+}  // namespace
+
+/**
+ * @param leastSquaresMatrix Precomputed DOA matrix; must outlive the analyzer.
+ * @param metrics The stream's metrics, for the detector and classifier counts.
+ * @param loadShedder The pipeline's load shedder, to count skipped classifications; null when shedding is disabled.
+ * @param asyncClassifier Classifier thread to submit windows to, leaving the verdict in the job; null to classify here.
+ */
+WindowAnalyzer::WindowAnalyzer(
+    const PipelineVariables& pipelineVariables, const IFirmware& firmware, SharedPipelineResources& sharedResources,
+    const Eigen::MatrixXf& leastSquaresMatrix, int rankOfHydrophoneMatrix, MetricsRegistry& metrics,
+    LoadShedder* loadShedder, AsyncClassifier* asyncClassifier)
+    : mMetrics(metrics),
+      mLoadShedder(loadShedder),
+      mAsyncClassifier(asyncClassifier),
+      mCachedLeastSquaresResult(leastSquaresMatrix),
+      mRankOfHydrophoneMatrix(rankOfHydrophoneMatrix),
+      mChannelData(Eigen::MatrixXf::Zero(firmware.numChannels(), firmware.channelSize())),
+      mFilter(IFrequencyDomainStrategyFactory::create(
+          pipelineVariables.frequencyDomainStrategy, pipelineVariables.filterWeightsPath, mChannelData,
+          firmware.numChannels(), sharedResources.filterSpectrum(pipelineVariables, firmware.channelSize()))),
+      mFrequencyDomainDetector(IFrequencyDomainDetectorFactory::create(
+          pipelineVariables.frequencyDomainDetector, pipelineVariables.energyDetectionThreshold)),
+      mOnnxModel(sharedResources.onnxModel(pipelineVariables)),
+      mComputeTDOAs(
+          mFilter->getPaddedLength(), mFilter->getFrequencyDomainData().rows(), firmware.numChannels(),
+          firmware.sampleRate())
+{
+}
+
+/**
+ * @brief Filters the window in the frequency domain and runs the frequency-domain detector.
+ */
+void WindowAnalyzer::filter(WindowJob& job)
+{
+    if (!job.isCandidate)
+    {
+        return;
+    }
+    // The FFT input is zero-padded past the window; only the window part is overwritten
+    {
+        TRACE_STAGE(Filter);
+        mChannelData.leftCols(job.samples.cols()) = job.samples;
+
+        // std::cout << "apply addr channelData: " << mChannelData.data() <<
+        // std::endl;
+        mFilter->apply();
+        job.spectra = mFilter->getFrequencyDomainData();
+        job.unfilteredSpectra = mFilter->mBeforeFilter;
+    }
+
+    TRACE_STAGE(FrequencyDomainDetector);
+    job.isCandidate = mFrequencyDomainDetector->detect(job.spectra.col(0));
+    if (job.isCandidate)
+    {
+        mMetrics.add(MetricCounter::FrequencyDomainDetections);
+    }
+}
+
+/**
+ * @brief Rejects windows the ONNX model labels as noise, or submits them to the asynchronous classifier so that the
+ * output stage can reject them once the verdict arrives.
+ */
+void WindowAnalyzer::classify(WindowJob& job)
+{
+    if (!job.isCandidate || !mOnnxModel)
+    {
+        return;
+    }
+    if (job.tier >= OverloadTier::SkipClassifier)
+    {
+        mLoadShedder->recordShed(ShedAction::ClassifierSkipped);
+        return;
+    }
+
+    std::vector<float> spectraVector = classifierInput(job);
+    if (mAsyncClassifier)
+    {
+        job.classification = mAsyncClassifier->submit(std::move(spectraVector));
+        return;
+    }
+    std::vector<float> output;
+    {
+        TRACE_STAGE(Classifier);
+        output = mOnnxModel->runInference(spectraVector);
+    }
+    // std::cout << "Classification: \n";
+    // for (const auto& val : output)
+    //{
+    //     std::cout << val << " ";
+    // }
+    // std::cout << std::endl;
+    if (ONNXModel::isNoise(output))
+    {
+        LOG_DEBUG("classifier", "Noise detected");
+        mMetrics.add(MetricCounter::ClassifierRejections);
+        job.isCandidate = false;
+    }
+}
+
+/**
+ * @brief Estimates the TDOAs by GCC-PHAT and the direction of arrival from them.
+ */
+void WindowAnalyzer::localise(WindowJob& job)
+{
+    if (!job.isCandidate)
+    {
+        return;
+    }
+    {
+        TRACE_STAGE(GccPhat);
+        auto tdoasAndXCorrAmps = mComputeTDOAs.process(job.spectra);
+        job.tdoas = std::get<0>(tdoasAndXCorrAmps);
+        job.xCorrAmps = std::get<1>(tdoasAndXCorrAmps);
+    }
+
+    {
+        TRACE_STAGE(Doa);
+        job.directionOfArrival = computeDoaFromTdoa(mCachedLeastSquaresResult, job.tdoas, mRankOfHydrophoneMatrix);
+    }
+    // The conversion is only for display, so it is skipped unless debug logging is on
+    LOG_DEBUG("pipeline", "AzEl: " << convertDoaToElAz(job.directionOfArrival).transpose());
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "ML/async_classifier.h"
+#include "ML/onnx_model.h"
+#include "algorithms/fir_filter_factory.h"
+#include "algorithms/frequency_domain_detectors_factory.h"
+#include "algorithms/gcc_phat.h"
+#include "firmware/firmware_interface.h"
+#include "load_shedder.h"
+#include "metrics_registry.h"
+#include "pch.h"
+#include "shared_pipeline_resources.h"
+#include "window_job.h"
+
+/**
+ * @class WindowAnalyzer
+ * @brief The work done on a candidate window after decode: spectral filtering and detection, classification and
+ * localisation.
+ *
+ * Owns everything these steps write to (the FFT input, the FFTW plans and the GCC-PHAT buffers), so windows can be
+ * analysed in parallel by giving each thread its own analyzer. Each of filter, classify and localise only touches its
+ * own members, so the three may also run on different threads as long as each runs on one. The ONNX model, the
+ * asynchronous classifier and the DOA matrix are shared.
+ */
+class WindowAnalyzer
+{
+   public:
+    WindowAnalyzer(
+        const PipelineVariables& pipelineVariables, const IFirmware& firmware,
+        SharedPipelineResources& sharedResources, const Eigen::MatrixXf& leastSquaresMatrix, int rankOfHydrophoneMatrix,
+        MetricsRegistry& metrics, LoadShedder* loadShedder, AsyncClassifier* asyncClassifier);
+
+    void filter(WindowJob& job);
+    void classify(WindowJob& job);
+    void localise(WindowJob& job);
+
+    void analyse(WindowJob& job)
+    {
+        filter(job);
+        classify(job);
+        localise(job);
+    }
+
+   private:
+    MetricsRegistry& mMetrics;
+    LoadShedder* const mLoadShedder;  ///< Null when load shedding is disabled.
+    AsyncClassifier* const mAsyncClassifier;  ///< Set to classify off the analysing thread; null to classify inline.
+    const Eigen::MatrixXf& mCachedLeastSquaresResult;  ///< Precomputed least-squares matrix for DOA estimation.
+    const int mRankOfHydrophoneMatrix;
+
+    Eigen::MatrixXf mChannelData;  ///< Zero-padded FFT input; only the window part is overwritten.
+    std::unique_ptr<IFrequencyDomainStrategy> mFilter = nullptr;
+    std::unique_ptr<IFrequencyDomainDetector> mFrequencyDomainDetector = nullptr;
+    std::shared_ptr<ONNXModel> mOnnxModel = nullptr;  ///< Possibly shared with other analyzers and streams.
+    GCC_PHAT mComputeTDOAs;
+};
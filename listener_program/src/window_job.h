@@ -0,0 +1,33 @@
+#pragma once
+#include "ML/async_classifier.h"
+#include "load_shedder.h"
+#include "pch.h"
+
+/**
+ * @brief One hop of the stream on its way through the pipeline stages.
+ *
+ * The decode stage fills in the window and everything it decided about it, so later stages never read state that the
+ * decode stage goes on to overwrite. Each later stage adds its results and clears isCandidate when the window is
+ * rejected. Jobs are recycled rather than freed, so their matrices are only allocated for the first few windows.
+ */
+struct WindowJob
+{
+    uint64_t sequence = 0;  ///< Position of the hop in the stream since process() started.
+    bool isCandidate = false;  ///< Still a detection; when false the job only carries housekeeping to the output stage.
+    OverloadTier tier = OverloadTier::Normal;  ///< Load shedding tier when the window was decoded.
+    bool scheduleCluster = false;  ///< Give the tracker its chance to cluster when this job reaches the output stage.
+
+    Eigen::MatrixXf samples;  ///< The window, channels x samples. Only filled for candidates.
+    TimePoint startTime;  ///< Timestamp of the window's first packet.
+    TimePoint arrivalTime;  ///< Socket arrival time of the window's last packet.
+    float peakAmplitude = 0;  ///< Time-domain detection statistic.
+    std::optional<Eigen::Matrix3f> rotation;  ///< Array orientation at decode time, for firmware with an IMU.
+
+    Eigen::MatrixXcf spectra;  ///< Filtered spectrum of each channel.
+    Eigen::MatrixXcf unfilteredSpectra;  ///< Spectrum of each channel before filtering, for the classifier.
+    AsyncClassifier::Pending classification;  ///< Verdict still to be awaited, when classifying asynchronously.
+
+    Eigen::VectorXf tdoas;
+    Eigen::VectorXf xCorrAmps;
+    Eigen::VectorXf directionOfArrival;
+};
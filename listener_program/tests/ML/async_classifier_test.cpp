@@ -0,0 +1,102 @@
+#include "../../src/ML/async_classifier.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+/** @brief Inference that doubles its input once released, so tests control when verdicts arrive. */
+class GatedInference
+{
+   public:
+    std::vector<float> operator()(std::vector<float>& features)
+    {
+        std::unique_lock<std::mutex> lock(mLock);
+        mReleased.wait(lock, [this]() { return mOpen; });
+        std::vector<float> output = features;
+        for (float& value : output)
+        {
+            value *= 2;
+        }
+        return output;
+    }
+
+    void open()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mOpen = true;
+        }
+        mReleased.notify_all();
+    }
+
+   private:
+    std::mutex mLock;
+    std::condition_variable mReleased;
+    bool mOpen = false;
+};
+}  // namespace
+
+// Test that each submission gets its own output back, computed on the classifier thread
+TEST(AsyncClassifierTest, ReturnsOutputOfEachSubmission)
+{
+    AsyncClassifier classifier(
+        [](std::vector<float>& features) { return std::vector<float>{features[0], features[1]}; }, 8,
+        std::chrono::seconds(5));
+
+    AsyncClassifier::Pending first = classifier.submit({1.0f, 2.0f});
+    AsyncClassifier::Pending second = classifier.submit({3.0f, 4.0f});
+
+    EXPECT_EQ(classifier.await(first), (std::vector<float>{1.0f, 2.0f}));
+    EXPECT_EQ(classifier.await(second), (std::vector<float>{3.0f, 4.0f}));
+    EXPECT_EQ(classifier.deadlineMisses(), 0u);
+}
+
+// Test that a verdict not ready by its deadline is abandoned and counted
+TEST(AsyncClassifierTest, CountsDeadlineMisses)
+{
+    GatedInference inference;
+    AsyncClassifier classifier(
+        [&inference](std::vector<float>& features) { return inference(features); }, 8, std::chrono::milliseconds(10));
+
+    AsyncClassifier::Pending pending = classifier.submit({1.0f});
+    EXPECT_EQ(classifier.await(pending), std::nullopt);
+    EXPECT_EQ(classifier.deadlineMisses(), 1u);
+    inference.open();
+}
+
+// Test that submissions beyond the queue capacity are refused and counted instead of blocking
+TEST(AsyncClassifierTest, RefusesSubmissionsWhenFull)
+{
+    GatedInference inference;
+    AsyncClassifier classifier(
+        [&inference](std::vector<float>& features) { return inference(features); }, 1, std::chrono::seconds(5));
+
+    // The first request is taken by the classifier thread, the second waits in the queue
+    AsyncClassifier::Pending running = classifier.submit({1.0f});
+    while (classifier.queueDepth() != 0)
+    {
+        std::this_thread::yield();
+    }
+    AsyncClassifier::Pending queued = classifier.submit({2.0f});
+    AsyncClassifier::Pending refused = classifier.submit({3.0f});
+
+    EXPECT_FALSE(refused.output.valid());
+    EXPECT_EQ(classifier.queueOverflows(), 1u);
+    EXPECT_EQ(classifier.maxQueueDepth(), 1u);
+
+    inference.open();
+    EXPECT_EQ(classifier.await(running), (std::vector<float>{2.0f}));
+    EXPECT_EQ(classifier.await(queued), (std::vector<float>{4.0f}));
+    EXPECT_EQ(classifier.await(refused), std::nullopt);
+}
+
+// Test that an exception thrown by the inference reaches the thread awaiting the verdict
+TEST(AsyncClassifierTest, PropagatesInferenceErrors)
+{
+    AsyncClassifier classifier(
+        [](std::vector<float>&) -> std::vector<float> { throw std::runtime_error("inference failed\n"); }, 8,
+        std::chrono::seconds(5));
+
+    AsyncClassifier::Pending pending = classifier.submit({1.0f});
+    EXPECT_THROW(classifier.await(pending), std::runtime_error);
+}
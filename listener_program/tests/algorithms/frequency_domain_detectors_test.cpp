@@ -94,3 +94,18 @@ TEST(AverageMagnitudeDetectorTest, ComplexMagnitudeComputation)
     float expectedAvgMag = (1.0f + 0.5f + 1.0f) / 3;
     EXPECT_EQ(detector.detect(frequencyData), expectedAvgMag >= threshold);
 }
+
+// Test: A column of a spectra matrix, or of a buffer owned elsewhere such as a NumPy array, is read in place
+TEST(AverageMagnitudeDetectorTest, DetectsOnSpectraColumnInPlace)
+{
+    AverageMagnitudeDetector detector(1.0f);
+
+    std::vector<std::complex<float>> buffer = {0.5f, 0.5f, 0.5f, 2.0f, 2.0f, 2.0f};  // column-major, 3 bins x 2 channels
+    Eigen::Map<Eigen::MatrixXcf> spectra(buffer.data(), 3, 2);
+
+    EXPECT_FALSE(detector.detect(spectra.col(0)));
+    EXPECT_TRUE(detector.detect(spectra.col(1)));
+
+    buffer[0] = 10.0f;  // no copy was taken, so later changes to the buffer are seen
+    EXPECT_TRUE(detector.detect(spectra.col(0)));
+}
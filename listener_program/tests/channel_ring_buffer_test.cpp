@@ -0,0 +1,94 @@
+#include "../src/channel_ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include "../src/firmware/firmware_1240.h"
+#include "../src/firmware/packet_generator_1240.h"
+
+class ChannelRingBufferTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        PacketGeneratorConfig config;
+        config.startTime = TimePoint(std::chrono::seconds(1'700'000'000));
+        config.clicksPerSecond = 200.0;
+        PacketGenerator1240 generator(config);
+
+        mPackets.resize(mNumPackets);
+        mTimes.resize(mNumPackets);
+        for (int i = 0; i < mNumPackets; i++)
+        {
+            generator.next(mPackets[i]);
+        }
+        std::vector<PacketView> views(mPackets.begin(), mPackets.end());
+        mFirmware.generateTimestamp(views, mTimes);
+    }
+
+    /// The window decoded directly from packets [first, first + window) into a fresh matrix.
+    Eigen::MatrixXf decodeWindow(int first)
+    {
+        const int window = mFirmware.numPacketsToDetect();
+        std::vector<PacketView> views(mPackets.begin() + first, mPackets.begin() + first + window);
+        Eigen::MatrixXf expected(mFirmware.numChannels(), mFirmware.channelSize());
+        mFirmware.insertDataIntoChannelMatrix(expected, views);
+        return expected;
+    }
+
+    void push(int first, int count)
+    {
+        std::vector<PacketView> views(mPackets.begin() + first, mPackets.begin() + first + count);
+        mRing.push(views, std::span<const TimePoint>(mTimes).subspan(first, count));
+    }
+
+    static constexpr int mNumPackets = 40;
+    Firmware1240 mFirmware;
+    ChannelRingBuffer mRing{mFirmware, mFirmware.numPacketsToDetect()};
+    std::vector<std::vector<uint8_t>> mPackets;
+    std::vector<TimePoint> mTimes;
+};
+
+// Test that the ring only reports a window once it holds a full window of packets
+TEST_F(ChannelRingBufferTest, FullAfterOneWindow)
+{
+    push(0, 7);
+    EXPECT_FALSE(mRing.isFull());
+    push(7, 1);
+    EXPECT_TRUE(mRing.isFull());
+    EXPECT_TRUE(mRing.window().isApprox(decodeWindow(0)));
+    EXPECT_EQ(mRing.windowStartTime(), mTimes[0]);
+}
+
+// Test that sliding one packet at a time always exposes the latest window, including across the ring's wrap
+TEST_F(ChannelRingBufferTest, SlidingWindowMatchesDirectDecode)
+{
+    const int window = mFirmware.numPacketsToDetect();
+    push(0, window);
+    for (int first = 1; first + window <= mNumPackets; first++)
+    {
+        push(first + window - 1, 1);
+        ASSERT_EQ(mRing.window().cols(), mFirmware.channelSize());
+        ASSERT_TRUE(mRing.window() == decodeWindow(first)) << "window starting at packet " << first;
+        ASSERT_EQ(mRing.windowStartTime(), mTimes[first]);
+    }
+}
+
+// Test that hops that straddle the end of the ring are split correctly
+TEST_F(ChannelRingBufferTest, HopsLongerThanRemainingRing)
+{
+    push(0, 5);
+    push(5, 5);
+    push(10, 5);
+    EXPECT_TRUE(mRing.window() == decodeWindow(7));
+    EXPECT_EQ(mRing.windowStartTime(), mTimes[7]);
+}
+
+// Test that reset starts a new window from scratch
+TEST_F(ChannelRingBufferTest, ResetEmptiesRing)
+{
+    push(0, 10);
+    mRing.reset();
+    EXPECT_FALSE(mRing.isFull());
+    push(20, mFirmware.numPacketsToDetect());
+    EXPECT_TRUE(mRing.window() == decodeWindow(20));
+}
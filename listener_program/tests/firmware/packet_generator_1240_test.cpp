@@ -0,0 +1,147 @@
+#include "../../src/firmware/packet_generator_1240.h"
+
+#include "../../src/firmware/firmware_1240.h"
+#include "gtest/gtest.h"
+
+class PacketGenerator1240Test : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        mConfig.startTime = TimePoint(std::chrono::seconds(1'700'000'000)) + std::chrono::microseconds(999'000);
+        mConfig.noiseAmplitude = 0.0f;
+        mConfig.clicksPerSecond = 0.0;
+    }
+
+    /// Generates numPackets packets, keeping the ones that are sent (twice for duplicates).
+    std::vector<std::vector<uint8_t>> generate(PacketGenerator1240& generator, int numPackets)
+    {
+        std::vector<std::vector<uint8_t>> packets;
+        std::vector<uint8_t> packet;
+        for (int i = 0; i < numPackets; i++)
+        {
+            const auto fate = generator.next(packet);
+            if (fate != PacketGenerator1240::PacketFate::Drop)
+            {
+                packets.push_back(packet);
+            }
+            if (fate == PacketGenerator1240::PacketFate::Duplicate)
+            {
+                packets.push_back(packet);
+            }
+        }
+        return packets;
+    }
+
+    static std::vector<PacketView> views(const std::vector<std::vector<uint8_t>>& packets)
+    {
+        return std::vector<PacketView>(packets.begin(), packets.end());
+    }
+
+    PacketGeneratorConfig mConfig;
+    Firmware1240 mFirmware;
+};
+
+// Generated packets decode to timestamps one packet interval apart and pass the listener's integrity checks
+TEST_F(PacketGenerator1240Test, TimestampsDecodeAndIncrementByPacketInterval)
+{
+    PacketGenerator1240 generator(mConfig);
+    auto packets = generate(generator, 10);
+    ASSERT_EQ(packets.size(), 10);
+    EXPECT_EQ(packets[0].size(), mFirmware.packetSize());
+
+    auto dataBytes = views(packets);
+    std::vector<TimePoint> times(packets.size());
+    mFirmware.generateTimestamp(dataBytes, times);
+    EXPECT_EQ(times[0], mConfig.startTime);
+    EXPECT_EQ(times[1] - times[0], std::chrono::microseconds(mFirmware.microIncre()));
+
+    bool isPreviousTimeSet = false;
+    TimePoint previousTime;
+    EXPECT_NO_THROW(mFirmware.throwIfDataErrors(dataBytes, isPreviousTimeSet, previousTime, times));
+}
+
+// Each channel receives the click after its configured delay
+TEST_F(PacketGenerator1240Test, ClicksArriveWithInjectedDelays)
+{
+    mConfig.clicksPerSecond = 50.0;
+    mConfig.clickAmplitude = 1000.0f;
+    mConfig.tdoaSamples = {0, 7, -3, 12};
+    PacketGenerator1240 generator(mConfig);
+
+    constexpr int numPackets = 40;
+    auto packets = generate(generator, numPackets);
+    Eigen::MatrixXf channelMatrix(mFirmware.numChannels(), numPackets * 124);
+    mFirmware.insertDataIntoChannelMatrix(channelMatrix, views(packets));
+
+    std::vector<int> firstArrival(mFirmware.numChannels(), -1);
+    for (int channel = 0; channel < mFirmware.numChannels(); channel++)
+    {
+        for (int sample = 0; sample < channelMatrix.cols(); sample++)
+        {
+            if (std::abs(channelMatrix(channel, sample)) > 1.0f)
+            {
+                firstArrival[channel] = sample;
+                break;
+            }
+        }
+        ASSERT_NE(firstArrival[channel], -1) << "no click on channel " << channel;
+    }
+    EXPECT_EQ(firstArrival[1] - firstArrival[0], 7);
+    EXPECT_EQ(firstArrival[2] - firstArrival[0], -3);
+    EXPECT_EQ(firstArrival[3] - firstArrival[0], 12);
+}
+
+// IMU packets carry the trailing IMU record the 1240_imu firmware parses
+TEST_F(PacketGenerator1240Test, ImuFirmwareAppendsImuRecord)
+{
+    mConfig.firmware = "1240_imu";
+    PacketGenerator1240 generator(mConfig);
+    auto packets = generate(generator, 1);
+
+    ASSERT_EQ(packets[0].size(), mFirmware.packetSize() + 32);
+    PacketView imu = PacketView(packets[0]).last(32);
+    EXPECT_EQ(imu[0], 'I');
+    EXPECT_EQ(imu[1], 'M');
+    EXPECT_TRUE(std::equal(imu.begin() + 4, imu.begin() + 10, packets[0].begin()));
+}
+
+// Time glitches trip the listener's increment check; size, drop and duplicate glitches hit their packets
+TEST_F(PacketGenerator1240Test, GlitchesRepeatEveryNPackets)
+{
+    mConfig.timeGlitchEvery = 4;
+    mConfig.sizeGlitchEvery = 3;
+    mConfig.dropEvery = 5;
+    mConfig.duplicateEvery = 7;
+    PacketGenerator1240 generator(mConfig);
+
+    std::vector<uint8_t> packet;
+    std::vector<PacketGenerator1240::PacketFate> fates;
+    std::vector<size_t> sizes;
+    std::vector<TimePoint> times;
+    for (int i = 0; i < 7; i++)
+    {
+        fates.push_back(generator.next(packet));
+        sizes.push_back(packet.size());
+        times.emplace_back();
+        mFirmware.generateTimestamp(std::vector<PacketView>{packet}, std::span<TimePoint>(&times.back(), 1));
+    }
+
+    EXPECT_EQ(sizes[2], mFirmware.packetSize() + PacketGenerator1240::sizeGlitchBytes);
+    EXPECT_EQ(sizes[3], mFirmware.packetSize());
+    EXPECT_EQ(times[3] - times[2], std::chrono::microseconds(1240 + PacketGenerator1240::timeGlitchMicroseconds));
+    EXPECT_EQ(times[4] - times[3], std::chrono::microseconds(1240));
+    EXPECT_EQ(fates[4], PacketGenerator1240::PacketFate::Drop);
+    EXPECT_EQ(fates[5], PacketGenerator1240::PacketFate::Send);
+    EXPECT_EQ(fates[6], PacketGenerator1240::PacketFate::Duplicate);
+}
+
+TEST_F(PacketGenerator1240Test, RejectsUnsupportedConfig)
+{
+    mConfig.firmware = "9999";
+    EXPECT_THROW(PacketGenerator1240 generator(mConfig), std::invalid_argument);
+
+    mConfig.firmware = "1240";
+    mConfig.tdoaSamples = {0, 1};
+    EXPECT_THROW(PacketGenerator1240 generator(mConfig), std::invalid_argument);
+}
@@ -0,0 +1,94 @@
+#include "../../src/firmware/recording_packetizer_1240.h"
+
+#include "gtest/gtest.h"
+
+class RecordingPacketizer1240Test : public ::testing::Test
+{
+   protected:
+    void TearDown() override { std::remove(mFile.c_str()); }
+
+    /** @brief Writes a Fortran-order int16 .npy recording in which sample i of channel c holds i - 1000 * c. */
+    void writeRecording(size_t numSamples, int numChannels)
+    {
+        std::string header = "{'descr': '<i2', 'fortran_order': True, 'shape': (" + std::to_string(numSamples) +
+                             ", " + std::to_string(numChannels) + "), }";
+        header.append(64 - (10 + header.size() + 1) % 64, ' ');
+        header += '\n';
+
+        std::vector<int16_t> data;
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            for (size_t i = 0; i < numSamples; i++)
+            {
+                data.push_back(static_cast<int16_t>(i - 1000 * channel));
+            }
+        }
+        std::ofstream file(mFile, std::ios::binary);
+        const uint16_t headerLength = static_cast<uint16_t>(header.size());
+        file.write("\x93NUMPY\x01\x00", 8);
+        file.put(static_cast<char>(headerLength & 0xFF));
+        file.put(static_cast<char>(headerLength >> 8));
+        file << header;
+        file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(int16_t));
+    }
+
+    const std::string mFile = "temp_recording_packetizer.npy";
+    const TimePoint mStartTime = TimePoint(std::chrono::seconds(1'699'146'061));
+    Firmware1240 mFirmware;
+};
+
+// Packets decode back to the recorded samples and to timestamps one packet interval apart
+TEST_F(RecordingPacketizer1240Test, PacketsDecodeToRecording)
+{
+    const int samplesPerPacket = mFirmware.channelSize() / mFirmware.numPacketsToDetect();
+    writeRecording(3 * samplesPerPacket, mFirmware.numChannels());
+    NpyRecording recording(mFile);
+    RecordingPacketizer1240 packetizer(recording, mStartTime);
+    ASSERT_EQ(packetizer.numPackets(), 3);
+
+    std::vector<std::vector<uint8_t>> packets(3, std::vector<uint8_t>(packetizer.packetSize()));
+    for (auto& packet : packets)
+    {
+        ASSERT_TRUE(packetizer.next(packet));
+    }
+    EXPECT_EQ(packetizer.packetsWritten(), 3);
+
+    const std::vector<PacketView> dataBytes(packets.begin(), packets.end());
+    std::vector<TimePoint> times(dataBytes.size());
+    mFirmware.generateTimestamp(dataBytes, times);
+    EXPECT_EQ(times[0], mStartTime);
+    EXPECT_EQ(times[2] - times[0], 2 * std::chrono::microseconds(mFirmware.microIncre()));
+
+    // Decoded samples are interleaved by channel
+    std::vector<float> channelBuffer(3 * samplesPerPacket * mFirmware.numChannels());
+    mFirmware.insertDataIntoChannelBuffer(channelBuffer, dataBytes);
+    for (size_t i : {size_t{0}, samplesPerPacket + size_t{5}, channelBuffer.size() / mFirmware.numChannels() - 1})
+    {
+        for (int channel = 0; channel < mFirmware.numChannels(); channel++)
+        {
+            EXPECT_EQ(channelBuffer[i * mFirmware.numChannels() + channel], recording.sample(i, channel));
+        }
+    }
+}
+
+// Samples that do not fill a whole packet are left out, as the simulator leaves them out
+TEST_F(RecordingPacketizer1240Test, DropsTrailingPartialPacket)
+{
+    const int samplesPerPacket = mFirmware.channelSize() / mFirmware.numPacketsToDetect();
+    writeRecording(2 * samplesPerPacket - 1, mFirmware.numChannels());
+    NpyRecording recording(mFile);
+    RecordingPacketizer1240 packetizer(recording, mStartTime);
+
+    std::vector<uint8_t> packet(packetizer.packetSize());
+    EXPECT_TRUE(packetizer.next(packet));
+    EXPECT_FALSE(packetizer.next(packet));
+    EXPECT_EQ(packetizer.packetsWritten(), 1);
+}
+
+// A recording with another channel count cannot be sent as firmware 1240
+TEST_F(RecordingPacketizer1240Test, RejectsWrongChannelCount)
+{
+    writeRecording(200, 3);
+    NpyRecording recording(mFile);
+    EXPECT_THROW(RecordingPacketizer1240(recording, mStartTime), std::invalid_argument);
+}
@@ -0,0 +1,97 @@
+#include "../../src/io/detection_log.h"
+
+#include "../../src/io/output_manager.h"
+#include "../../src/utils.h"
+#include "gtest/gtest.h"
+
+class DetectionLogTest : public ::testing::Test
+{
+   protected:
+    void TearDown() override
+    {
+        std::remove(mCsvFile.c_str());
+        std::remove(mBinaryFile.c_str());
+    }
+
+    /** @brief Logs the given number of detections from four channels in both formats. */
+    void writeDetections(int numDetections)
+    {
+        Eigen::VectorXf tdoas(6);
+        tdoas << 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f;
+        Eigen::VectorXf xCorrAmps(6);
+        xCorrAmps << 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f;
+
+        OutputManager outputManager(std::chrono::seconds(10), false, mLoggingPrefix, "both");
+        outputManager.initializeOutputFile(mFileTime, 4);
+        for (int i = 0; i < numDetections; i++)
+        {
+            outputManager.appendToBuffer(
+                100.0f + i, 0.5f, -0.5f, 0.25f, tdoas * i, xCorrAmps, mFileTime + std::chrono::microseconds(i),
+                std::chrono::microseconds(1000 + i));
+        }
+    }
+
+    const std::string mLoggingPrefix = "temp_detection_log_";
+    const TimePoint mFileTime = TimePoint(std::chrono::microseconds(1'700'000'000'000'000));
+    const std::string mCsvFile = mLoggingPrefix + convertTimePointToString(mFileTime);
+    const std::string mBinaryFile = mCsvFile + ".bin";
+};
+
+// Records come back field for field, with the header describing the channels and columns
+TEST_F(DetectionLogTest, RoundTripPreservesDetections)
+{
+    writeDetections(3);
+
+    DetectionLogReader reader(mBinaryFile);
+    EXPECT_EQ(reader.numChannels(), 4);
+    EXPECT_EQ(reader.numChannelPairs(), 6);
+    ASSERT_EQ(reader.columnNames().size(), 18u);
+    EXPECT_EQ(reader.columnNames()[5], "TDOA12");
+    EXPECT_EQ(reader.columnNames()[16], "XCorr34");
+    ASSERT_EQ(reader.size(), 3u);
+
+    DetectionLogRecord detection = reader.record(2);
+    EXPECT_EQ(detection.peakTime, mFileTime + std::chrono::microseconds(2));
+    EXPECT_FLOAT_EQ(detection.amplitude, 102.0f);
+    EXPECT_FLOAT_EQ(detection.doaY, -0.5f);
+    ASSERT_EQ(detection.tdoas.size(), 6u);
+    EXPECT_FLOAT_EQ(detection.tdoas[5], 12.0f);
+    EXPECT_FLOAT_EQ(detection.xCorrAmps[0], 0.1f);
+    EXPECT_EQ(detection.latency, std::chrono::microseconds(1002));
+}
+
+// Converting the binary log reproduces the CSV detection file
+TEST_F(DetectionLogTest, ConvertsToTheCsvFile)
+{
+    writeDetections(5);
+
+    std::ifstream csvFile(mCsvFile);
+    std::stringstream expected;
+    expected << csvFile.rdbuf();
+
+    std::stringstream converted;
+    DetectionLogReader(mBinaryFile).writeCsv(converted);
+    EXPECT_EQ(converted.str(), expected.str());
+}
+
+// Records are fixed-width and aligned, so the log can be mapped straight into an array
+TEST_F(DetectionLogTest, RecordsAreFixedWidth)
+{
+    EXPECT_EQ(DetectionLogFormat::recordSize(6), 80u);
+    EXPECT_EQ(DetectionLogFormat::recordSize(3), 56u);
+
+    writeDetections(4);
+    struct stat fileStatus;
+    ASSERT_EQ(stat(mBinaryFile.c_str(), &fileStatus), 0);
+    std::ifstream header(mBinaryFile, std::ios::binary);
+    DetectionLogFormat::DetectionLogFileHeader fileHeader;
+    header.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+    EXPECT_EQ(fileHeader.headerSize % DetectionLogFormat::alignment, 0u);
+    EXPECT_EQ(static_cast<size_t>(fileStatus.st_size), fileHeader.headerSize + 4 * fileHeader.recordSize);
+}
+
+// An unknown format is rejected when the output manager is built
+TEST_F(DetectionLogTest, RejectsUnknownFormat)
+{
+    EXPECT_THROW(OutputManager(std::chrono::seconds(10), false, mLoggingPrefix, "parquet"), std::invalid_argument);
+}
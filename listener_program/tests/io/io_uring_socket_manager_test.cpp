@@ -0,0 +1,58 @@
+#include "../../src/io/io_uring_socket_manager.h"
+
+#include "../../src/utils.h"
+#include "gtest/gtest.h"
+
+#ifdef HAVE_LIBURING
+TEST(IoUringSocketManagerTest, ReceiveBatchReturnsQueuedDatagramsWithTimestamps)
+{
+    SocketVariables socketVars;
+    socketVars.port = 8083;
+    socketVars.ipAddress = "127.0.0.1";
+    socketVars.receiveBatchSize = 8;
+    socketVars.socketBackend = "io_uring";
+
+    IoUringSocketManager socketManager(socketVars);
+    socketManager.restartListener();
+
+    std::vector<std::vector<uint8_t>> storage(8, std::vector<uint8_t>(2048));
+    std::vector<std::span<uint8_t>> buffers(storage.begin(), storage.end());
+    std::vector<size_t> lengths(buffers.size());
+    std::vector<TimePoint> arrivalTimes(buffers.size());
+
+    TimePoint sendTime = std::chrono::system_clock::now();
+    int senderSocket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = inet_addr("127.0.0.1");
+    destination.sin_port = htons(8083);
+
+    for (uint8_t i = 1; i <= 3; i++)
+    {
+        std::vector<uint8_t> payload(i * 10, i);
+        ::sendto(senderSocket, payload.data(), payload.size(), 0, (struct sockaddr*)&destination, sizeof(destination));
+    }
+    ::close(senderSocket);
+
+    // Completions may be reaped across several calls
+    int packetsReceived = 0;
+    while (packetsReceived < 3)
+    {
+        int received = socketManager.receiveBatch(
+            std::span(buffers).subspan(packetsReceived), std::span(lengths).subspan(packetsReceived),
+            std::span(arrivalTimes).subspan(packetsReceived), 0);
+        ASSERT_GE(received, 0);
+        packetsReceived += received;
+    }
+    TimePoint receiveTime = std::chrono::system_clock::now();
+
+    ASSERT_EQ(packetsReceived, 3);
+    for (int i = 0; i < packetsReceived; i++)
+    {
+        EXPECT_EQ(lengths[i], (i + 1) * 10);
+        EXPECT_EQ(storage[i][0], i + 1);
+        EXPECT_GE(arrivalTimes[i], sendTime - std::chrono::milliseconds(1));
+        EXPECT_LE(arrivalTimes[i], receiveTime);
+    }
+}
+#endif
@@ -0,0 +1,112 @@
+#include "../../src/io/live_publisher.h"
+
+#include "../../src/io/detection_log.h"
+#include "gtest/gtest.h"
+
+using namespace LiveMessageFormat;
+
+class LivePublisherTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        mConsumer = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        ASSERT_NE(mConsumer, -1);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, mSocketPath.c_str(), sizeof(address.sun_path) - 1);
+        unlink(mSocketPath.c_str());
+        ASSERT_EQ(bind(mConsumer, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    }
+
+    void TearDown() override
+    {
+        close(mConsumer);
+        unlink(mSocketPath.c_str());
+    }
+
+    std::string receive()
+    {
+        std::string message(4096, '\0');
+        ssize_t length = recv(mConsumer, message.data(), message.size(), 0);
+        message.resize(length < 0 ? 0 : static_cast<size_t>(length));
+        return message;
+    }
+
+    const std::string mSocketPath = "temp_live_publisher.sock";
+    int mConsumer = -1;
+};
+
+// A detection arrives as one datagram holding a detection log record
+TEST_F(LivePublisherTest, PublishesDetections)
+{
+    LivePublisher publisher("unix:" + mSocketPath);
+    const std::vector<float> tdoas = {1.0f, 2.0f, 3.0f};
+    const std::vector<float> xCorrAmps = {0.5f, 0.6f, 0.7f};
+    const TimePoint peakTime = TimePoint(std::chrono::microseconds(1'700'000'000'000'123));
+
+    publisher.publishDetection(10.0f, 0.1f, 0.2f, 0.3f, tdoas, xCorrAmps, peakTime, std::chrono::microseconds(1500));
+
+    std::string message = receive();
+    ASSERT_EQ(message.size(), sizeof(DetectionMessageHeader) + DetectionLogFormat::recordSize(3));
+    DetectionMessageHeader header;
+    std::memcpy(&header, message.data(), sizeof(header));
+    EXPECT_EQ(header.type, MessageType::Detection);
+    EXPECT_EQ(header.numChannelPairs, 3u);
+
+    int64_t peakTimeUs;
+    float pairValues[6];
+    std::memcpy(&peakTimeUs, message.data() + sizeof(header), sizeof(peakTimeUs));
+    std::memcpy(pairValues, message.data() + sizeof(header) + 24, sizeof(pairValues));
+    EXPECT_EQ(peakTimeUs, 1'700'000'000'000'123);
+    EXPECT_EQ(pairValues[2], 3.0f);
+    EXPECT_EQ(pairValues[5], 0.7f);
+    EXPECT_EQ(publisher.sent(), 1u);
+}
+
+// A track update arrives as one fixed-size datagram
+TEST_F(LivePublisherTest, PublishesTrackUpdates)
+{
+    LivePublisher publisher("unix:" + mSocketPath);
+    publisher.publishTrackUpdate(7, TimePoint(std::chrono::microseconds(42)), 45.0, -90.0);
+
+    std::string message = receive();
+    ASSERT_EQ(message.size(), sizeof(TrackUpdateMessage));
+    TrackUpdateMessage update;
+    std::memcpy(&update, message.data(), sizeof(update));
+    EXPECT_EQ(update.type, MessageType::TrackUpdate);
+    EXPECT_EQ(update.trackId, 7);
+    EXPECT_EQ(update.timeUs, 42);
+    EXPECT_EQ(update.azimuth, -90.0);
+}
+
+// A consumer that stops reading costs dropped messages, never a blocked publisher
+TEST_F(LivePublisherTest, DropsInsteadOfBlockingOnASlowConsumer)
+{
+    LivePublisher publisher("unix:" + mSocketPath);
+    const int numMessages = 100'000;
+    for (int i = 0; i < numMessages; i++)
+    {
+        publisher.publishTrackUpdate(i, std::chrono::system_clock::now(), 0.0, 0.0);
+    }
+    EXPECT_GT(publisher.dropped(), 0u);
+    EXPECT_EQ(publisher.sent() + publisher.dropped(), static_cast<uint64_t>(numMessages));
+
+    // Nobody listening at all is a drop too
+    close(mConsumer);
+    unlink(mSocketPath.c_str());
+    mConsumer = -1;
+    uint64_t droppedBefore = publisher.dropped();
+    publisher.publishTrackUpdate(0, std::chrono::system_clock::now(), 0.0, 0.0);
+    EXPECT_EQ(publisher.dropped(), droppedBefore + 1);
+}
+
+// Addresses other than udp:<ip>:<port> and unix:<path> are rejected
+TEST_F(LivePublisherTest, RejectsMalformedAddresses)
+{
+    EXPECT_THROW(LivePublisher("tcp:127.0.0.1:5000"), std::invalid_argument);
+    EXPECT_THROW(LivePublisher("udp:127.0.0.1"), std::invalid_argument);
+    EXPECT_THROW(LivePublisher("udp:127.0.0.1:70000"), std::invalid_argument);
+    EXPECT_THROW(LivePublisher("unix:"), std::invalid_argument);
+    EXPECT_NO_THROW(LivePublisher("udp:127.0.0.1:5000"));
+}
@@ -0,0 +1,130 @@
+#include "../../src/io/metrics_exporter.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+/**
+ * @brief Sends a GET request to 127.0.0.1:port and returns the whole response.
+ */
+std::string httpGet(int port)
+{
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1)
+    {
+        close(client);
+        return "";
+    }
+    const std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+    send(client, request.data(), request.size(), MSG_NOSIGNAL);
+
+    std::string response;
+    std::array<char, 4096> chunk;
+    for (ssize_t length; (length = recv(client, chunk.data(), chunk.size(), 0)) > 0;)
+    {
+        response.append(chunk.data(), static_cast<size_t>(length));
+    }
+    close(client);
+    return response;
+}
+}  // namespace
+
+// Counters and gauges keep their values and high-water marks only ever rise
+TEST(MetricsExporterTest, RegistryCountsAndTracksHighWaterMarks)
+{
+    MetricsRegistry metrics;
+    metrics.add(MetricCounter::WindowsProcessed);
+    metrics.add(MetricCounter::WindowsProcessed, 4);
+    metrics.raise(MetricGauge::QueueHighWaterMark, 30);
+    metrics.raise(MetricGauge::QueueHighWaterMark, 12);
+    metrics.set(MetricGauge::TrackerFilters, 3);
+    metrics.set(MetricGauge::TrackerFilters, 1);
+
+    EXPECT_EQ(metrics.value(MetricCounter::WindowsProcessed), 5u);
+    EXPECT_EQ(metrics.value(MetricCounter::Flushes), 0u);
+    EXPECT_EQ(metrics.value(MetricGauge::QueueHighWaterMark), 30u);
+    EXPECT_EQ(metrics.value(MetricGauge::TrackerFilters), 1u);
+}
+
+// Every stream's metrics appear under its own label in the Prometheus text format
+TEST(MetricsExporterTest, RendersEveryStream)
+{
+    SharedDataManager first;
+    SharedDataManager second;
+    first.packetsReceived = 1200;
+    second.metrics.add(MetricCounter::ClassifierRejections, 7);
+    second.metrics.flushDuration().record(std::chrono::microseconds(300));
+
+    MetricsExporter exporter("", 0, std::chrono::seconds(10));
+    exporter.addStream("port1045", first);
+    exporter.addStream("port1046", second);
+    const std::string text = exporter.render();
+
+    EXPECT_NE(text.find("# TYPE freewilli_packets_received_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("freewilli_packets_received_total{stream=\"port1045\"} 1200\n"), std::string::npos);
+    EXPECT_NE(text.find("freewilli_classifier_rejections_total{stream=\"port1046\"} 7\n"), std::string::npos);
+    EXPECT_NE(text.find("freewilli_queue_depth_high_water_mark{stream=\"port1045\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("freewilli_flush_duration_microseconds_count{stream=\"port1046\"} 1\n"), std::string::npos);
+}
+
+// The file is rewritten in place and the endpoint answers scrapes with the same metrics
+TEST(MetricsExporterTest, WritesFileAndServesHttp)
+{
+    const std::string filePath = "temp_metrics.prom";
+    const int port = 39217;
+    SharedDataManager sharedDataManager;
+    sharedDataManager.detectionCounter = 42;
+    {
+        MetricsExporter exporter(filePath, port, std::chrono::seconds(1));
+        exporter.addStream("port1045", sharedDataManager);
+        exporter.start();
+
+        const std::string response = httpGet(port);
+        EXPECT_EQ(response.rfind("HTTP/1.0 200 OK\r\n", 0), 0u);
+        EXPECT_NE(response.find("freewilli_detections_total{stream=\"port1045\"} 42\n"), std::string::npos);
+
+        sharedDataManager.detectionCounter = 43;
+    }
+
+    // The exporter writes the file one last time when it stops
+    std::ifstream file(filePath);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_NE(contents.str().find("freewilli_detections_total{stream=\"port1045\"} 43\n"), std::string::npos);
+    EXPECT_FALSE(std::filesystem::exists(filePath + ".tmp"));
+    std::filesystem::remove(filePath);
+}
+
+// A scraper that connects and never reads is dropped instead of stalling the exporter
+TEST(MetricsExporterTest, StalledClientDoesNotBlockShutdown)
+{
+    const int port = 39218;
+    SharedDataManager sharedDataManager;
+    auto exporter = std::make_unique<MetricsExporter>("", port, std::chrono::seconds(1));
+    for (int i = 0; i < 2000; i++)
+    {
+        exporter->addStream("port" + std::to_string(i), sharedDataManager);  // a response far larger than the buffers
+    }
+    exporter->start();
+
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    int bufferSize = 1;
+    setsockopt(client, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    ASSERT_EQ(connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    const std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+    send(client, request.data(), request.size(), MSG_NOSIGNAL);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));  // let the exporter start sending
+
+    const auto start = std::chrono::steady_clock::now();
+    exporter.reset();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    close(client);
+}
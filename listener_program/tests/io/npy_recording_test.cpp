@@ -0,0 +1,73 @@
+#include "../../src/io/npy_recording.h"
+
+#include "gtest/gtest.h"
+
+class NpyRecordingTest : public ::testing::Test
+{
+   protected:
+    void TearDown() override { std::remove(mFile.c_str()); }
+
+    /** @brief Writes a version 1.0 .npy file holding the given raw elements behind the given dtype and shape. */
+    void writeNpy(const std::string& descr, bool fortranOrder, const std::string& shape, std::span<const int16_t> data)
+    {
+        std::string header = "{'descr': '" + descr + "', 'fortran_order': " + (fortranOrder ? "True" : "False") +
+                             ", 'shape': " + shape + ", }";
+        header.append(64 - (10 + header.size() + 1) % 64, ' ');  // numpy pads the header to a 64 byte boundary
+        header += '\n';
+
+        std::ofstream file(mFile, std::ios::binary);
+        const uint16_t headerLength = static_cast<uint16_t>(header.size());
+        file.write("\x93NUMPY\x01\x00", 8);
+        file.put(static_cast<char>(headerLength & 0xFF));
+        file.put(static_cast<char>(headerLength >> 8));
+        file << header;
+        file.write(reinterpret_cast<const char*>(data.data()), data.size_bytes());
+    }
+
+    const std::string mFile = "temp_npy_recording.npy";
+};
+
+// Samples are read by sample index and channel whichever order the matrix was stored in
+TEST_F(NpyRecordingTest, ReadsCAndFortranOrder)
+{
+    // Three samples of two channels: sample i of channel c holds 10 * i + c
+    const std::vector<int16_t> rowMajor = {0, 1, 10, 11, -20, -19};
+    const std::vector<int16_t> columnMajor = {0, 10, -20, 1, 11, -19};
+
+    for (bool fortranOrder : {false, true})
+    {
+        writeNpy("<i2", fortranOrder, "(3, 2)", fortranOrder ? columnMajor : rowMajor);
+        NpyRecording recording(mFile);
+
+        EXPECT_EQ(recording.numSamples(), 3);
+        EXPECT_EQ(recording.numChannels(), 2);
+        EXPECT_EQ(recording.sample(0, 1), 1);
+        EXPECT_EQ(recording.sample(1, 0), 10);
+        EXPECT_EQ(recording.sample(2, 1), -19);
+    }
+}
+
+// Only int16 sample matrices are accepted
+TEST_F(NpyRecordingTest, RejectsOtherDtypesAndShapes)
+{
+    const std::vector<int16_t> data(6, 0);
+
+    writeNpy("<f4", false, "(3, 1)", data);
+    EXPECT_THROW(NpyRecording{mFile}, std::invalid_argument);
+
+    writeNpy("<i2", false, "(6,)", data);
+    EXPECT_THROW(NpyRecording{mFile}, std::invalid_argument);
+}
+
+// Missing, non-.npy and truncated files are reported rather than read past their end
+TEST_F(NpyRecordingTest, RejectsUnreadableFiles)
+{
+    EXPECT_THROW(NpyRecording{"no_such_recording.npy"}, std::runtime_error);
+
+    std::ofstream(mFile) << "not a numpy file at all, but long enough";
+    EXPECT_THROW(NpyRecording{mFile}, std::runtime_error);
+
+    const std::vector<int16_t> data(2, 0);
+    writeNpy("<i2", false, "(3, 2)", data);
+    EXPECT_THROW(NpyRecording{mFile}, std::runtime_error);
+}
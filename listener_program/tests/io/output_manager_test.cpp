@@ -3,6 +3,22 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "../../src/utils.h"
+
+namespace
+{
+std::vector<std::string> readLines(const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);)
+    {
+        lines.push_back(line);
+    }
+    return lines;
+}
+}  // namespace
+
 TEST(OutputManagerTest, AppendToBufferAndFlush)
 {
     OutputManager outputManager(std::chrono::seconds(10), false, "logs/");
@@ -16,7 +32,8 @@ TEST(OutputManagerTest, AppendToBufferAndFlush)
     TimePoint peakTime = std::chrono::system_clock::now();
 
     // Append data to buffer
-    outputManager.appendToBuffer(10.0, 0.1, 0.2, 0.3, tdoaVector, xCorrAmps, peakTime);
+    outputManager.appendToBuffer(
+        10.0, 0.1, 0.2, 0.3, tdoaVector, xCorrAmps, peakTime, std::chrono::microseconds(1500));
 
     // Call flush (this should trigger writing)
     EXPECT_NO_THROW(outputManager.flushBufferIfNecessary());
@@ -29,7 +46,8 @@ TEST(OutputManagerTest, WriteErrorDataToCerr)
     OutputManager outputManager(std::chrono::seconds(10), false, "logs/");
 
     std::vector<TimePoint> errorTimestamps = {std::chrono::system_clock::now()};
-    std::vector<std::vector<uint8_t>> erroredDataBytes = {{0xAA, 0xBB, 0xCC}};
+    std::vector<uint8_t> erroredPacket = {0xAA, 0xBB, 0xCC};
+    std::vector<PacketView> erroredDataBytes = {PacketView(erroredPacket)};
 
     testing::internal::CaptureStderr();
     outputManager.writeDataToCerr(errorTimestamps, erroredDataBytes);
@@ -38,3 +56,93 @@ TEST(OutputManagerTest, WriteErrorDataToCerr)
     EXPECT_NE(output.find("Timestamps of data causing error"), std::string::npos);
     EXPECT_NE(output.find("Errored bytes of last packets"), std::string::npos);
 }
+
+// Test that rows flushed to the writer thread all reach the file, formatted as CSV, once the manager is destroyed
+TEST(OutputManagerTest, WriterThreadWritesFlushedRows)
+{
+    const std::string loggingPrefix = "temp_output_manager_";
+    const TimePoint fileTime = TimePoint(std::chrono::microseconds(1'700'000'000'000'000));
+    const std::string filePath = loggingPrefix + convertTimePointToString(fileTime);
+
+    Eigen::VectorXf tdoaVector(3);
+    tdoaVector << 1.0, 2.0, 3.0;
+    Eigen::VectorXf xCorrAmps(3);
+    xCorrAmps << 0.5, 0.6, 0.7;
+    {
+        OutputManager outputManager(std::chrono::seconds(10), true, loggingPrefix);
+        outputManager.initializeOutputFile(fileTime, 3);
+        for (int i = 0; i < 3; i++)
+        {
+            outputManager.appendToBuffer(
+                10.0, 0.1, 0.2, 0.3, tdoaVector, xCorrAmps, fileTime + std::chrono::microseconds(i),
+                std::chrono::microseconds(1500));
+            outputManager.flushBufferIfNecessary();
+        }
+    }
+
+    std::vector<std::string> lines = readLines(filePath);
+    std::remove(filePath.c_str());
+
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[0], "PeakTime,Amplitude,DOA_x,DOA_y,DOA_z,TDOA12,TDOA13,TDOA23,XCorr12,XCorr13,XCorr23,Latency_us");
+    EXPECT_EQ(
+        lines[1],
+        "1700000000000000,10.000000,0.100000,0.200000,0.300000,1.000000,2.000000,3.000000,0.500000,0.600000,0.700000,1500");
+    EXPECT_EQ(lines[3].substr(0, 17), "1700000000000002,");
+}
+
+// Test that the struct-of-arrays buffer keeps each field contiguous and reuses its rows once cleared
+TEST(OutputManagerTest, DetectionBufferStoresRowsContiguously)
+{
+    DetectionBuffer buffer;
+    buffer.allocate(2, 3);
+
+    Eigen::VectorXf tdoaVector(3);
+    tdoaVector << 1.0, 2.0, 3.0;
+    Eigen::VectorXf xCorrAmps(3);
+    xCorrAmps << 0.5, 0.6, 0.7;
+    TimePoint peakTime = std::chrono::system_clock::now();
+
+    buffer.append(10.0, 0.1, 0.2, 0.3, tdoaVector, xCorrAmps, peakTime, std::chrono::microseconds(1));
+    buffer.append(20.0, 0.4, 0.5, 0.6, tdoaVector * 2, xCorrAmps, peakTime, std::chrono::microseconds(2));
+
+    EXPECT_TRUE(buffer.isFull());
+    EXPECT_EQ(buffer.amplitudes()[1], 20.0f);
+    EXPECT_EQ(buffer.tdoas(1)[2], 6.0f);
+    EXPECT_EQ(buffer.tdoas(0).data() + 3, buffer.tdoas(1).data());
+    EXPECT_EQ(buffer.latencies()[1], std::chrono::microseconds(2));
+
+    Eigen::VectorXf wrongSize(2);
+    buffer.clear();
+    EXPECT_EQ(buffer.size(), 0u);
+    EXPECT_THROW(
+        buffer.append(1.0, 0, 0, 0, wrongSize, xCorrAmps, peakTime, std::chrono::microseconds(0)), std::runtime_error);
+}
+
+// Test that rows beyond the buffer capacity wait for the writer instead of being lost
+TEST(OutputManagerTest, AppendingToAFullBufferKeepsEveryRow)
+{
+    const std::string loggingPrefix = "temp_output_manager_full_";
+    const TimePoint fileTime = TimePoint(std::chrono::microseconds(1'700'000'000'000'000));
+    const std::string filePath = loggingPrefix + convertTimePointToString(fileTime);
+    const int numRows = 10'000;
+
+    Eigen::VectorXf tdoaVector = Eigen::VectorXf::Zero(3);
+    Eigen::VectorXf xCorrAmps = Eigen::VectorXf::Zero(3);
+    {
+        OutputManager outputManager(std::chrono::seconds(10), false, loggingPrefix);
+        outputManager.initializeOutputFile(fileTime, 3);
+        for (int i = 0; i < numRows; i++)
+        {
+            outputManager.appendToBuffer(
+                1.0, 0, 0, 0, tdoaVector, xCorrAmps, fileTime + std::chrono::microseconds(i),
+                std::chrono::microseconds(0));
+        }
+    }
+
+    std::vector<std::string> lines = readLines(filePath);
+    std::remove(filePath.c_str());
+
+    ASSERT_EQ(lines.size(), static_cast<size_t>(numRows + 1));
+    EXPECT_EQ(lines.back().substr(0, 17), "1700000000009999,");
+}
@@ -0,0 +1,103 @@
+#include "../../src/io/packet_capture.h"
+
+#include "gtest/gtest.h"
+
+class PacketCaptureTest : public ::testing::Test
+{
+   protected:
+    void TearDown() override { std::remove(mCaptureFile.c_str()); }
+
+    const std::string mCaptureFile = "temp_packet_capture.bin";
+};
+
+// Packets and their arrival times come back in order and byte for byte
+TEST_F(PacketCaptureTest, RoundTripPreservesPacketsAndArrivalTimes)
+{
+    const std::vector<uint8_t> first = {1, 2, 3};
+    const std::vector<uint8_t> second(1252, 0xAB);
+    const TimePoint firstTime = TimePoint(std::chrono::nanoseconds(1'700'000'000'123'456'789));
+    const TimePoint secondTime = firstTime + std::chrono::microseconds(1240);
+    {
+        PacketCaptureWriter writer(mCaptureFile);
+        writer.write(first, firstTime);
+        writer.write(second, secondTime);
+    }
+
+    PacketCaptureReader reader(mCaptureFile);
+    PacketView packet;
+    TimePoint arrivalTime;
+
+    ASSERT_TRUE(reader.next(packet, arrivalTime));
+    EXPECT_TRUE(std::equal(packet.begin(), packet.end(), first.begin(), first.end()));
+    EXPECT_EQ(arrivalTime, firstTime);
+
+    ASSERT_TRUE(reader.next(packet, arrivalTime));
+    EXPECT_TRUE(std::equal(packet.begin(), packet.end(), second.begin(), second.end()));
+    EXPECT_EQ(arrivalTime, secondTime);
+
+    EXPECT_FALSE(reader.next(packet, arrivalTime));
+
+    reader.rewind();
+    ASSERT_TRUE(reader.next(packet, arrivalTime));
+    EXPECT_EQ(packet.size(), first.size());
+}
+
+// The writer trims its preallocation, so the file ends after the last record
+TEST_F(PacketCaptureTest, ClosedCaptureIsTrimmed)
+{
+    size_t bytesWritten = 0;
+    {
+        PacketCaptureWriter writer(mCaptureFile);
+        writer.write(std::vector<uint8_t>(5, 1), std::chrono::system_clock::now());
+        bytesWritten = writer.bytesWritten();
+    }
+
+    struct stat fileStatus;
+    ASSERT_EQ(stat(mCaptureFile.c_str(), &fileStatus), 0);
+    EXPECT_EQ(static_cast<size_t>(fileStatus.st_size), bytesWritten);
+    EXPECT_EQ(bytesWritten % PacketCaptureFormat::recordAlignment, 0);
+}
+
+// A capture whose writer never shut down ends at the zero-filled preallocated tail
+TEST_F(PacketCaptureTest, ZeroFilledTailEndsCapture)
+{
+    {
+        PacketCaptureWriter writer(mCaptureFile);
+        writer.write(std::vector<uint8_t>(4, 7), std::chrono::system_clock::now());
+    }
+    ASSERT_EQ(truncate(mCaptureFile.c_str(), 4096), 0);
+
+    PacketCaptureReader reader(mCaptureFile);
+    PacketView packet;
+    TimePoint arrivalTime;
+    EXPECT_TRUE(reader.next(packet, arrivalTime));
+    EXPECT_FALSE(reader.next(packet, arrivalTime));
+}
+
+// A record cut short by the end of the file is reported
+TEST_F(PacketCaptureTest, TruncatedRecordThrows)
+{
+    size_t bytesWritten = 0;
+    {
+        PacketCaptureWriter writer(mCaptureFile);
+        writer.write(std::vector<uint8_t>(100, 7), std::chrono::system_clock::now());
+        bytesWritten = writer.bytesWritten();
+    }
+    ASSERT_EQ(truncate(mCaptureFile.c_str(), static_cast<off_t>(bytesWritten - 50)), 0);
+
+    PacketCaptureReader reader(mCaptureFile);
+    PacketView packet;
+    TimePoint arrivalTime;
+    EXPECT_THROW(reader.next(packet, arrivalTime), std::runtime_error);
+}
+
+// Files that are not captures are rejected up front
+TEST_F(PacketCaptureTest, RejectsFilesWithoutCaptureHeader)
+{
+    std::ofstream file(mCaptureFile);
+    file << "PeakTime,Amplitude,DOA_x,DOA_y,DOA_z\n";
+    file.close();
+
+    EXPECT_THROW(PacketCaptureReader reader(mCaptureFile), std::runtime_error);
+    EXPECT_THROW(PacketCaptureReader reader("non_existent_capture.bin"), std::runtime_error);
+}
@@ -0,0 +1,157 @@
+#include "../../src/io/replay_socket_manager.h"
+
+#include "../../src/io/capture_socket_manager.h"
+#include "../../src/socket_variables.h"
+#include "gtest/gtest.h"
+
+class ReplaySocketManagerTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        PacketCaptureWriter writer(mCaptureFile);
+        for (uint8_t i = 0; i < mNumPackets; i++)
+        {
+            writer.write(std::vector<uint8_t>(16, i), mFirstArrival + i * mInterval);
+        }
+        mSocketVars.socketBackend = "replay";
+        mSocketVars.replayFilePath = mCaptureFile;
+        mSocketVars.receiveBatchSize = 32;
+    }
+
+    void TearDown() override
+    {
+        std::remove(mCaptureFile.c_str());
+        std::remove(mRecaptureFile.c_str());
+    }
+
+    int replayBatch(ISocketManager& socketManager, int numBuffers)
+    {
+        mStorage.assign(numBuffers, std::vector<uint8_t>(64));
+        mBuffers.assign(mStorage.begin(), mStorage.end());
+        mLengths.assign(numBuffers, 0);
+        mArrivalTimes.assign(numBuffers, TimePoint());
+        return socketManager.receiveBatch(mBuffers, mLengths, mArrivalTimes, 0);
+    }
+
+    static constexpr int mNumPackets = 10;
+    const std::chrono::milliseconds mInterval{5};
+    const TimePoint mFirstArrival = TimePoint(std::chrono::seconds(1'700'000'000));
+    const std::string mCaptureFile = "temp_replay_capture.bin";
+    const std::string mRecaptureFile = "temp_replay_recapture.bin";
+    SocketVariables mSocketVars;
+
+    std::vector<std::vector<uint8_t>> mStorage;
+    std::vector<std::span<uint8_t>> mBuffers;
+    std::vector<size_t> mLengths;
+    std::vector<TimePoint> mArrivalTimes;
+};
+
+// Unpaced replay hands out every packet in order, then behaves like an idle socket
+TEST_F(ReplaySocketManagerTest, UnpacedReplayDeliversWholeCaptureInOrder)
+{
+    mSocketVars.replaySpeed = 0;
+    ReplaySocketManager socketManager(mSocketVars);
+    EXPECT_TRUE(socketManager.appliesBackpressure());
+    EXPECT_EQ(socketManager.getSocket(), -1);
+
+    ASSERT_EQ(replayBatch(socketManager, 4), 4);
+    EXPECT_EQ(mLengths[0], 16);
+    EXPECT_EQ(mStorage[0][0], 0);
+    EXPECT_EQ(mStorage[3][0], 3);
+
+    ASSERT_EQ(replayBatch(socketManager, 32), mNumPackets - 4);
+    EXPECT_EQ(mStorage[0][0], 4);
+
+    EXPECT_EQ(replayBatch(socketManager, 32), 0);
+    EXPECT_EQ(socketManager.packetsReplayed(), mNumPackets);
+}
+
+// Paced replay takes the recorded duration divided by the speed
+TEST_F(ReplaySocketManagerTest, PacedReplayFollowsRecordedTiming)
+{
+    mSocketVars.replaySpeed = 2.0;
+    ReplaySocketManager socketManager(mSocketVars);
+
+    const auto start = std::chrono::steady_clock::now();
+    int packetsReplayed = 0;
+    while (packetsReplayed < mNumPackets)
+    {
+        packetsReplayed += replayBatch(socketManager, 32);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // (mNumPackets - 1) intervals of 5 ms at double speed
+    EXPECT_GE(elapsed, std::chrono::microseconds(22'500));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+}
+
+// The single-packet path delivers one datagram per call
+TEST_F(ReplaySocketManagerTest, ReceiveDataDeliversOnePacket)
+{
+    mSocketVars.replaySpeed = 0;
+    ReplaySocketManager socketManager(mSocketVars);
+    socketManager.setReceiveBufferSize(2048);
+
+    EXPECT_EQ(socketManager.receiveData(0, nullptr, nullptr), 16);
+    EXPECT_EQ(socketManager.getReceivedData().size(), 16);
+    EXPECT_EQ(socketManager.receiveData(0, nullptr, nullptr), 16);
+    EXPECT_EQ(socketManager.getReceivedData()[0], 1);
+}
+
+// Capturing a replay reproduces the original payloads
+TEST_F(ReplaySocketManagerTest, CaptureOfReplayMatchesOriginal)
+{
+    mSocketVars.replaySpeed = 0;
+    {
+        CaptureSocketManager socketManager(std::make_unique<ReplaySocketManager>(mSocketVars), mRecaptureFile);
+        EXPECT_EQ(replayBatch(socketManager, 32), mNumPackets);
+    }
+
+    PacketCaptureReader original(mCaptureFile);
+    PacketCaptureReader recaptured(mRecaptureFile);
+    PacketView originalPacket, recapturedPacket;
+    TimePoint originalTime, recapturedTime;
+    int numPackets = 0;
+    while (original.next(originalPacket, originalTime))
+    {
+        ASSERT_TRUE(recaptured.next(recapturedPacket, recapturedTime));
+        EXPECT_TRUE(std::equal(
+            originalPacket.begin(), originalPacket.end(), recapturedPacket.begin(), recapturedPacket.end()));
+        numPackets++;
+    }
+    EXPECT_FALSE(recaptured.next(recapturedPacket, recapturedTime));
+    EXPECT_EQ(numPackets, mNumPackets);
+}
+
+// The single-packet path records each datagram with the arrival time its source reported, not the time it was read
+TEST_F(ReplaySocketManagerTest, CaptureOfSinglePacketsKeepsArrivalTimes)
+{
+    mSocketVars.replaySpeed = 0;
+    std::vector<TimePoint> arrivalTimes;
+    {
+        CaptureSocketManager socketManager(std::make_unique<ReplaySocketManager>(mSocketVars), mRecaptureFile);
+        socketManager.setReceiveBufferSize(2048);
+        for (int i = 0; i < 3; i++)
+        {
+            ASSERT_EQ(socketManager.receiveData(0, nullptr, nullptr), 16);
+            arrivalTimes.push_back(socketManager.lastArrivalTime());
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+
+    PacketCaptureReader recaptured(mRecaptureFile);
+    PacketView packet;
+    TimePoint recordedTime;
+    for (const TimePoint& arrivalTime : arrivalTimes)
+    {
+        ASSERT_TRUE(recaptured.next(packet, recordedTime));
+        EXPECT_EQ(recordedTime, arrivalTime);
+    }
+}
+
+TEST_F(ReplaySocketManagerTest, RejectsNegativeSpeed)
+{
+    mSocketVars.replaySpeed = -1;
+    EXPECT_THROW(ReplaySocketManager socketManager(mSocketVars), std::invalid_argument);
+}
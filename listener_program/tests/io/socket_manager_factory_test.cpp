@@ -0,0 +1,46 @@
+#include "../../src/io/socket_manager_factory.h"
+
+#include "gtest/gtest.h"
+
+TEST(SocketManagerFactoryTest, CreatesUdpBackendByDefault)
+{
+    SocketVariables socketVars;
+    socketVars.port = 8082;
+    socketVars.ipAddress = "127.0.0.1";
+
+    std::unique_ptr<ISocketManager> socketManager = SocketManagerFactory::create(socketVars);
+    EXPECT_NE(dynamic_cast<UdpSocketManager*>(socketManager.get()), nullptr);
+}
+
+TEST(SocketManagerFactoryTest, ThrowsOnUnknownBackend)
+{
+    SocketVariables socketVars;
+    socketVars.socketBackend = "carrier_pigeon";
+
+    EXPECT_THROW(SocketManagerFactory::create(socketVars), std::invalid_argument);
+}
+
+TEST(SocketManagerFactoryTest, ReplayBackendNeedsCaptureFile)
+{
+    SocketVariables socketVars;
+    socketVars.socketBackend = "replay";
+    socketVars.replayFilePath = "non_existent_capture.bin";
+
+    EXPECT_THROW(SocketManagerFactory::create(socketVars), std::runtime_error);
+}
+
+TEST(SocketManagerFactoryTest, CaptureFileWrapsBackend)
+{
+    const std::string captureFile = "temp_factory_capture.bin";
+    SocketVariables socketVars;
+    socketVars.port = 8082;
+    socketVars.ipAddress = "127.0.0.1";
+    socketVars.captureFilePath = captureFile;
+
+    std::unique_ptr<ISocketManager> socketManager = SocketManagerFactory::create(socketVars);
+    EXPECT_NE(dynamic_cast<CaptureSocketManager*>(socketManager.get()), nullptr);
+    EXPECT_FALSE(socketManager->appliesBackpressure());
+
+    socketManager.reset();
+    std::remove(captureFile.c_str());
+}
@@ -82,3 +82,159 @@ TEST(UdpSocketManagerTest, SetReceiveBufferSize)
     socketManager.setReceiveBufferSize(4096);
     EXPECT_EQ(socketManager.getReceivedData().size(), 4096);
 }
+
+TEST(UdpSocketManagerTest, ReceiveBatchReturnsAllQueuedDatagrams)
+{
+    SocketVariables socketVars;
+    socketVars.port = 8081;
+    socketVars.ipAddress = "127.0.0.1";
+    socketVars.receiveBatchSize = 8;
+
+    UdpSocketManager socketManager(socketVars);
+    socketManager.restartListener();
+
+    std::vector<std::vector<uint8_t>> storage(8, std::vector<uint8_t>(2048));
+    std::vector<std::span<uint8_t>> buffers(storage.begin(), storage.end());
+    std::vector<size_t> lengths(buffers.size());
+    std::vector<TimePoint> arrivalTimes(buffers.size());
+
+    TimePoint sendTime = std::chrono::system_clock::now();
+    int senderSocket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = inet_addr("127.0.0.1");
+    destination.sin_port = htons(8081);
+
+    for (uint8_t i = 1; i <= 3; i++)
+    {
+        std::vector<uint8_t> payload(i * 10, i);
+        ::sendto(senderSocket, payload.data(), payload.size(), 0, (struct sockaddr*)&destination, sizeof(destination));
+    }
+    ::close(senderSocket);
+
+    int packetsReceived = socketManager.receiveBatch(buffers, lengths, arrivalTimes, 0);
+    TimePoint receiveTime = std::chrono::system_clock::now();
+
+    ASSERT_EQ(packetsReceived, 3);
+    for (int i = 0; i < packetsReceived; i++)
+    {
+        EXPECT_EQ(lengths[i], (i + 1) * 10);
+        EXPECT_EQ(storage[i][0], i + 1);
+        // Kernel timestamps are taken between sending and reading the datagram
+        EXPECT_GE(arrivalTimes[i], sendTime - std::chrono::milliseconds(1));
+        EXPECT_LE(arrivalTimes[i], receiveTime);
+    }
+}
+
+TEST(UdpSocketManagerTest, ReceiveBatchReturnsNegativeOnFailure)
+{
+    SocketVariables socketVars;
+    socketVars.port = 8080;
+    socketVars.ipAddress = "127.0.0.1";
+
+    UdpSocketManager socketManager(socketVars);
+
+    std::vector<uint8_t> storage(2048);
+    std::vector<std::span<uint8_t>> buffers = {std::span<uint8_t>(storage)};
+    std::vector<size_t> lengths(1);
+    std::vector<TimePoint> arrivalTimes(1);
+
+    ::close(socketManager.getSocket());
+
+    EXPECT_EQ(socketManager.receiveBatch(buffers, lengths, arrivalTimes, 0), -1);
+}
+
+TEST(UdpSocketManagerTest, ReceiveReturnsZeroWhenNothingArrives)
+{
+    SocketVariables socketVars;
+    socketVars.port = 8082;
+    socketVars.ipAddress = "127.0.0.1";
+    socketVars.receiveBatchSize = 4;
+
+    UdpSocketManager socketManager(socketVars);
+    socketManager.setReceiveBufferSize(2048);
+
+    std::vector<uint8_t> storage(2048);
+    std::vector<std::span<uint8_t>> buffers = {std::span<uint8_t>(storage)};
+    std::vector<size_t> lengths(1);
+    std::vector<TimePoint> arrivalTimes(1);
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+
+    // A quiet stream must not block the listener forever, or it would never see a program stop
+    EXPECT_EQ(socketManager.receiveData(0, (struct sockaddr*)&addr, &addrLen), 0);
+    EXPECT_EQ(socketManager.receiveBatch(buffers, lengths, arrivalTimes, 0), 0);
+}
+
+TEST(UdpSocketManagerTest, ReportsDatagramsDroppedByKernel)
+{
+    SocketVariables socketVars;
+    socketVars.port = 8083;
+    socketVars.ipAddress = "127.0.0.1";
+    socketVars.receiveBatchSize = 8;
+
+    UdpSocketManager socketManager(socketVars);
+    socketManager.restartListener();
+    EXPECT_EQ(socketManager.kernelDrops(), 0u);
+
+    // A tiny receive buffer overflows while nobody reads, as when the listener waits for a free slot
+    int bufferSize = 1;
+    ::setsockopt(socketManager.getSocket(), SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    int senderSocket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = inet_addr("127.0.0.1");
+    destination.sin_port = htons(8083);
+    std::vector<uint8_t> payload(1000, 1);
+    for (int i = 0; i < 100; i++)
+    {
+        ::sendto(senderSocket, payload.data(), payload.size(), 0, (struct sockaddr*)&destination, sizeof(destination));
+    }
+    // The drop count arrives with the datagram queued after the overflow
+    bufferSize = 1 << 20;
+    ::setsockopt(socketManager.getSocket(), SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    ::sendto(senderSocket, payload.data(), payload.size(), 0, (struct sockaddr*)&destination, sizeof(destination));
+    ::close(senderSocket);
+
+    std::vector<std::vector<uint8_t>> storage(8, std::vector<uint8_t>(2048));
+    std::vector<std::span<uint8_t>> buffers(storage.begin(), storage.end());
+    std::vector<size_t> lengths(buffers.size());
+    std::vector<TimePoint> arrivalTimes(buffers.size());
+    while (socketManager.receiveBatch(buffers, lengths, arrivalTimes, 0) > 0)
+    {
+    }
+
+    EXPECT_GT(socketManager.kernelDrops(), 0u);
+    EXPECT_LT(socketManager.kernelDrops(), 101u);
+}
+
+TEST(UdpSocketManagerTest, ReceiveDataKeepsKernelArrivalTime)
+{
+    SocketVariables socketVars;
+    socketVars.port = 8084;
+    socketVars.ipAddress = "127.0.0.1";
+
+    UdpSocketManager socketManager(socketVars);
+    socketManager.restartListener();
+    socketManager.setReceiveBufferSize(2048);
+
+    TimePoint sendTime = std::chrono::system_clock::now();
+    int senderSocket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = inet_addr("127.0.0.1");
+    destination.sin_port = htons(8084);
+    std::vector<uint8_t> payload(10, 1);
+    ::sendto(senderSocket, payload.data(), payload.size(), 0, (struct sockaddr*)&destination, sizeof(destination));
+    ::close(senderSocket);
+
+    // Read late, so a read-time stamp would be clearly later than the kernel's
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+    ASSERT_EQ(socketManager.receiveData(0, (struct sockaddr*)&addr, &addrLen), 10);
+
+    EXPECT_GE(socketManager.lastArrivalTime(), sendTime - std::chrono::milliseconds(1));
+    EXPECT_LT(socketManager.lastArrivalTime(), sendTime + std::chrono::milliseconds(40));
+}
@@ -0,0 +1,59 @@
+#include "../src/latency_histogram.h"
+
+#include <gtest/gtest.h>
+
+// Test that an empty histogram reports zeros
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.percentile(0.5), std::chrono::microseconds(0));
+    EXPECT_EQ(histogram.max(), std::chrono::microseconds(0));
+}
+
+// Test that percentiles fall within the bucket resolution of the true values
+TEST(LatencyHistogramTest, PercentilesAreWithinBucketResolution)
+{
+    LatencyHistogram histogram;
+    for (int latencyUs = 1; latencyUs <= 1000; latencyUs++)
+    {
+        histogram.record(std::chrono::microseconds(latencyUs));
+    }
+
+    EXPECT_EQ(histogram.count(), 1000);
+    EXPECT_EQ(histogram.max(), std::chrono::microseconds(1000));
+    EXPECT_EQ(histogram.mean(), std::chrono::microseconds(500));
+
+    auto p50 = histogram.percentile(0.5).count();
+    EXPECT_GE(p50, 500);
+    EXPECT_LE(p50, 500 * 1.2);
+
+    auto p99 = histogram.percentile(0.99).count();
+    EXPECT_GE(p99, 990);
+    EXPECT_LE(p99, 1000);  // capped at the exact maximum
+}
+
+// Test that negative latencies are clamped and reset clears all samples
+TEST(LatencyHistogramTest, NegativeLatencyIsClampedAndResetClears)
+{
+    LatencyHistogram histogram;
+    histogram.record(std::chrono::microseconds(-50));
+    EXPECT_EQ(histogram.count(), 1);
+    EXPECT_EQ(histogram.percentile(1.0), std::chrono::microseconds(0));
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.max(), std::chrono::microseconds(0));
+}
+
+// Test that summaries are in microseconds, with a decimal only for histograms finer than that
+TEST(LatencyHistogramTest, SummaryIsInMicroseconds)
+{
+    LatencyHistogram latencies;
+    latencies.record(std::chrono::microseconds(1500));
+    EXPECT_EQ(latencies.summary(), "n: 1 mean: 1500 us p50: 1500 us p99: 1500 us max: 1500 us");
+
+    LogBucketHistogram<std::chrono::nanoseconds> durations;
+    durations.record(std::chrono::nanoseconds(1500));
+    EXPECT_EQ(durations.summary(), "n: 1 mean: 1.5 us p50: 1.5 us p99: 1.5 us max: 1.5 us");
+}
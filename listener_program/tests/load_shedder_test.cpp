@@ -0,0 +1,71 @@
+#include "../src/load_shedder.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+LoadShedder makeShedder() { return LoadShedder({100, 200, 300, 400}, {50, 150, 250, 350}, 2.0f); }
+}  // namespace
+
+// Test that the tier follows the queue depth upwards, skipping tiers when the depth jumps
+TEST(LoadShedderTest, EscalatesWithQueueDepth)
+{
+    LoadShedder shedder = makeShedder();
+    EXPECT_EQ(shedder.update(99), OverloadTier::Normal);
+    EXPECT_EQ(shedder.update(100), OverloadTier::SkipClassifier);
+    EXPECT_EQ(shedder.update(350), OverloadTier::RaiseThresholds);
+    EXPECT_EQ(shedder.update(1000), OverloadTier::DropWindows);
+    EXPECT_TRUE(shedder.atLeast(OverloadTier::SkipTracker));
+}
+
+// Test that a tier is only left once the depth falls below its exit depth
+TEST(LoadShedderTest, HysteresisPreventsFlapping)
+{
+    LoadShedder shedder = makeShedder();
+    shedder.update(200);
+    ASSERT_EQ(shedder.tier(), OverloadTier::SkipTracker);
+
+    EXPECT_EQ(shedder.update(199), OverloadTier::SkipTracker);
+    EXPECT_EQ(shedder.update(150), OverloadTier::SkipTracker);
+    EXPECT_EQ(shedder.update(149), OverloadTier::SkipClassifier);
+    EXPECT_EQ(shedder.update(120), OverloadTier::SkipClassifier);
+    EXPECT_EQ(shedder.update(0), OverloadTier::Normal);
+}
+
+// Test that the threshold scale only applies from the raise-thresholds tier on
+TEST(LoadShedderTest, ThresholdScaleAppliesFromRaiseThresholdsTier)
+{
+    LoadShedder shedder = makeShedder();
+    shedder.update(250);
+    EXPECT_FLOAT_EQ(shedder.thresholdScale(), 1.0f);
+    shedder.update(300);
+    EXPECT_FLOAT_EQ(shedder.thresholdScale(), 2.0f);
+}
+
+// Test that shed decisions are counted per action and survive a reset of the tier
+TEST(LoadShedderTest, CountsShedDecisions)
+{
+    LoadShedder shedder = makeShedder();
+    shedder.update(500);
+    shedder.recordShed(ShedAction::WindowDropped);
+    shedder.recordShed(ShedAction::WindowDropped);
+    shedder.recordShed(ShedAction::ClassifierSkipped);
+    shedder.recordShed(ShedAction::PacketDroppedByKernel, 7);
+    shedder.reset();
+
+    EXPECT_EQ(shedder.tier(), OverloadTier::Normal);
+    EXPECT_EQ(shedder.shedCount(ShedAction::WindowDropped), 2);
+    EXPECT_EQ(shedder.shedCount(ShedAction::TrackerUpdateSkipped), 0);
+    EXPECT_EQ(shedder.totalShed(), 10);
+    EXPECT_NE(shedder.summary().find("windows dropped: 2"), std::string::npos);
+    EXPECT_NE(shedder.summary().find("packets dropped by kernel: 7"), std::string::npos);
+}
+
+// Test that depth bands that would not give hysteresis are rejected
+TEST(LoadShedderTest, RejectsInvalidDepths)
+{
+    EXPECT_THROW(LoadShedder({100, 200, 300}, {50, 150, 250}, 2.0f), std::invalid_argument);
+    EXPECT_THROW(LoadShedder({100, 200, 300, 400}, {100, 150, 250, 350}, 2.0f), std::invalid_argument);
+    EXPECT_THROW(LoadShedder({100, 300, 200, 400}, {50, 150, 150, 350}, 2.0f), std::invalid_argument);
+    EXPECT_THROW(LoadShedder({100, 200, 300, 400}, {50, 150, 250, 350}, 0.5f), std::invalid_argument);
+}
@@ -0,0 +1,119 @@
+#include "../src/logger.h"
+
+#include "gtest/gtest.h"
+
+// Lines carry the level and component, and warnings and errors go to the error stream
+TEST(LoggerTest, FormatsLinesAndSplitsStreamsByLevel)
+{
+    std::ostringstream output;
+    std::ostringstream errorOutput;
+    {
+        Logger logger(output, errorOutput, 8);
+        logger.log(LogLevel::Info, "pipeline", "Detection latency n: 3");
+        logger.log(LogLevel::Debug, "tracker", "Cluster size: 12", 4);
+        logger.log(LogLevel::Error, "listener", "socket closed");
+        logger.flush();
+    }
+
+    const std::string text = output.str();
+    EXPECT_NE(text.find(" INFO [pipeline] Detection latency n: 3\n"), std::string::npos);
+    EXPECT_NE(text.find(" DEBUG [tracker] Cluster size: 12 (4 similar messages suppressed)\n"), std::string::npos);
+    EXPECT_LT(text.find("Detection latency"), text.find("Cluster size"));
+    EXPECT_EQ(text.find("socket closed"), std::string::npos);
+    EXPECT_NE(errorOutput.str().find(" ERROR [listener] socket closed\n"), std::string::npos);
+    EXPECT_EQ(text[4], '-');  // "YYYY-MM-DD HH:MM:SS.mmmmmm"
+}
+
+// Messages below the configured level are filtered before anything is formatted
+TEST(LoggerTest, FiltersByLevel)
+{
+    std::ostringstream output;
+    Logger logger(output, output);
+    EXPECT_FALSE(logger.isEnabled(LogLevel::Debug));
+    EXPECT_TRUE(logger.isEnabled(LogLevel::Info));
+
+    logger.configure(LogLevel::Warning, 0);
+    EXPECT_FALSE(logger.isEnabled(LogLevel::Info));
+    EXPECT_TRUE(logger.isEnabled(LogLevel::Error));
+    EXPECT_EQ(logger.rateLimit(), 0u);
+
+    logger.configure(LogLevel::Off, 10);
+    EXPECT_FALSE(logger.isEnabled(LogLevel::Error));
+
+    EXPECT_EQ(Logger::parseLevel("debug"), LogLevel::Debug);
+    EXPECT_THROW(Logger::parseLevel("verbose"), std::invalid_argument);
+}
+
+// A call site gets its quota per second and counts what it refuses
+TEST(LoggerTest, RateLimiterCountsSuppressedMessages)
+{
+    LogRateLimiter limiter;
+    int allowed = 0;
+    for (int i = 0; i < 25; i++)
+    {
+        allowed += limiter.allow(10) ? 1 : 0;
+    }
+    // The loop may straddle a second boundary, which grants a fresh quota
+    EXPECT_GE(allowed, 10);
+    EXPECT_LE(allowed, 20);
+    EXPECT_EQ(limiter.takeSuppressed(), static_cast<uint64_t>(25 - allowed));
+    EXPECT_EQ(limiter.takeSuppressed(), 0u);
+
+    LogRateLimiter unlimited;
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_TRUE(unlimited.allow(0));
+    }
+}
+
+// Long messages are truncated, and producers that outrun the writer drop and count rather than block
+TEST(LoggerTest, TruncatesAndDropsInsteadOfBlocking)
+{
+    std::ostringstream output;
+    std::ostringstream errorOutput;
+    Logger logger(output, errorOutput, 4);
+    logger.log(LogLevel::Info, "test", std::string(1000, 'x'));
+    logger.flush();
+    EXPECT_NE(output.str().find("xxx...\n"), std::string::npos);
+    EXPECT_EQ(output.str().find(std::string(449, 'x')), std::string::npos);
+
+    constexpr int numThreads = 4;
+    constexpr int messagesPerThread = 2000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < numThreads; t++)
+    {
+        producers.emplace_back(
+            [&logger, t]()
+            {
+                for (int i = 0; i < messagesPerThread; i++)
+                {
+                    logger.log(LogLevel::Info, "test", "thread " + std::to_string(t) + " message " + std::to_string(i));
+                }
+            });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    logger.flush();
+
+    const std::string text = output.str();
+    const auto printed = static_cast<uint64_t>(std::count(text.begin(), text.end(), '\n')) - 1;
+    EXPECT_EQ(printed + logger.dropped(), static_cast<uint64_t>(numThreads * messagesPerThread));
+}
+
+// Shutdown prints everything queued before stopping the writer, and later messages are ignored rather than lost
+// in a queue nothing reads
+TEST(LoggerTest, ShutdownPrintsQueuedMessagesAndIgnoresLaterOnes)
+{
+    std::ostringstream output;
+    Logger logger(output, output, 8);
+    logger.log(LogLevel::Info, "main", "before shutdown");
+    logger.shutdown();
+    EXPECT_NE(output.str().find("before shutdown"), std::string::npos);
+
+    logger.log(LogLevel::Info, "main", "after shutdown");
+    logger.flush();
+    logger.shutdown();
+    EXPECT_EQ(output.str().find("after shutdown"), std::string::npos);
+}
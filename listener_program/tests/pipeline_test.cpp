@@ -0,0 +1,67 @@
+#include "../src/pipeline.h"
+
+#include "../src/firmware/packet_generator_1240.h"
+#include "../src/pipeline_variables.h"
+#include "gtest/gtest.h"
+
+class PipelineTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        std::filesystem::create_directory(mLogDirectory);
+        std::ofstream positions(mPositionsFile);
+        positions << "0,0,0\n1,0,0\n0,1,0\n0,0,1\n";
+
+        mPipelineVariables.firmware = "1240";
+        mPipelineVariables.speedOfSound = 1500.0f;
+        mPipelineVariables.loggingDirectory = mLogDirectory;
+        mPipelineVariables.timeDomainDetector = "None";
+        mPipelineVariables.frequencyDomainStrategy = "None";
+        mPipelineVariables.frequencyDomainDetector = "None";
+        mPipelineVariables.receiverPositionsPath = mPositionsFile;
+        mPipelineVariables.clusterFrequencyInSeconds = std::chrono::seconds(60);
+        mPipelineVariables.clusterWindowInSeconds = std::chrono::seconds(60);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(mLogDirectory);
+        std::filesystem::remove(mPositionsFile);
+    }
+
+    const std::string mLogDirectory = "temp_pipeline_logs/";
+    const std::string mPositionsFile = "temp_pipeline_positions.txt";
+    PipelineVariables mPipelineVariables;
+    SharedPipelineResources mSharedResources;
+};
+
+// A packet lost while shedding load becomes a gap in the stream instead of an error, even without enableStreamResync
+TEST_F(PipelineTest, LoadSheddingBridgesDroppedPacket)
+{
+    mPipelineVariables.enableLoadShedding = true;
+    mPipelineVariables.enableStreamResync = false;
+
+    PacketGeneratorConfig generatorConfig;
+    generatorConfig.clicksPerSecond = 0.0;
+    generatorConfig.dropEvery = 50;
+    PacketGenerator1240 generator(generatorConfig);
+    SharedDataManager sharedDataManager;
+    std::vector<uint8_t> packet;
+    for (int i = 0; i < 80; i++)  // ten windows of 8 packets, with the 50th lost in transit
+    {
+        if (generator.next(packet) != PacketGenerator1240::PacketFate::Drop)
+        {
+            sharedDataManager.pushDataToBuffer(packet);
+        }
+    }
+    sharedDataManager.finishStream();
+
+    OutputManager outputManager(std::chrono::seconds(60), false, mLogDirectory);
+    Pipeline pipeline(outputManager, sharedDataManager, mPipelineVariables, mSharedResources);
+    pipeline.process();  // returns once the finished stream runs out of whole windows
+
+    EXPECT_FALSE(sharedDataManager.errorOccurred);
+    EXPECT_EQ(sharedDataManager.packetsLost, 1);
+    EXPECT_LT(sharedDataManager.queueSize(), 8);
+}
@@ -0,0 +1,55 @@
+#include "../src/reorder_buffer.h"
+
+#include <gtest/gtest.h>
+
+// Test that values inserted out of order come out in sequence order, each only once its predecessors have
+TEST(ReorderBufferTest, ReleasesInSequenceOrder)
+{
+    ReorderBuffer<int> buffer(4);
+    int value = -1;
+
+    buffer.insert(2, 20);
+    buffer.insert(1, 10);
+    EXPECT_FALSE(buffer.popNext(value));
+    EXPECT_EQ(buffer.size(), 2u);
+
+    buffer.insert(0, 0);
+    for (int expected : {0, 10, 20})
+    {
+        ASSERT_TRUE(buffer.popNext(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(buffer.popNext(value));
+    EXPECT_EQ(buffer.nextSequence(), 3u);
+}
+
+// Test that slots are reused as the window moves on, for more values than the capacity
+TEST(ReorderBufferTest, WrapsAroundItsSlots)
+{
+    ReorderBuffer<std::unique_ptr<int>> buffer(2);
+    std::unique_ptr<int> value;
+    for (int i = 0; i < 10; i += 2)
+    {
+        buffer.insert(i + 1, std::make_unique<int>(i + 1));
+        buffer.insert(i, std::make_unique<int>(i));
+        for (int expected : {i, i + 1})
+        {
+            ASSERT_TRUE(buffer.popNext(value));
+            EXPECT_EQ(*value, expected);
+        }
+    }
+}
+
+// Test that sequence numbers already released, too far ahead, or duplicated are rejected
+TEST(ReorderBufferTest, RejectsSequenceNumbersOutsideTheWindow)
+{
+    ReorderBuffer<int> buffer(2);
+    int value = -1;
+    buffer.insert(0, 0);
+    ASSERT_TRUE(buffer.popNext(value));
+
+    EXPECT_THROW(buffer.insert(0, 0), std::out_of_range);
+    EXPECT_THROW(buffer.insert(3, 3), std::out_of_range);
+    buffer.insert(2, 2);
+    EXPECT_THROW(buffer.insert(2, 2), std::logic_error);
+}
@@ -13,46 +13,71 @@ TEST(SharedDataManagerTest, PushDataIncreasesBufferSize)
     EXPECT_EQ(bufferSize, 1);
 }
 
-// Test waiting for data in a separate thread
-TEST(SharedDataManagerTest, WaitForDataRetrievesPackets)
+// Test receiving directly into ring slots and committing them
+TEST(SharedDataManagerTest, CommittedSlotsAreReadableInPlace)
 {
-    SharedDataManager manager;
+    SharedDataManager manager(16, 4);
+    std::vector<std::span<uint8_t>> slots(3);
 
-    int sizeInfo = manager.pushDataToBuffer({100, 101, 102});
+    int numSlots = manager.acquireWriteSlots(slots);
+    ASSERT_EQ(numSlots, 3);
+    EXPECT_EQ(slots[0].size(), 16);
 
-    // Try retrieving data
-    std::vector<std::vector<uint8_t>> retrievedData;
-    retrievedData.resize(1);
+    slots[0][0] = 1;
+    slots[0][1] = 2;
+    slots[1][0] = 3;
+    std::vector<size_t> lengths = {2, 1};
 
-    manager.waitForData(retrievedData, 1);  // Blocks until at least 1 packet is available
+    int bufferSize = manager.commitWriteSlots(lengths);
+    EXPECT_EQ(bufferSize, 2);
 
-    // Ensure the retrieved data is correct
-    EXPECT_EQ(retrievedData.size(), 1);
-    EXPECT_EQ(retrievedData[0], (std::vector<uint8_t>{100, 101, 102}));
+    std::vector<PacketView> retrievedData(2);
+    manager.waitForData(retrievedData, 2);
+    EXPECT_EQ(retrievedData[0].data(), slots[0].data());  // no copy was made
+    EXPECT_EQ(std::vector<uint8_t>(retrievedData[0].begin(), retrievedData[0].end()), (std::vector<uint8_t>{1, 2}));
+    EXPECT_EQ(std::vector<uint8_t>(retrievedData[1].begin(), retrievedData[1].end()), (std::vector<uint8_t>{3}));
 }
 
-// Test that `waitForData` blocks until data is available
-TEST(SharedDataManagerTest, WaitForDataBlocksAndRetrievesData)
+// Test that arrival times travel with their packets through the ring
+TEST(SharedDataManagerTest, ArrivalTimesFollowPackets)
 {
-    SharedDataManager manager;
-    std::vector<std::vector<uint8_t>> retrievedData;
-    retrievedData.resize(1);
+    SharedDataManager manager(16, 4);
+    TimePoint firstArrival = TimePoint(std::chrono::seconds(100));
+    TimePoint secondArrival = TimePoint(std::chrono::seconds(200));
 
-    // Start a thread that pushes data after a delay
-    std::thread producer(
-        [&manager]()
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            manager.pushDataToBuffer({200, 201, 202});
-        });
+    std::vector<std::span<uint8_t>> slots(2);
+    ASSERT_EQ(manager.acquireWriteSlots(slots), 2);
+    std::vector<size_t> lengths = {1, 1};
+    std::vector<TimePoint> arrivalTimes = {firstArrival, secondArrival};
+    manager.commitWriteSlots(lengths, arrivalTimes);
 
-    std::thread consumer([&manager, &retrievedData]() { manager.waitForData(retrievedData, 1); });
+    EXPECT_EQ(manager.arrivalTime(0), firstArrival);
+    EXPECT_EQ(manager.arrivalTime(1), secondArrival);
 
-    producer.join();
-    consumer.join();
+    manager.releaseData(1);
+    EXPECT_EQ(manager.arrivalTime(0), secondArrival);
+}
 
-    ASSERT_EQ(retrievedData.size(), 1);
-    EXPECT_EQ(retrievedData[0], (std::vector<uint8_t>{200, 201, 202}));
+// Test that slots only become free again once released by the consumer
+TEST(SharedDataManagerTest, RingReusesSlotsOnlyAfterRelease)
+{
+    SharedDataManager manager(8, 2);
+    manager.pushDataToBuffer({1});
+    manager.pushDataToBuffer({2});
+
+    std::vector<std::span<uint8_t>> slots(2);
+    EXPECT_EQ(manager.acquireWriteSlots(slots), 0);
+    EXPECT_THROW(manager.pushDataToBuffer({3}), std::runtime_error);
+
+    std::vector<PacketView> retrievedData(1);
+    manager.waitForData(retrievedData, 1);
+    manager.releaseData(1);
+
+    EXPECT_EQ(manager.acquireWriteSlots(slots), 1);
+    EXPECT_EQ(manager.pushDataToBuffer({3}), 2);
+
+    manager.waitForData(retrievedData, 1);
+    EXPECT_EQ(retrievedData[0][0], 2);
 }
 
 /*
@@ -84,6 +109,189 @@ TEST(SharedDataManagerTest, PushAndPopMaintainsFIFOOrder)
 }
 */
 
+// Test that a concurrent producer and consumer see every packet exactly once and in order
+TEST(SharedDataManagerTest, ConcurrentProducerConsumerPreservesOrder)
+{
+    constexpr int numPackets = 20000;
+    constexpr int windowSize = 8;
+    SharedDataManager manager(sizeof(int), 64);
+
+    std::thread producer(
+        [&manager]()
+        {
+            std::vector<std::span<uint8_t>> slots(16);
+            std::vector<size_t> lengths(16, sizeof(int));
+            int nextValue = 0;
+            while (nextValue < numPackets)
+            {
+                int numSlots = std::min(manager.acquireWriteSlots(slots), numPackets - nextValue);
+                for (int i = 0; i < numSlots; i++, nextValue++)
+                {
+                    std::memcpy(slots[i].data(), &nextValue, sizeof(int));
+                }
+                manager.commitWriteSlots(std::span(lengths).first(numSlots));
+            }
+        });
+
+    std::vector<PacketView> window(windowSize);
+    int expectedValue = 0;
+    while (expectedValue < numPackets)
+    {
+        if (!manager.peekData(window, windowSize))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        for (const PacketView& packet : window)
+        {
+            int value;
+            std::memcpy(&value, packet.data(), sizeof(int));
+            ASSERT_EQ(value, expectedValue++);
+        }
+        manager.releaseData(windowSize);
+    }
+    producer.join();
+
+    EXPECT_EQ(manager.queueSize(), 0);
+}
+
+// Test that a blocked consumer is woken by the commit that completes its window, not by a timeout
+TEST(SharedDataManagerTest, WaitForDataWakesWhenWindowCompletes)
+{
+    SharedDataManager manager;
+    std::vector<PacketView> retrievedData(3);
+
+    std::thread producer(
+        [&manager]()
+        {
+            for (uint8_t i = 0; i < 3; i++)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                manager.pushDataToBuffer({i});
+            }
+        });
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(manager.waitForData(retrievedData, 3, std::chrono::seconds(10)));
+    auto waited = std::chrono::steady_clock::now() - start;
+    producer.join();
+
+    EXPECT_LT(waited, std::chrono::seconds(5));
+    EXPECT_EQ(retrievedData[2][0], 2);
+
+    SharedDataManager::DequeueLatency latency = manager.takeDequeueLatency();
+    EXPECT_EQ(latency.numWindows, 1);
+    EXPECT_LE(latency.average, latency.max);
+    EXPECT_EQ(manager.takeDequeueLatency().numWindows, 0);
+}
+
+// Test that a waiting consumer gives up once an error is flagged
+TEST(SharedDataManagerTest, WaitForDataReturnsFalseOnError)
+{
+    SharedDataManager manager;
+    std::vector<PacketView> retrievedData(1);
+
+    std::thread errorThread(
+        [&manager]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            manager.errorOccurred = true;
+        });
+
+    EXPECT_FALSE(manager.waitForData(retrievedData, 1, std::chrono::milliseconds(5)));
+    errorThread.join();
+}
+
+// Test that a finished stream hands over its last complete window, then ends the wait instead of blocking
+TEST(SharedDataManagerTest, WaitForDataReturnsFalseOnceStreamFinishes)
+{
+    SharedDataManager manager;
+    std::vector<PacketView> retrievedData(2);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        manager.pushDataToBuffer({i});
+    }
+
+    std::thread finisher(
+        [&manager]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            manager.finishStream();
+        });
+
+    ASSERT_TRUE(manager.waitForData(retrievedData, 2, std::chrono::seconds(10)));
+    manager.releaseData(2);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(manager.waitForData(retrievedData, 2, std::chrono::seconds(10)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    finisher.join();
+}
+
+// Test that reset empties the ring and clears the error flag but keeps cumulative counters
+// A producer facing a full ring sleeps until the consumer releases a slot instead of spinning
+TEST(SharedDataManagerTest, WaitForFreeSlotWakesWhenConsumerReleases)
+{
+    SharedDataManager manager(16, 2);
+    manager.pushDataToBuffer({1});
+    manager.pushDataToBuffer({2});
+
+    std::thread consumer(
+        [&manager]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            manager.releaseData(1);
+        });
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(manager.waitForFreeSlot(std::chrono::seconds(10)));
+    auto waited = std::chrono::steady_clock::now() - start;
+    consumer.join();
+
+    EXPECT_LT(waited, std::chrono::seconds(5));
+    EXPECT_NO_THROW(manager.pushDataToBuffer({3}));
+}
+
+TEST(SharedDataManagerTest, WaitForFreeSlotReturnsFalseOnError)
+{
+    SharedDataManager manager(16, 1);
+    manager.pushDataToBuffer({1});
+
+    std::thread errorThread(
+        [&manager]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            manager.errorOccurred = true;
+        });
+
+    EXPECT_FALSE(manager.waitForFreeSlot(std::chrono::milliseconds(5)));
+    errorThread.join();
+}
+
+TEST(SharedDataManagerTest, ResetEmptiesRingForRestartedStream)
+{
+    SharedDataManager manager(16, 4);
+    manager.pushDataToBuffer({1, 2, 3});
+    manager.pushDataToBuffer({4, 5, 6});
+    manager.detectionCounter = 3;
+    manager.errorOccurred = true;
+
+    manager.reset();
+
+    EXPECT_EQ(manager.queueSize(), 0);
+    EXPECT_FALSE(manager.errorOccurred);
+    EXPECT_EQ(manager.detectionCounter, 3);
+
+    // The full capacity is available again and new packets are read from the start
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        manager.pushDataToBuffer({i});
+    }
+    std::vector<PacketView> retrievedData(4);
+    ASSERT_TRUE(manager.peekData(retrievedData, 4));
+    EXPECT_EQ(retrievedData[0][0], 0);
+    EXPECT_EQ(retrievedData[3][0], 3);
+}
+
 // Test atomic flag `errorOccurred`
 TEST(SharedDataManagerTest, ErrorOccurredFlagWorks)
 {
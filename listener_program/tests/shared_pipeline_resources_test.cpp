@@ -0,0 +1,58 @@
+#include "../src/shared_pipeline_resources.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+class SharedPipelineResourcesTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        std::ofstream file(mFilterFile);
+        file << "0.25,0.5,0.25\n";
+        mPipelineVariables.frequencyDomainStrategy = "Filter";
+        mPipelineVariables.filterWeightsPath = mFilterFile;
+    }
+
+    void TearDown() override { std::remove(mFilterFile.c_str()); }
+
+    const std::string mFilterFile = "temp_shared_filter.txt";
+    PipelineVariables mPipelineVariables;
+    SharedPipelineResources mResources;
+};
+
+// Pipelines with the same filter and channel length receive the same spectrum
+TEST_F(SharedPipelineResourcesTest, FilterSpectrumIsSharedPerChannelSize)
+{
+    auto first = mResources.filterSpectrum(mPipelineVariables, 992);
+    auto second = mResources.filterSpectrum(mPipelineVariables, 992);
+    auto otherLength = mResources.filterSpectrum(mPipelineVariables, 500);
+
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, otherLength);
+    EXPECT_EQ(first->paddedLength, 992 + 3 - 1);
+    EXPECT_EQ(first->frequencyResponse.size(), first->paddedLength / 2 + 1);
+    EXPECT_EQ(otherLength->paddedLength, 500 + 3 - 1);
+}
+
+// Only the "Filter" strategy needs a spectrum
+TEST_F(SharedPipelineResourcesTest, NoFilterSpectrumWithoutFilterStrategy)
+{
+    mPipelineVariables.frequencyDomainStrategy = "None";
+    EXPECT_EQ(mResources.filterSpectrum(mPipelineVariables, 992), nullptr);
+}
+
+// Missing filter files are reported rather than cached
+TEST_F(SharedPipelineResourcesTest, MissingFilterFileThrows)
+{
+    mPipelineVariables.filterWeightsPath = "non_existent_filter.txt";
+    EXPECT_THROW(mResources.filterSpectrum(mPipelineVariables, 992), std::runtime_error);
+}
+
+// No model is loaded when none is configured
+TEST_F(SharedPipelineResourcesTest, NoOnnxModelWithoutModelPath)
+{
+    EXPECT_EQ(mResources.onnxModel(mPipelineVariables), nullptr);
+}
@@ -0,0 +1,122 @@
+#include "../src/spsc_queue.h"
+
+#include <gtest/gtest.h>
+
+// Test that values come out in the order they went in and that a full queue refuses more
+TEST(SpscQueueTest, BoundedFifo)
+{
+    SpscQueue<int> queue(3);
+    for (int i = 0; i < 3; i++)
+    {
+        int value = i;
+        ASSERT_TRUE(queue.tryPush(value));
+    }
+    int extra = 3;
+    EXPECT_FALSE(queue.tryPush(extra));
+    EXPECT_EQ(queue.size(), 3u);
+
+    for (int i = 0; i < 3; i++)
+    {
+        int value = -1;
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    int value = -1;
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+// Test that move-only values are handed over without copies and a failed push leaves the value with the caller
+TEST(SpscQueueTest, MovesOwnership)
+{
+    SpscQueue<std::unique_ptr<int>> queue(1);
+    auto first = std::make_unique<int>(7);
+    int* address = first.get();
+    ASSERT_TRUE(queue.tryPush(first));
+    EXPECT_EQ(first, nullptr);
+
+    auto second = std::make_unique<int>(8);
+    EXPECT_FALSE(queue.tryPush(second));
+    EXPECT_NE(second, nullptr);
+
+    std::unique_ptr<int> popped;
+    ASSERT_TRUE(queue.tryPop(popped));
+    EXPECT_EQ(popped.get(), address);
+}
+
+// Test that a producer and consumer on separate threads pass every value in order through a small queue
+TEST(SpscQueueTest, ConcurrentTransferPreservesOrder)
+{
+    constexpr int numValues = 100000;
+    SpscQueue<int> queue(8);
+
+    std::thread producer(
+        [&queue]()
+        {
+            for (int i = 0; i < numValues; i++)
+            {
+                int value = i;
+                ASSERT_TRUE(queue.push(value));
+            }
+        });
+
+    int expected = 0;
+    int value = -1;
+    while (expected < numValues && queue.pop(value))
+    {
+        ASSERT_EQ(value, expected);
+        expected++;
+    }
+    producer.join();
+    EXPECT_EQ(expected, numValues);
+}
+
+// Test that closing the queue releases a consumer blocked on an empty queue and a producer blocked on a full one
+TEST(SpscQueueTest, CloseWakesBlockedThreads)
+{
+    SpscQueue<int> empty(1);
+    std::thread consumer(
+        [&empty]()
+        {
+            int value = 0;
+            EXPECT_FALSE(empty.pop(value));
+        });
+
+    SpscQueue<int> full(1);
+    int value = 1;
+    ASSERT_TRUE(full.tryPush(value));
+    std::thread producer(
+        [&full]()
+        {
+            int value = 2;
+            EXPECT_FALSE(full.push(value));
+        });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    empty.close();
+    full.close();
+    consumer.join();
+    producer.join();
+    EXPECT_TRUE(empty.isClosed());
+}
+
+// Test that values queued before close are still delivered, in order, while new pushes are refused
+TEST(SpscQueueTest, CloseDrainsQueuedValues)
+{
+    SpscQueue<int> queue(3);
+    for (int i = 0; i < 2; i++)
+    {
+        int value = i;
+        ASSERT_TRUE(queue.tryPush(value));
+    }
+    queue.close();
+
+    int value = 5;
+    EXPECT_FALSE(queue.tryPush(value));
+    EXPECT_FALSE(queue.push(value));
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 0);
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_FALSE(queue.pop(value));
+    EXPECT_FALSE(queue.tryPop(value));
+}
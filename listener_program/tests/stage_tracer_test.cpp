@@ -0,0 +1,62 @@
+#include "../src/stage_tracer.h"
+
+#include <gtest/gtest.h>
+
+// Test that sub-microsecond durations keep their resolution
+TEST(StageTracerTest, PercentilesAreWithinBucketResolution)
+{
+    StageHistogram histogram;
+    for (int durationNs = 1; durationNs <= 1000; durationNs++)
+    {
+        histogram.record(std::chrono::nanoseconds(durationNs));
+    }
+
+    EXPECT_EQ(histogram.count(), 1000);
+    EXPECT_EQ(histogram.max(), std::chrono::nanoseconds(1000));
+    EXPECT_EQ(histogram.mean(), std::chrono::nanoseconds(500));
+
+    auto p50 = histogram.percentile(0.5).count();
+    EXPECT_GE(p50, 500);
+    EXPECT_LE(p50, 500 * 1.25);
+
+    auto p99 = histogram.percentile(0.99).count();
+    EXPECT_GE(p99, 990);
+    EXPECT_LE(p99, 1000);  // capped at the exact maximum
+}
+
+// Test that every duration, from zero to the largest, lands in a bucket that bounds it
+TEST(StageTracerTest, ExtremeDurationsAreBounded)
+{
+    StageHistogram histogram;
+    histogram.record(std::chrono::nanoseconds(-5));
+    EXPECT_EQ(histogram.percentile(1.0), std::chrono::nanoseconds(0));
+
+    histogram.record(std::chrono::nanoseconds::max());
+    EXPECT_EQ(histogram.percentile(1.0), std::chrono::nanoseconds::max());
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.mean(), std::chrono::nanoseconds(0));
+}
+
+// Test that a scoped timer records one sample of its stage, and that the summary lists only stages with samples
+TEST(StageTracerTest, ScopedTimerRecordsItsStage)
+{
+    StageTracer& tracer = StageTracer::instance();
+    tracer.reset();
+    {
+        ScopedStageTimer timer(TraceStage::GccPhat);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    EXPECT_EQ(tracer.histogram(TraceStage::GccPhat).count(), 1);
+    EXPECT_GE(tracer.histogram(TraceStage::GccPhat).max(), std::chrono::milliseconds(2));
+    EXPECT_EQ(tracer.histogram(TraceStage::Doa).count(), 0);
+
+    const std::string summary = tracer.summary();
+    EXPECT_NE(summary.find("GCC-PHAT n: 1"), std::string::npos);
+    EXPECT_EQ(summary.find("DOA"), std::string::npos);
+
+    tracer.reset();
+    EXPECT_EQ(tracer.histogram(TraceStage::GccPhat).count(), 0);
+}
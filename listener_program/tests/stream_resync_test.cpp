@@ -0,0 +1,114 @@
+#include "../src/stream_resync.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr int microIncrement = 1240;
+constexpr int windowSize = 4;
+
+// Timestamps for the given packet sequence numbers on a 1240 us grid
+std::vector<TimePoint> packetTimes(std::initializer_list<int> sequenceNumbers)
+{
+    std::vector<TimePoint> times;
+    for (int sequence : sequenceNumbers)
+    {
+        times.push_back(TimePoint(std::chrono::seconds(1000)) + std::chrono::microseconds(sequence * microIncrement));
+    }
+    return times;
+}
+}  // namespace
+
+// Test that a contiguous stream fills the window one packet per position
+TEST(StreamResyncTest, ContiguousPacketsFillWindow)
+{
+    StreamResync resync(microIncrement, windowSize, windowSize);
+    auto times = packetTimes({0, 1, 2, 3});
+
+    const WindowPlan& plan = resync.planWindow(times);
+
+    ASSERT_TRUE(plan.complete);
+    EXPECT_EQ(plan.packetsConsumed, 4);
+    EXPECT_EQ(plan.packetsMissing, 0);
+    EXPECT_EQ(plan.packetForPosition, (std::vector<int>{0, 1, 2, 3}));
+
+    // The next window continues from where this one ended
+    auto nextTimes = packetTimes({4, 5, 6, 7});
+    EXPECT_TRUE(resync.planWindow(nextTimes).complete);
+    EXPECT_EQ(resync.planWindow(packetTimes({8, 9, 10, 11})).packetsMissing, 0);
+}
+
+// Test that lost packets are zero-filled and later packets stay queued for the next window
+TEST(StreamResyncTest, GapIsMarkedMissing)
+{
+    StreamResync resync(microIncrement, windowSize, windowSize);
+    auto times = packetTimes({0, 2, 3, 4});
+
+    const WindowPlan& plan = resync.planWindow(times);
+
+    ASSERT_TRUE(plan.complete);
+    EXPECT_EQ(plan.packetForPosition, (std::vector<int>{0, -1, 1, 2}));
+    EXPECT_EQ(plan.positionTimes[1], packetTimes({1})[0]);
+    EXPECT_EQ(plan.packetsMissing, 1);
+    EXPECT_EQ(plan.packetsConsumed, 3);  // packet 4 belongs to the next window
+}
+
+// Test that a duplicate packet is discarded without losing lock
+TEST(StreamResyncTest, DuplicatePacketIsDiscarded)
+{
+    StreamResync resync(microIncrement, windowSize, windowSize);
+    auto times = packetTimes({0, 1, 1, 2, 3});
+
+    const WindowPlan& plan = resync.planWindow(times);
+
+    ASSERT_TRUE(plan.complete);
+    EXPECT_EQ(plan.packetForPosition, (std::vector<int>{0, 1, 3, 4}));
+    EXPECT_EQ(plan.packetsDiscarded, 1);
+    EXPECT_EQ(plan.packetsConsumed, 5);
+}
+
+// Test that a window left short by discards consumes nothing so it can be retried with more packets
+TEST(StreamResyncTest, ShortWindowIsRetried)
+{
+    StreamResync resync(microIncrement, windowSize, windowSize);
+    auto shortTimes = packetTimes({0, 1, 1, 2});
+
+    const WindowPlan& shortPlan = resync.planWindow(shortTimes);
+    EXPECT_FALSE(shortPlan.complete);
+    EXPECT_FALSE(shortPlan.resynced);
+    EXPECT_EQ(shortPlan.packetsConsumed, 0);
+
+    auto retryTimes = packetTimes({0, 1, 1, 2, 3});
+    const WindowPlan& retryPlan = resync.planWindow(retryTimes);
+    ASSERT_TRUE(retryPlan.complete);
+    EXPECT_EQ(retryPlan.packetForPosition, (std::vector<int>{0, 1, 3, 4}));
+}
+
+// Test that a jump beyond the bridgeable gap re-anchors the stream on the offending packet
+TEST(StreamResyncTest, LargeJumpResynchronises)
+{
+    StreamResync resync(microIncrement, windowSize, windowSize);
+    auto times = packetTimes({0, 1, 100, 101});
+
+    const WindowPlan& plan = resync.planWindow(times);
+    ASSERT_TRUE(plan.resynced);
+    EXPECT_EQ(plan.packetsConsumed, 2);
+    EXPECT_EQ(plan.packetsDiscarded, 2);
+
+    auto afterResync = packetTimes({100, 101, 102, 103});
+    const WindowPlan& nextPlan = resync.planWindow(afterResync);
+    ASSERT_TRUE(nextPlan.complete);
+    EXPECT_EQ(nextPlan.packetsMissing, 0);
+}
+
+// Test that a timestamp off the packet grid is treated as a discontinuity
+TEST(StreamResyncTest, MisalignedTimestampResynchronises)
+{
+    StreamResync resync(microIncrement, windowSize, windowSize);
+    auto times = packetTimes({0, 1, 2, 3});
+    times[2] += std::chrono::microseconds(7);
+
+    const WindowPlan& plan = resync.planWindow(times);
+    EXPECT_TRUE(plan.resynced);
+    EXPECT_EQ(plan.packetsConsumed, 2);
+}
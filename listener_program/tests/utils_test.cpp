@@ -78,6 +78,64 @@ TEST(UtilsTest, ParseJsonConfigMissingField)
 // Test: JSON Parsing with Invalid File
 TEST(UtilsTest, ParseJsonConfigInvalidFile) { EXPECT_THROW(parseJsonConfig("non_existent.json"), std::runtime_error); }
 
+// Test: Stream list merged over the shared top-level keys
+TEST(UtilsTest, ParseStreamConfigsMergesSharedKeys)
+{
+    std::string tempJsonFile = "temp_config_streams.json";
+    std::ofstream file(tempJsonFile);
+    file << R"({
+        "enableIntegrationTesting": false,
+        "speedOfSound_mps": 1500.0,
+        "logDirectory": "/logs/",
+        "timeDomainDetector": "PeakAmplitude",
+        "timeDomainThreshold": 1,
+        "frequencyDomainStrategy": "Filter",
+        "frequencyDomainDetector": "AverageEnergy",
+        "frequencyDomainThreshold": 100,
+        "filterWeightsFile": "/filters.dat",
+        "enableTracking": false,
+        "clusteringIntervalSeconds": 30,
+        "clusteringWindowSeconds": 60,
+        "onnxModelPath": "",
+        "onnxNormalizationParams": "",
+        "streams": [
+            {"networkIPAddress": "self", "networkPort": 1045, "firmware": "1240",
+             "receiverPositionsFile": "/array_a.txt", "listenerCore": 1, "processingCore": 2},
+            {"networkIPAddress": "self", "networkPort": 1046, "firmware": "1240_imu",
+             "receiverPositionsFile": "/array_b.txt", "speedOfSound_mps": 1480.0}
+        ]
+    })";
+    file.close();
+
+    auto streamConfigs = parseStreamConfigs(tempJsonFile);
+    ASSERT_EQ(streamConfigs.size(), 2);
+
+    auto& [firstSocketVars, firstPipelineVars] = streamConfigs[0];
+    EXPECT_EQ(firstSocketVars.port, 1045);
+    EXPECT_EQ(firstSocketVars.listenerCore, 1);
+    EXPECT_EQ(firstPipelineVars.processingCore, 2);
+    EXPECT_EQ(firstPipelineVars.firmware, "1240");
+    EXPECT_EQ(firstPipelineVars.receiverPositionsPath, "/array_a.txt");
+    EXPECT_FLOAT_EQ(firstPipelineVars.speedOfSound, 1500.0f);
+    EXPECT_EQ(firstPipelineVars.filterWeightsPath, "/filters.dat");
+    EXPECT_EQ(firstPipelineVars.loggingDirectory, "/logs/port1045_");
+
+    auto& [secondSocketVars, secondPipelineVars] = streamConfigs[1];
+    EXPECT_EQ(secondSocketVars.port, 1046);
+    EXPECT_EQ(secondSocketVars.listenerCore, -1);
+    EXPECT_EQ(secondPipelineVars.firmware, "1240_imu");
+    EXPECT_FLOAT_EQ(secondPipelineVars.speedOfSound, 1480.0f);
+    EXPECT_EQ(secondPipelineVars.loggingDirectory, "/logs/port1046_");
+
+    std::remove(tempJsonFile.c_str());
+}
+
+// Test: Stream parsing with Invalid File
+TEST(UtilsTest, ParseStreamConfigsInvalidFile)
+{
+    EXPECT_THROW(parseStreamConfigs("non_existent.json"), std::runtime_error);
+}
+
 // Test: Print Mode Output
 TEST(UtilsTest, PrintModeTest)
 {